@@ -26,6 +26,7 @@
 
 #define VERSION 1
 
+#include <AltimeterCore.h>
 #include "src/FlightController.hpp"
 #include "src/Sensor/I2CUtil.h"
 
@@ -42,89 +42,162 @@
 // Set this to 0 to disable the display while in flight
 #define RUN_DISPLAY_WHILE_FLYING 0
 
+// The display shares the i2c bus with the sensors.  A full frame is ~1.2kB
+// which is ~110ms of bus time at the default 100kHz clock.  These are the
+// share of the bus (in %) it may use on the ground and (if
+// RUN_DISPLAY_WHILE_FLYING is set) in flight, and that is what limits the
+// frame rate: 40% is ~3.6fps and 10% is ~0.9fps at 100kHz.  Each view asks
+// for a maximum rate of its own and gets the lower of the two.
+#define I2C_BUS_SPEED 100000
+const int UI_I2C_BUDGET_GROUND = 40;
+const int UI_I2C_BUDGET_FLYING = 10;
+
+// Flight data samples are quantised to these resolutions before they are
+// delta encoded into the flight files.  Time is always stored in ms.
+#define LOG_ALTITUDE_RESOLUTION 0.01  // m
+#define LOG_ACCEL_RESOLUTION 0.01     // m/s/s
+
 // Recording will start at FLIGHT_START_THRESHOLD_ALT m and we'll assume we're
 // on the ground at FLIGHT_END_THRESHOLD_ALT m. In theory, these could be lower,
 // but we want to account for landing in a tree, on a hill, etc.  30m should be
 // sufficient for most launch sites.
-const double FLIGHT_START_THRESHOLD_ALT      = 10;
-const double FLIGHT_END_THRESHOLD_ALT        = 30;
-const double FLIGHT_START_THRESHOLD_ACC      = 20.0;  // in mss
-const double FLIGHT_START_THRESHOLD_VELOCITY = 0.5;  // m/s
-const double FLIGHT_END_THRESHOLD_VELOCITY   = 0.0;  // m/s
-const float FAILSAFE_ALTITUDE                = -10; 
+const real_t FLIGHT_START_THRESHOLD_ALT      = 10;
+const real_t FLIGHT_END_THRESHOLD_ALT        = 30;
+const real_t FLIGHT_START_THRESHOLD_ACC      = 20.0;  // in mss
+const real_t FLIGHT_START_THRESHOLD_VELOCITY = 0.5;   // m/s
+const real_t FLIGHT_END_THRESHOLD_VELOCITY   = 0.0;   // m/s
+const real_t FAILSAFE_ALTITUDE               = -10;
+
+// Launch is voted on over the last LAUNCH_WINDOW samples.  It takes
+// LAUNCH_ACC_VOTES samples over FLIGHT_START_THRESHOLD_ACC or
+// LAUNCH_VELOCITY_VOTES samples over LAUNCH_VELOCITY_THRESHOLD to launch, so
+// knocks and drops on the pad (impacts are < 50ms) won't start a flight.
+// FLIGHT_START_THRESHOLD_ALT is the fallback if both of those sensors are
+// unhappy.  The recording is back-filled from LAUNCH_PRE_ROLL_MS before the
+// first sample over LAUNCH_MOTION_ACC, so the votes cost no flight data.
+const int LAUNCH_WINDOW                = 12;
+const int LAUNCH_ACC_VOTES             = 10;
+const int LAUNCH_VELOCITY_VOTES        = 10;
+const real_t LAUNCH_VELOCITY_THRESHOLD = 8.0;   // m/s
+const real_t LAUNCH_MOTION_ACC         = 13.0;  // in mss
+const int LAUNCH_PRE_ROLL_MS           = 100;
 
 // When the altitude is DESCENT_THRESHOLD meters less than the apogee, we'll
 // assume we're descending.  Hopefully, your rocket has a generally upwards
 // trajectory....
-const double DESCENT_THRESHOLD = 15;
+const real_t DESCENT_THRESHOLD = 15;
+
+// The barometer is locked out near Mach 1, where shock waves over the static
+// ports make the pressure jump, and whenever a sample is more than
+// BARO_LOCKOUT_GATE m from the IMU's estimate.  Altitude is dead-reckoned from
+// the IMU until we're back below BARO_RELEASE_VELOCITY and the barometer has
+// been self-consistent, with its rate within BARO_RELEASE_RATE_GATE of the
+// IMU's, for BARO_RELEASE_SAMPLES samples.  See src/Sensor/BaroLockout.hpp.
+const real_t BARO_LOCKOUT_VELOCITY  = 200;  // m/s, ~Mach 0.6
+const real_t BARO_RELEASE_VELOCITY  = 150;  // m/s
+const real_t BARO_LOCKOUT_GATE      = 15;   // m
+const real_t BARO_RELEASE_RATE_GATE = 10;   // m/s
+const int BARO_LOCKOUT_MIN_MS       = 500;
+const int BARO_LOCKOUT_MAX_MS       = 10000;
+const int BARO_RELEASE_SAMPLES      = 5;
 
 // Maximum on time for pyro type deployment
 const int MAX_FIRE_TIME = 5000;
 
+// The drogue fires DROGUE_DELAY_MS after apogee is detected and the main as
+// soon as we're below the deployment altitude.  A backup channel (0 for none)
+// fires BACKUP_DELAY_MS after the charge it backs up.  These are timed from
+// a hardware timer, as is switching each pyro off after MAX_FIRE_TIME.  See
+// src/DeploymentScheduler.hpp.
+const int DROGUE_DELAY_MS       = 0;
+const int BACKUP_DELAY_MS       = 1000;
+const int DROGUE_BACKUP_CHANNEL = 0;
+const int MAIN_BACKUP_CHANNEL   = 0;
+
+// The main is fired early enough to be out at the deployment altitude rather
+// than starting to come out there.  The lead is the barometer lag plus the
+// time from firing to the chute being out for that type of device, at the
+// current descent rate, and never more than DEPLOYMENT_MAX_LEAD.  See
+// src/DeploymentPlanner.hpp.
+const int PYRO_ACTUATION_MS              = 150;
+const int SERVO_ACTUATION_MS             = 400;
+const real_t DEPLOYMENT_MIN_DESCENT_RATE = 3;   // m/s
+const real_t DEPLOYMENT_MAX_LEAD         = 30;  // m
+
 // ESP8266 specific
 #define SD2 9
 #define SD3 10
 
+// Set to 1 to use channels 1 and 2 for thrust vectoring on CONFIG1
 #define ENABLE_GIMBALLING 1
 
+// The gimbal servos are written once per PWM frame, GIMBAL_WRITE_LEAD_US
+// before it starts, and move at most GIMBAL_SLEW_RATE.  Moves under
+// GIMBAL_DEADBAND are dropped.  See src/ServoActuator.hpp.
+const int SERVO_FRAME_US       = 20000;
+const int GIMBAL_WRITE_LEAD_US = 4000;
+const float GIMBAL_SLEW_RATE   = 300;  // deg/s
+const float GIMBAL_DEADBAND    = 1;    // deg
+
 // D1 & D2 are used for i2c
 const int SERIAL_BAUD_RATE = 57600;
 
+// Serial log messages below this level are compiled out.  kLogLevelDebug
+// adds the sensor trace during flights.  See src/SerialLog.hpp.
+#define LOG_LEVEL kLogLevelInfo
+
+// The pieces of each board.  Outputs are OutputPins, or NoOutput where the
+// board doesn't have one, and each recovery channel is a RecoveryChannel
+// over the output it drives (see RecoveryDevice.h in AltimeterCore).
+// Anything that isn't fitted compiles to nothing.
+template <typename Output>
+class RecoveryChannel;
+template <uint8_t Pin>
+class ServoOutput;
+
 #define CONFIG2
 //#define CONFIG1  
 
 #ifdef CONFIG1
-const byte STATUS_PIN      = NO_PIN;  // Unit status pin.  On if OK
-const byte MESSAGE_PIN     = D6;      // Blinks out the altitude
-const byte READY_PIN       = D5;      // Indicates the unit is ready for flight
-const byte BUZZER_PIN      = D0;      // Audible buzzer on landing
 const byte RESET_PIN       = SD2;     // SD2 - pin "9"
 const byte INPUT_PIN       = SD3;     // SD3 - pin "10"
-
-#if !ENABLE_GIMBALLING
-const byte DEPL_CTL_1           = D3;  // control pin 1
-const byte DEPL_CTL_2           = D4;  // control pin 2
-const byte PITCH_CONTROL_PIN     = NO_PIN;
-const byte YAW_CONTROL_PIN       = NO_PIN;
-#else
-const byte DEPL_CTL_1           = NO_PIN;  // control pin 1
-const byte DEPL_CTL_2           = NO_PIN;  // control pin 2
-const byte PITCH_CONTROL_PIN     = D3;
-const byte YAW_CONTROL_PIN       = D4;
-#endif
-
-const byte DEPL_CTL_3           = D7;  // control pin 1
-const byte DEPL_CTL_4           = D8;  // control pin 2
-const RecoveryDeviceType CTL_1_TYPE = kServo;  //PWM control
-const RecoveryDeviceType CTL_2_TYPE = kServo;  //PWM control 
-const RecoveryDeviceType CTL_3_TYPE = kPyro;   //On/off
-const RecoveryDeviceType CTL_4_TYPE = kPyro;   //On/off
 const int BARO_I2C_ADDR     = 0x76;  // 0x77 or 0x76
 const int DISPLAY_I2C_ADDR  = 0x3C;
 const int IMU_I2C_ADDR      = 0x68;
 const PeizoStyle PEIZO_TYPE = kActive;
 #define USE_BMP085 1
 #define USE_MPU9250 1
+
+struct BoardConfig {
+  typedef NoOutput StatusPin;        // Unit status pin.  On if OK
+  typedef OutputPin<D6> MessagePin;  // Blinks out the altitude
+  typedef OutputPin<D5> ReadyPin;    // Indicates the unit is ready for flight
+  typedef OutputPin<D0> BuzzerPin;   // Audible buzzer on landing
+
+#if ENABLE_GIMBALLING
+  // Channels 1 and 2 steer the motor
+  static constexpr bool kGimballing  = true;
+  static const byte kPitchControlPin = D3;
+  static const byte kYawControlPin   = D4;
+  typedef RecoveryChannel<NoOutput> Channel1;
+  typedef RecoveryChannel<NoOutput> Channel2;
+#else
+  static constexpr bool kGimballing  = false;
+  static const byte kPitchControlPin = NO_PIN;
+  static const byte kYawControlPin   = NO_PIN;
+  typedef RecoveryChannel<ServoOutput<D3>> Channel1;
+  typedef RecoveryChannel<ServoOutput<D4>> Channel2;
+#endif
+  typedef RecoveryChannel<OutputPin<D7>> Channel3;  // Pyro
+  typedef RecoveryChannel<OutputPin<D8>> Channel4;  // Pyro
+};
 #endif
 
 
 
 #ifdef CONFIG2
-const byte STATUS_PIN      = NO_PIN;  // Unit status pin.  On if OK
-const byte MESSAGE_PIN     = NO_PIN;      // Blinks out the altitude
-const byte READY_PIN       = NO_PIN;      // Indicates the unit is ready for flight
-const byte BUZZER_PIN      = D0;      // Audible buzzer on landing
 const byte RESET_PIN       = NO_PIN;     // SD2 - pin "9"
 const byte INPUT_PIN       = NO_PIN;     // SD3 - pin "10"
-
-const byte DEPL_CTL_1           = NO_PIN;  // control pin 1
-const byte DEPL_CTL_2           = NO_PIN;  // control pin 2
-const byte DEPL_CTL_3           = NO_PIN;  // control pin 1
-const byte DEPL_CTL_4           = NO_PIN;  // control pin 2
-const RecoveryDeviceType CTL_1_TYPE = kNoEjection;  //PWM control
-const RecoveryDeviceType CTL_2_TYPE = kNoEjection;  //PWM control 
-const RecoveryDeviceType CTL_3_TYPE = kNoEjection;   //On/off
-const RecoveryDeviceType CTL_4_TYPE = kNoEjection;   //On/off
 const int BARO_I2C_ADDR     = 0x76;  // 0x77 or 0x76
 const int DISPLAY_I2C_ADDR  = 0x3C;
 const int IMU_I2C_ADDR      = 0x68;
@@ -132,14 +205,31 @@ const int MPU6050_ADDRESS   = 0x68;
 const PeizoStyle PEIZO_TYPE = kActive;
 #define USE_BMP280 1
 #define USE_MPU6050 1
-const byte PITCH_CONTROL_PIN     = NO_PIN;
-const byte YAW_CONTROL_PIN       = NO_PIN;
+
+struct BoardConfig {
+  typedef NoOutput StatusPin;
+  typedef NoOutput MessagePin;
+  typedef NoOutput ReadyPin;
+  typedef OutputPin<D0> BuzzerPin;  // Audible buzzer on landing
+
+  static constexpr bool kGimballing  = false;
+  static const byte kPitchControlPin = NO_PIN;
+  static const byte kYawControlPin   = NO_PIN;
+  typedef RecoveryChannel<NoOutput> Channel1;
+  typedef RecoveryChannel<NoOutput> Channel2;
+  typedef RecoveryChannel<NoOutput> Channel3;
+  typedef RecoveryChannel<NoOutput> Channel4;
+};
 #endif
 
 
 // The barometer can only refresh at about 50Hz.
 const int SENSOR_READ_DELAY_MS = 10;
 
+// The most time the web server gets per pass of the main loop.  It stops
+// sooner if a sensor read comes due.
+const int WEB_SLICE_US = 2000;
+
 // Delay between digit blinks.  Any faster is too quick to keep up with
 const int BLINK_SPEED_MS = 250;
 
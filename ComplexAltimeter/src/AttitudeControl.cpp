@@ -26,6 +26,9 @@
 
 #include "AttitudeControl.hpp"
 
+constexpr BiquadCoefficients AttitudeControl::kGimbalFilter;
+constexpr ServoActuatorConfig AttitudeControl::kGimbalServoConfig;
+
 void AttitudeControl::calibrate()
 {
   // gravityVec = imu.getAcceleration();
@@ -44,8 +47,14 @@ void AttitudeControl::start() { running = true; }
 void AttitudeControl::stop()
 {
   running = false;
-  yawServo->write(kGimbalCenterAngle);
-  pitchServo->write(kGimbalCenterAngle);
+  yawServo.set(yawServoCenterAngle);
+  pitchServo.set(pitchServoCenterAngle);
+}
+
+void AttitudeControl::service()
+{
+  pitchServo.service();
+  yawServo.service();
 }
 
 double gimbalClamp(double val)
@@ -67,15 +76,15 @@ void AttitudeControl::update()
   // component for the respective axis plus some second order feedback from the
   // gyro
 
-  float yaw      = yawFilter.step(accVec.YAxis);
-  float pitch    = pitchFilter.step(accVec.XAxis);
-  int pitchAngle = kGimbalCenterAngle +
-                   gimbalClamp(pitch * kACGain + gyroVec.YAxis * kGyroGain);
-  int yawAngle = kGimbalCenterAngle +
-                 gimbalClamp(yaw * kACGain + gyroVec.XAxis * kGyroGain);
+  float yaw        = yawFilter.step(accVec.YAxis);
+  float pitch      = pitchFilter.step(accVec.XAxis);
+  float pitchAngle = pitchServoCenterAngle +
+                     gimbalClamp(pitch * kACGain + gyroVec.YAxis * kGyroGain);
+  float yawAngle = yawServoCenterAngle +
+                   gimbalClamp(yaw * kACGain + gyroVec.XAxis * kGyroGain);
 
   if (running) {
-    yawServo->write(yawAngle);
-    pitchServo->write(pitchAngle);
+    yawServo.command(yawAngle);
+    pitchServo.command(pitchAngle);
   }
 }
\ No newline at end of file
@@ -27,8 +27,8 @@
 #ifndef ATT_CTL_H
 #define ATT_CTL_H
 
-#include <Servo.h>
-#include "Sensor/Filters.hpp"
+#include <AltimeterCore.h>
+#include "ServoActuator.hpp"
 #include "Sensor/Imu.hpp"
 
 #define kMaxGimbalOffset 20
@@ -37,35 +37,36 @@
 // This should be configurable
 #define kGimbalCenterAngle 90
 
+// Corner frequency of the low pass on the accelerometer axes in Hz.  Well
+// below the motor's vibration and well above anything the servos can follow.
+#define kGimbalFilterCutoff 5
+
+// The control law runs in update() on every sensor tick and only commands
+// the servos.  service() does the writing, once per servo frame, and wants
+// calling on every pass of the main loop.
 class AttitudeControl
 {
  public:
-  AttitudeControl(Imu imu) : imu(imu), pitchFilter(0), yawFilter(0)
-  {
-    pitchServo = new Servo();
-    yawServo   = new Servo();
-    pitchServo->attach(PITCH_CONTROL_PIN);
-    yawServo->attach(YAW_CONTROL_PIN);
-    pitchServo->write(pitchServoCenterAngle);
-    yawServo->write(yawServoCenterAngle);
-
-    // Use slightly higher gain than the default for faster response here.
-    pitchFilter.configure(1, 1, 0.05);
-    yawFilter.configure(1, 1, 0.05);
-    pitchFilter.reset(0);
-    yawFilter.reset(0);
-  };
-
-  ~AttitudeControl()
+  AttitudeControl(Imu &imu)
+      : imu(imu),
+        pitchFilter(kGimbalFilter),
+        yawFilter(kGimbalFilter),
+        pitchServo(kGimbalServoConfig),
+        yawServo(kGimbalServoConfig)
   {
-    delete pitchServo;
-    delete yawServo;
+    pitchServo.attach(BoardConfig::kPitchControlPin, pitchServoCenterAngle);
+    yawServo.attach(BoardConfig::kYawControlPin, yawServoCenterAngle);
   };
 
   void calibrate();
   void start();
   void stop();
   void update();
+  void service();
+
+  // Gimbal offsets from center last written to the servos in degrees
+  int getPitchOffset() { return pitchServo.getAngle() - pitchServoCenterAngle; }
+  int getYawOffset() { return yawServo.getAngle() - yawServoCenterAngle; }
 
  private:
   bool running = false;
@@ -74,11 +75,15 @@ class AttitudeControl
   Vector gravityVec;
   Vector accVec;
 
-  KalmanFilter pitchFilter;
-  KalmanFilter yawFilter;
+  static constexpr BiquadCoefficients kGimbalFilter =
+      lowPassBiquad(kGimbalFilterCutoff, 1000 / SENSOR_READ_DELAY_MS);
+  Biquad<float> pitchFilter;
+  Biquad<float> yawFilter;
 
-  Servo *pitchServo;
-  Servo *yawServo;
+  static constexpr ServoActuatorConfig kGimbalServoConfig = {
+      SERVO_FRAME_US, GIMBAL_WRITE_LEAD_US, GIMBAL_SLEW_RATE, GIMBAL_DEADBAND};
+  ServoActuator pitchServo;
+  ServoActuator yawServo;
 
   int pitchServoCenterAngle = kGimbalCenterAngle;
   int yawServoCenterAngle   = kGimbalCenterAngle;
@@ -26,12 +26,32 @@
 
 #include <Arduino.h>
 
+#include "../Configuration.h"
 #include "DataLogger.hpp"
 #include "FlightData.hpp"
+#include "SerialLog.hpp"
 #include "types.h"
 
-DataLogger::DataLogger()
+// Channels and the rates they're logged at.  Altitude and the acceleration
+// vector must be logged on every sample for the flight graph.
+const LogChannelDef kLogSchema[kLogChannelCount] = {
+    {0.001, 1, 1, "t"},
+    {LOG_ALTITUDE_RESOLUTION, 1, 1, "a"},
+    {0.01, 1, 5, "v"},
+    {LOG_ACCEL_RESOLUTION, 3, 1, "acc"},
+    {0.01, 3, 2, "gyro"},
+    {0.0001, 4, 5, "quat"},
+    {0.1, 2, 2, "gimbal"},
+    {1, 1, 0, "state"},
+    {1, 4, kLogOnEvent, "event"},
+};
+
+DataLogger::DataLogger() : encoder(channelComponents, kLogChannelCount)
 {
+  for (int i = 0; i < kLogChannelCount; i++) {
+    channelComponents[i] = kLogSchema[i].components;
+  }
+
   log(F(":: Data Logger Initialized ::"));
 
   FSInfo fs_info;
@@ -86,19 +106,11 @@ DataLogger &DataLogger::sharedLogger()
 void DataLogger::logDataPoint(FlightDataPoint &p, bool isTriggerPoint)
 {
   if (isTriggerPoint) {
-    triggerIndex = dataIndex;
-    int idx      = dataIndex;
-    int logCount = MIN(dataPointsLogged, dataBufferLen);
-    for (int i = 0; i < logCount; i++) {
-      if (i) {
-        dataFile.print(",");
-      }
-      dataFile.println(dataBuffer[idx].toJson());
-      idx = (idx == dataBufferLen) ? 0 : idx + 1;
-    }
+    // Everything we have buffered
+    int oldest = dataPointsLogged > dataBufferLen ? dataIndex : 0;
+    triggerRecording(dataPointsLogged ? dataBuffer[oldest].ltime : p.ltime);
   } else if (triggerIndex != -1) {
-    dataFile.print(",");
-    dataFile.println(p.toJson());
+    writeDataPoint(p);
   } else {
     dataBuffer[dataIndex] = p;
     dataIndex = (dataIndex == dataBufferLen - 1) ? 0 : dataIndex + 1;
@@ -106,34 +118,192 @@ void DataLogger::logDataPoint(FlightDataPoint &p, bool isTriggerPoint)
   }
 }
 
-void DataLogger::readFlightDetails(int index, PrintCallback callback)
+void DataLogger::triggerRecording(long fromTime)
 {
-  String path = String(FLIGHTS_DIR) + String("/") + String(index);
-  File f      = SPIFFS.open(path, "r");
-  if (f) {
-    while (f.available()) {
-      String line = f.readStringUntil('\n');
-      callback(line);
+  if (triggerIndex != -1) {
+    return;
+  }
+  triggerIndex = dataIndex;
+  // Oldest first.  The ring only starts at dataIndex once it has wrapped.
+  int idx      = dataPointsLogged > dataBufferLen ? dataIndex : 0;
+  int logCount = MIN(dataPointsLogged, dataBufferLen);
+  for (int i = 0; i < logCount; i++) {
+    if ((long)(dataBuffer[idx].ltime - fromTime) >= 0) {
+      writeDataPoint(dataBuffer[idx]);
     }
-    f.close();
+    idx = (idx == dataBufferLen - 1) ? 0 : idx + 1;
+  }
+}
+
+void DataLogger::writeDataPoint(FlightDataPoint &p)
+{
+  int32_t values[kCodecMaxValues];
+  encoder.beginTick(p.ltime);
+  for (uint8_t c = kLogTime + 1; c < kLogChannelCount; c++) {
+    uint8_t decimation = kLogSchema[c].decimation;
+    if (decimation == kLogOnEvent) {
+      continue;
+    }
+    if (decimation == 0 || sampleNumber % decimation == 0) {
+      p.channelValues((LogChannel)c, values);
+      encoder.add(c, values, decimation == 0);
+    }
+  }
+  writePendingEvents();
+  encoder.endTick();
+  sampleNumber++;
+}
+
+void DataLogger::logEvent(const FlightEvent &e)
+{
+  if (!dataFile) {
+    return;
+  }
+  if (pendingEventCount == kLogMaxPendingEvents) {
+    log(F("Event dropped"));
+    return;
+  }
+  pendingEvents[pendingEventCount++] = e;
+}
+
+// Adds the pending events to the current tick.  Any that don't fit wait for
+// the next one.
+void DataLogger::writePendingEvents()
+{
+  uint8_t written = 0;
+  while (written < pendingEventCount) {
+    const FlightEvent &e = pendingEvents[written];
+    int32_t values[4]    = {(int32_t)e.micros, e.type, e.arg, e.value};
+    if (!encoder.add(kLogEvent, values)) {
+      break;
+    }
+    written++;
+  }
+  pendingEventCount -= written;
+  memmove(pendingEvents, pendingEvents + written,
+          pendingEventCount * sizeof(FlightEvent));
+}
+
+String DataLogger::flightPath(int index)
+{
+  return String(FLIGHTS_DIR) + String("/") + String(index);
+}
+
+// Reads the header and the schema into |schema|
+bool DataLogger::openFlightFile(const String &path, File &f,
+                                FlightFileSchema *schema)
+{
+  f = SPIFFS.open(path, "r");
+  if (!f) {
+    return false;
+  }
+  FlightFileHeader h;
+  if (f.read((uint8_t *)&h, sizeof(h)) != sizeof(h) ||
+      memcmp(h.magic, kFlightFileMagic, sizeof(h.magic)) ||
+      h.blockSize != kCodecBlockSize || h.channelCount > kCodecMaxTags) {
+    return false;
+  }
+  for (uint8_t i = 0; i < h.channelCount; i++) {
+    LogChannelDef &def = schema->channels[i];
+    if (f.read((uint8_t *)&def, sizeof(def)) != sizeof(def)) {
+      return false;
+    }
+    def.name[sizeof(def.name) - 1] = 0;
+  }
+  schema->headerSize   = h.headerSize;
+  schema->channelCount = h.channelCount;
+  return true;
+}
+
+int DataLogger::readBlocks(File &f, const FlightFileSchema &schema,
+                           int firstBlock, int count, FrameCallback callback)
+{
+  uint8_t components[kCodecMaxTags];
+  for (uint8_t i = 0; i < schema.channelCount; i++) {
+    components[i] = schema.channels[i].components;
+  }
+
+  uint8_t block[kCodecBlockSize];
+  int ticks = 0;
+  f.seek(schema.headerSize + firstBlock * kCodecBlockSize);
+  for (int i = 0; i < count; i++) {
+    size_t pos = f.position();
+    int n      = -1;
+    if (f.read(block, kCodecBlockSize) == kCodecBlockSize) {
+      n = SampleBlockDecoder::decodeBlock(block, components,
+                                          schema.channelCount, callback);
+    }
+    if (n < 0) {
+      // We've hit the summary at the end of the file
+      f.seek(pos);
+      break;
+    }
+    ticks += n;
+  }
+  return ticks;
+}
+
+int DataLogger::readFlightBlocks(int index, int firstBlock, int count,
+                                 FrameCallback callback)
+{
+  File f;
+  FlightFileSchema schema;
+  int ticks = 0;
+  if (openFlightFile(flightPath(index), f, &schema)) {
+    ticks = readBlocks(f, schema, firstBlock, count, callback);
+  }
+  f.close();
+  return ticks;
+}
+
+void DataLogger::readFlightDetails(int index, PrintCallback callback)
+{
+  readFlightFile(flightPath(index), callback);
+}
+
+void DataLogger::readFlightFile(const String &path, PrintCallback callback)
+{
+  FlightJsonReader reader;
+  String chunk;
+  reader.open(path);
+  while (reader.next(chunk)) {
+    callback(chunk);
   }
 }
 
 void DataLogger::openFlightDataFileWithIndex(int index)
 {
   DataLogger::log(F("Opening flight data file.."));
-  String path = String(FLIGHTS_DIR) + String("/") + String(index);
-  dataFile    = SPIFFS.open(path, "w");
-  dataFile.print("var flightData = { \"data\":[");
+  dataFile = SPIFFS.open(flightPath(index), "w");
+
+  FlightFileHeader h;
+  memcpy(h.magic, kFlightFileMagic, sizeof(h.magic));
+  h.headerSize   = sizeof(h) + sizeof(kLogSchema);
+  h.blockSize    = kCodecBlockSize;
+  h.channelCount = kLogChannelCount;
+  memset(h.reserved, 0, sizeof(h.reserved));
+  dataFile.write((const uint8_t *)&h, sizeof(h));
+  dataFile.write((const uint8_t *)kLogSchema, sizeof(kLogSchema));
+
+  sampleNumber      = 0;
+  pendingEventCount = 0;
+  encoder.begin(&dataFile);
 }
 
 void DataLogger::closeFlightDataFile(FlightData &d)
 {
   DataLogger::log(F("Closing flight data file.."));
-  dataFile.println("],\n");
+  // Events from after the last data point get a tick of their own
+  while (pendingEventCount) {
+    encoder.beginTick(millis());
+    writePendingEvents();
+    encoder.endTick();
+  }
+  encoder.finish();
   dataFile.println(d.toString(0));
-  dataFile.println("}\n");
   dataFile.close();
+  log("Logged " + String(encoder.getTickCount()) + " samples in " +
+      String(encoder.getBlockCount() * kCodecBlockSize) + " bytes");
   clearBuffer();
 }
 
@@ -151,7 +321,12 @@ FlightDataPoint *DataLogger::getDataBuffer() { return dataBuffer; }
 
 int DataLogger::dataBufferLength() { return dataPointsLogged; }
 
-void DataLogger::printFlightData() { readFlightData(logLine); }
+// Only called at boot, so this can write straight to the port rather than
+// overflow the log buffer
+void DataLogger::printFlightData()
+{
+  readFlightData([](const String &line) { Serial.println(line); });
+}
 
 void DataLogger::readFlightData(PrintCallback callback)
 {
@@ -168,7 +343,10 @@ void DataLogger::readFlightData(PrintCallback callback)
 }
 void logLine(const String &s) { DataLogger::log(s); }
 
-void DataLogger::log(const String &msg) { Serial.println(msg); }
+void DataLogger::log(const String &msg)
+{
+  SerialLog::shared().text(kLogLevelInfo, msg.c_str(), msg.length());
+}
 
 String DataLogger::apogeeHistory()
 {
@@ -206,7 +384,8 @@ void DataLogger::endDataRecording(FlightData &d, int index)
   log(F("Saved Flight"));
 
   f            = SPIFFS.open("/apogeeHistory.txt", "a");
-  String entry = String(d.apogee) + String(" | ") + String(d.maxAcceleration);
+  String entry = String(toFloat(d.apogee)) + String(" | ") +
+                 String(toFloat(d.maxAcceleration));
   f.seek(0, SeekEnd);
   f.println(entry);
   f.close();
@@ -232,8 +411,172 @@ int DataLogger::nextFlightIndex()
   return index;
 }
 
-String FlightDataPoint::toJson()
+void FlightDataPoint::channelValues(LogChannel channel, int32_t *values)
+{
+  const float *v = nullptr;
+  float scalar;
+  switch (channel) {
+    case kLogTime:
+      values[0] = ltime;
+      return;
+    case kLogAltitude:
+      scalar = altitude;
+      v      = &scalar;
+      break;
+    case kLogVelocity:
+      scalar = verticalVelocity;
+      v      = &scalar;
+      break;
+    case kLogAccel:
+      v = accVec;
+      break;
+    case kLogGyro:
+      v = gyroVec;
+      break;
+    case kLogQuaternion:
+      v = quaternion;
+      break;
+    case kLogGimbal:
+      v = gimbal;
+      break;
+    case kLogState:
+      values[0] = flightState;
+      return;
+    default:
+      return;
+  }
+
+  const LogChannelDef &def = kLogSchema[channel];
+  for (uint8_t i = 0; i < def.components; i++) {
+    values[i] = lround(v[i] / def.resolution);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// FlightJsonReader
+
+bool FlightJsonReader::open(const String &path)
+{
+  close();
+  if (DataLogger::openFlightFile(path, f, &schema)) {
+    phase = kReadStart;
+  } else if (f) {
+    // Older flights were recorded as javascript.  Send them as they are.
+    f.seek(0);
+    phase = kReadLegacy;
+  } else {
+    return false;
+  }
+  block  = 0;
+  first  = true;
+  g      = 0;
+  events = "";
+  return true;
+}
+
+void FlightJsonReader::close()
+{
+  if (f) {
+    f.close();
+  }
+  phase = kReadDone;
+}
+
+// One object per tick with the channels logged on that tick, plus "g" (the
+// magnitude of the last acceleration vector) for the graph.  Each block is
+// one chunk.
+bool FlightJsonReader::next(String &chunk)
+{
+  chunk = "";
+  switch (phase) {
+    case kReadStart:
+      chunk = "var flightData = { \"data\":[";
+      phase = kReadBlocks;
+      return true;
+
+    case kReadBlocks: {
+      auto toJson = [&](uint8_t tag, const int32_t *values, uint8_t count) {
+        appendFrame(chunk, tag, values, count);
+      };
+      if (DataLogger::readBlocks(f, schema, block, 1, toJson) > 0) {
+        block++;
+        return true;
+      }
+      if (!first) {
+        chunk += "\"g\":" + String(g) + "}";
+      }
+      chunk += "],\"events\":[" + events + "],";
+      events = "";
+      phase  = kReadSummary;
+      return true;
+    }
+
+    case kReadSummary:
+      if (f.available()) {
+        chunk = f.readStringUntil('\n');
+      } else {
+        chunk = "}";
+        close();
+      }
+      return true;
+
+    case kReadLegacy:
+      if (f.available()) {
+        chunk = f.readStringUntil('\n');
+        return true;
+      }
+      close();
+      return false;
+
+    case kReadDone:
+      break;
+  }
+  return false;
+}
+
+void FlightJsonReader::appendFrame(String &chunk, uint8_t tag,
+                                   const int32_t *values, uint8_t count)
+{
+  if (tag == kLogTime) {
+    if (!first) {
+      chunk += "\"g\":" + String(g) + "},\n";
+    }
+    first = false;
+    chunk += "{\"t\":" + String(values[0]) + ",";
+    return;
+  }
+  if (isChannel(tag, kLogEvent)) {
+    events += String(events.length() ? ",\n" : "") + "{\"us\":" +
+              String((uint32_t)values[0]) + ",\"type\":\"" +
+              flightEventString(values[1]) + "\",\"arg\":" +
+              String(values[2]) + ",\"a\":" + String(values[3] / 10.0) + "}";
+    return;
+  }
+  if (tag >= schema.channelCount) {
+    return;
+  }
+  const LogChannelDef &def = schema.channels[tag];
+  int decimals = def.resolution >= 1 ? 0 : def.resolution >= 0.01 ? 2 : 4;
+  chunk += "\"" + String(def.name) + "\":";
+  if (count > 1) {
+    chunk += "[";
+  }
+  float sumSquares = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    float v = values[i] * def.resolution;
+    sumSquares += v * v;
+    chunk += (i ? "," : "") + String(v, decimals);
+  }
+  chunk += count > 1 ? "]," : ",";
+  if (isChannel(tag, kLogAccel)) {
+    g = sqrt(sumSquares);
+  }
+}
+
+// The file's channels are matched to ours by name, so the graph and the
+// events still work if they've moved
+bool FlightJsonReader::isChannel(uint8_t tag, LogChannel channel)
 {
-  return String("{\"t\":" + String(ltime) + "," + "\"a\":" + String(altitude) +
-                "," + "\"g\":" + String(acelleration) + "}");
+  return tag < schema.channelCount &&
+         !strcmp(schema.channels[tag].name, kLogSchema[channel].name);
 }
@@ -28,37 +28,93 @@
 #define datalogger_h
 
 #include <Arduino.h>
+#include <functional>
+#include "EventLog.hpp"
 #include "FS.h"
 #include "FlightData.hpp"
+#include "SampleCodec.hpp"
 
-typedef void (*PrintCallback)(const String &line);
+typedef std::function<void(const String &line)> PrintCallback;
 
 void logLine(const String &s);
 
 #define FLIGHTS_DIR "/flights"
 
+// The channels recorded in the flight files.  The channel is the frame tag
+// in the sample stream (see SampleCodec.hpp).
+typedef enum : uint8_t {
+  kLogTime = kCodecTimeTag,
+  kLogAltitude,
+  kLogVelocity,
+  kLogAccel,
+  kLogGyro,
+  kLogQuaternion,
+  kLogGimbal,
+  kLogState,
+  kLogEvent,
+  kLogChannelCount
+} LogChannel;
+
+typedef struct {
+  float resolution;    // Value of one count
+  uint8_t components;  // Number of values
+  uint8_t decimation;  // Logged every nth sample.  0 logs only changes and
+                       // kLogOnEvent channels are only written by logEvent.
+  char name[10];       // Key used in the JSON and by the host tools
+} LogChannelDef;
+
+#define kLogOnEvent 0xFF
+#define kLogMaxPendingEvents 8
+
+extern const LogChannelDef kLogSchema[kLogChannelCount];
+
+// Flight files start with a FlightFileHeader and the schema (a LogChannelDef
+// per channel), followed by kCodecBlockSize blocks of samples from
+// headerSize and end with the FlightData summary as text.
+#define kFlightFileMagic "OAF2"
+
+typedef struct {
+  char magic[4];
+  uint16_t headerSize;
+  uint16_t blockSize;
+  uint8_t channelCount;
+  uint8_t reserved[3];
+} FlightFileHeader;
+
+// A flight file's schema as read back from it.  A flight recorded by another
+// build may have more, fewer or different channels than kLogSchema, so it's
+// always decoded and named with its own.
+typedef struct {
+  uint16_t headerSize;
+  uint8_t channelCount;
+  LogChannelDef channels[kCodecMaxTags];
+} FlightFileSchema;
+
 class FlightDataPoint
 {
  public:
   FlightDataPoint() {}
 
-  FlightDataPoint(long ltime, double altitude, double acelleration)
+  FlightDataPoint(long ltime, float altitude, float acelleration)
       : ltime(ltime), altitude(altitude), acelleration(acelleration)
   {
   }
 
-  long ltime          = 0;
-  double altitude     = 0;
-  double acelleration = 0;
+  long ltime         = 0;
+  float altitude     = 0;
+  float acelleration = 0;
 
-  String toJson();
+  float verticalVelocity = 0;
+  float accVec[3]        = {0, 0, 0};
+  float gyroVec[3]       = {0, 0, 0};
+  float quaternion[4]    = {1, 0, 0, 0};
+  float gimbal[2]        = {0, 0};  // Pitch, yaw offset in degrees
+  uint8_t flightState    = 0;
 
-  void reset()
-  {
-    ltime        = 0;
-    altitude     = 0;
-    acelleration = 0;
-  }
+  // The quantised values of |channel|
+  void channelValues(LogChannel channel, int32_t *values);
+
+  void reset() { *this = FlightDataPoint(); }
 };
 
 class DataLoggerOutput
@@ -82,15 +138,33 @@ class DataLogger
 
   static void log(const String &msg);
   static String getFlightList();
+  static String flightPath(int index);
 
   void endDataRecording(FlightData &d, int index);
   void logDataPoint(FlightDataPoint &p, bool isTriggerPoint);
 
+  // Starts writing data points to the flight file, back-filling the buffered
+  // points logged at or after |fromTime|
+  void triggerRecording(long fromTime);
+
+  // Queues |e| to be written with the next data point.  Events that arrive
+  // with no flight file open are discarded.
+  void logEvent(const FlightEvent &e);
+
   void clearBuffer();
   void printFlightData();
 
   void readFlightData(PrintCallback callback);
+
+  // Reads a flight file as a javascript flightData object.  See
+  // FlightJsonReader to read one a piece at a time.
   void readFlightDetails(int index, PrintCallback callback);
+  void readFlightFile(const String &path, PrintCallback callback);
+
+  // Decodes |count| sample blocks from |firstBlock| of a flight.  Returns the
+  // number of ticks read.
+  int readFlightBlocks(int index, int firstBlock, int count,
+                       FrameCallback callback);
 
   String apogeeHistory();
 
@@ -103,6 +177,8 @@ class DataLogger
   void openFlightDataFileWithIndex(int index);
 
  private:
+  friend class FlightJsonReader;
+
   FlightDataPoint dataBuffer[64];
   int dataIndex           = 0;
   const int dataBufferLen = 64;
@@ -110,8 +186,56 @@ class DataLogger
   int dataPointsLogged    = 0;
 
   File dataFile;
+  SampleBlockEncoder encoder;
+  uint8_t channelComponents[kLogChannelCount];
+  uint32_t sampleNumber = 0;
+
+  FlightEvent pendingEvents[kLogMaxPendingEvents];
+  uint8_t pendingEventCount = 0;
 
+  void writeDataPoint(FlightDataPoint &p);
+  void writePendingEvents();
   void closeFlightDataFile(FlightData &d);
+
+  static bool openFlightFile(const String &path, File &f,
+                             FlightFileSchema *schema);
+  static int readBlocks(File &f, const FlightFileSchema &schema,
+                        int firstBlock, int count, FrameCallback callback);
+};
+
+// Reads a flight file as a javascript flightData object one chunk at a time,
+// a block of samples per chunk, so it can be sent between control ticks.
+class FlightJsonReader
+{
+ public:
+  ~FlightJsonReader() { close(); }
+
+  bool open(const String &path);
+  void close();
+
+  // Sets |chunk| to the next piece.  Returns false once it's all been read.
+  bool next(String &chunk);
+
+ private:
+  typedef enum {
+    kReadStart,
+    kReadBlocks,
+    kReadSummary,
+    kReadLegacy,
+    kReadDone
+  } ReadPhase;
+
+  File f;
+  ReadPhase phase = kReadDone;
+  FlightFileSchema schema;
+  int block           = 0;
+  bool first          = true;
+  float g             = 0;
+  String events;
+
+  void appendFrame(String &chunk, uint8_t tag, const int32_t *values,
+                   uint8_t count);
+  bool isChannel(uint8_t tag, LogChannel channel);
 };
 
 #endif
@@ -0,0 +1,68 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "DeploymentPlanner.hpp"
+
+long DeploymentPlanner::actuationMs(RecoveryDeviceType type)
+{
+  switch (type) {
+    case kPyro:
+      return config.pyroActuationMs;
+    case kServo:
+      return config.servoActuationMs;
+    default:
+      return 0;
+  }
+}
+
+long DeploymentPlanner::plan(RecoveryDeviceType type, real_t target,
+                             real_t altitude, real_t velocity, long lagMs)
+{
+  real_t rate = -velocity;
+  if (rate < config.minDescentRate) {
+    if (altitude < target) {
+      firingAltitude = altitude;
+      return 0;
+    }
+    return kPlanNotYet;
+  }
+
+  // How far above where we have to fire the last sample was.  We're
+  // already lagMs further down.
+  real_t lead = overMillis(rate, lagMs + actuationMs(type));
+  lead        = lead < config.maxLead ? lead : config.maxLead;
+  real_t margin = altitude - target - lead;
+
+  long wait = 0;
+  if (margin > 0) {
+    if (margin > overMillis(rate, config.horizonMs)) {
+      return kPlanNotYet;
+    }
+    wait = toFloat(margin / rate) * 1000;
+  }
+  firingAltitude = altitude - overMillis(rate, lagMs + wait);
+  return wait;
+}
@@ -0,0 +1,77 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef deploymentplanner_h
+#define deploymentplanner_h
+
+#include <Arduino.h>
+#include <AltimeterCore.h>
+
+// Works out when to fire a recovery device so the chute is out at the target
+// altitude, rather than only starting to come out there.
+//
+// By the time the altitude reads the target we're already below it by the
+// sensor lag times the descent rate.  Once fired, the device takes its
+// actuation time to get the chute out: charge burn and separation for a pyro,
+// servo travel and the release for a servo.  Under a drogue at 20-30m/s that
+// adds up to 10m or more.
+//
+// plan() projects the descent forward by both and says how long from now to
+// fire.  Below minDescentRate the velocity is mostly noise and it falls back
+// to firing once the altitude is below the target.  The lead is capped at
+// maxLead so a bad velocity estimate can't fire the main far too high.
+
+#define kPlanNotYet -1
+
+typedef struct {
+  uint16_t pyroActuationMs;   // Fire to chute out
+  uint16_t servoActuationMs;  // Fire to chute out
+  real_t minDescentRate;      // m/s
+  real_t maxLead;             // m
+  uint16_t horizonMs;  // Fire times further out than this wait for a sample
+} DeploymentPlanConfig;
+
+class DeploymentPlanner
+{
+ public:
+  DeploymentPlanner(const DeploymentPlanConfig &config) : config(config) {}
+
+  // The ms from now to fire a device of |type| so it's out at |target|, or
+  // kPlanNotYet.  |altitude| and |velocity| trail the truth by |lagMs|.
+  long plan(RecoveryDeviceType type, real_t target, real_t altitude,
+            real_t velocity, long lagMs);
+
+  // Where we'll be when the device fires, for the last plan that fired
+  real_t getFiringAltitude() { return firingAltitude; }
+
+  long actuationMs(RecoveryDeviceType type);
+
+ private:
+  DeploymentPlanConfig config;
+  real_t firingAltitude = 0;
+};
+
+#endif
@@ -0,0 +1,230 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "DeploymentScheduler.hpp"
+#include <core_esp8266_waveform.h>
+#include <core_version.h>
+#include <type_traits>
+#include "EventLog.hpp"
+
+// begin() takes timer0.  Servo only moved off it, onto the waveform
+// generator and timer1, in core 2.5.0.  On an older core the servos and the
+// scheduler would fight over it, so those fail to build here: 2.3 and
+// earlier have no waveform generator, and the 2.4 releases are named.
+#if defined(ARDUINO_ESP8266_RELEASE_2_4_0) || \
+    defined(ARDUINO_ESP8266_RELEASE_2_4_1) || \
+    defined(ARDUINO_ESP8266_RELEASE_2_4_2)
+#error "DeploymentScheduler needs ESP8266 core 2.5.0 or later"
+#endif
+static_assert(std::is_same<decltype(startWaveform(0, 0, 0, 0)), int>::value,
+              "DeploymentScheduler needs ESP8266 core 2.5.0 or later");
+
+// Keeps the compiler from moving the other stores past a state change
+#define compilerBarrier() asm volatile("" ::: "memory")
+
+// Shortest time to set the compare ahead.  A match that is already behind
+// the cycle counter won't fire until it wraps, ~53 seconds later.
+#define kMinWaitUs 10
+
+// Longest time to set the compare ahead.  Well inside a counter wrap at
+// 160MHz.  Anything further out just re-arms when this expires.
+#define kMaxWaitUs 10000000L
+
+DeploymentScheduler *DeploymentScheduler::instance = nullptr;
+
+static inline void ICACHE_RAM_ATTR switchPin(uint8_t pin, bool high)
+{
+  if (pin < 16) {
+    if (high) {
+      GPOS = (1 << pin);
+    } else {
+      GPOC = (1 << pin);
+    }
+  } else if (pin == 16) {
+    if (high) {
+      GP16O |= 1;
+    } else {
+      GP16O &= ~1;
+    }
+  }
+}
+
+static inline bool ICACHE_RAM_ATTR isDue(uint32_t due, uint32_t now)
+{
+  return (int32_t)(now - due) >= 0;
+}
+
+void DeploymentScheduler::begin()
+{
+  for (int i = 0; i < kMaxDeployments; i++) {
+    actions[i].state = kFree;
+  }
+  cyclesPerUs = ESP.getCpuFreqMHz();
+  instance    = this;
+
+  noInterrupts();
+  timer0_isr_init();
+  timer0_attachInterrupt(onTimer);
+  interrupts();
+}
+
+bool DeploymentScheduler::fire(RecoveryDevice *device, uint32_t delayMs)
+{
+  if (isScheduled(device)) {
+    return false;
+  }
+
+  for (int i = 0; i < kMaxDeployments; i++) {
+    Action &a = actions[i];
+    if (a.state != kFree) {
+      continue;
+    }
+    a.device       = device;
+    a.pin          = device->switchPin;
+    a.cutAfter     = device->type == kPyro ? cutAfterUs : 0;
+    a.firedAt      = 0;
+    a.cutAt        = 0;
+    a.fireReported = false;
+
+    noInterrupts();
+    a.due   = micros() + delayMs * 1000;
+    a.state = kArmed;
+    arm();
+    interrupts();
+    return true;
+  }
+  return false;
+}
+
+bool DeploymentScheduler::isScheduled(RecoveryDevice *device)
+{
+  for (int i = 0; i < kMaxDeployments; i++) {
+    if (actions[i].state != kFree && actions[i].device == device) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void DeploymentScheduler::cancel(real_t altitude)
+{
+  noInterrupts();
+  for (int i = 0; i < kMaxDeployments; i++) {
+    Action &a = actions[i];
+    if (a.state == kArmed) {
+      a.state = kFree;
+    } else if (a.state == kOn) {
+      switchPin(a.pin, false);
+      a.cutAt = micros();
+      a.state = kFinished;
+    }
+  }
+  interrupts();
+
+  // A fire the timer has run but service() hasn't seen yet still happened
+  service(altitude);
+}
+
+void DeploymentScheduler::service(real_t altitude)
+{
+  for (int i = 0; i < kMaxDeployments; i++) {
+    Action &a         = actions[i];
+    ActionState state = a.state;
+    if (state == kFree || state == kArmed) {
+      continue;
+    }
+    compilerBarrier();
+
+    if (!a.fireReported) {
+      if (a.pin == RecoveryDevice::kNoSwitchPin) {
+        // The timer only marked it due
+        a.device->enable();
+        a.firedAt = micros();
+      } else {
+        a.device->noteEnabled(millis() - (micros() - a.firedAt) / 1000);
+      }
+      EventLog::shared().recordAt(a.firedAt, kEventDeploy, altitude,
+                                  a.device->id);
+      a.fireReported = true;
+    }
+
+    if (state == kFinished) {
+      if (a.cutAfter) {
+        a.device->noteTimedCut();
+        EventLog::shared().recordAt(a.cutAt, kEventDeployOff, altitude,
+                                    a.device->id);
+      }
+      a.state = kFree;
+    }
+  }
+}
+
+// Sets the compare for the earliest step still to run.  Interrupts must be
+// off.
+void ICACHE_RAM_ATTR DeploymentScheduler::arm()
+{
+  bool pending = false;
+  uint32_t now = micros();
+  int32_t wait = kMaxWaitUs;
+  for (int i = 0; i < kMaxDeployments; i++) {
+    Action &a = actions[i];
+    if (a.state == kArmed || a.state == kOn) {
+      int32_t w = (int32_t)(a.due - now);
+      wait      = w < wait ? w : wait;
+      pending   = true;
+    }
+  }
+  if (!pending) {
+    return;
+  }
+  wait = wait < kMinWaitUs ? kMinWaitUs : wait;
+  timer0_write(ESP.getCycleCount() + wait * cyclesPerUs);
+}
+
+void ICACHE_RAM_ATTR DeploymentScheduler::onTimer()
+{
+  DeploymentScheduler *s = instance;
+  for (int i = 0; i < kMaxDeployments; i++) {
+    Action &a = s->actions[i];
+    if (a.state == kArmed && isDue(a.due, micros())) {
+      if (a.pin == RecoveryDevice::kNoSwitchPin) {
+        a.state = kFinished;
+        continue;
+      }
+      switchPin(a.pin, true);
+      a.firedAt = micros();
+      a.due     = a.firedAt + a.cutAfter;
+      compilerBarrier();
+      a.state = a.cutAfter ? kOn : kFinished;
+    } else if (a.state == kOn && isDue(a.due, micros())) {
+      switchPin(a.pin, false);
+      a.cutAt = micros();
+      compilerBarrier();
+      a.state = kFinished;
+    }
+  }
+  s->arm();
+}
@@ -0,0 +1,109 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef deploymentscheduler_h
+#define deploymentscheduler_h
+
+#include <Arduino.h>
+#include <AltimeterCore.h>
+#include <RecoveryDevice.h>
+
+// Fires recovery devices at a set time from a hardware timer rather than
+// from the 10ms control tick.
+//
+// Each fire() takes a slot that is run from the timer0 compare interrupt,
+// so the pin switches within a few microseconds of when it was asked for
+// however late the main loop is.  A pyro channel is switched off again
+// exactly cutAfterMs after it actually fired, from the same interrupt.
+//
+// The interrupt only ever writes a GPIO register.  It may land while the
+// flash cache is off (SPIFFS writes), so it can't call into the device or
+// anything else in flash.  Servos and channels with nothing fitted are
+// marked due by the interrupt and moved by service() instead.  That is
+// fine for a servo, which takes hundreds of ms to travel anyway.
+//
+// service() runs from the main loop.  It does the device book-keeping and
+// posts the actual fire and cut times to the EventLog.  The event log has a
+// single producer, and that is the main loop, not this interrupt.
+//
+// timer1 belongs to the core's waveform generator, which drives Servo and
+// analogWrite, so this uses timer0 (the CCOMPARE0 cycle counter match).
+// That needs core 2.5.0 or later; before it Servo used timer0 too.
+
+#define kMaxDeployments 4  // One per channel
+
+class DeploymentScheduler
+{
+ public:
+  DeploymentScheduler(uint32_t cutAfterMs) : cutAfterUs(cutAfterMs * 1000) {}
+
+  // Takes over timer0
+  void begin();
+
+  // Fires |device| |delayMs| from now.  Returns false if it's already waiting
+  // to fire or there's no free slot.
+  bool fire(RecoveryDevice *device, uint32_t delayMs);
+
+  // True from fire() until the action has run and been reported
+  bool isScheduled(RecoveryDevice *device);
+
+  // Drops everything that's waiting to fire.  Pyro channels the timer has
+  // fired are switched off now, and whatever it fired is reported as
+  // service() would, with |altitude| in the events.
+  void cancel(real_t altitude);
+
+  // Main loop work.  See above.  |altitude| goes in the events.
+  void service(real_t altitude);
+
+ private:
+  typedef enum : uint8_t {
+    kFree,
+    kArmed,     // Waiting to fire at due
+    kOn,        // Pyro fired and waiting to be cut at due
+    kFinished,  // The timer's done with it.  Waiting for service().
+  } ActionState;
+
+  typedef struct {
+    RecoveryDevice *device;
+    uint32_t due;      // micros() the next step is due
+    uint32_t firedAt;  // micros() the output was switched on
+    uint32_t cutAt;    // micros() it was switched off, if it was
+    uint32_t cutAfter;
+    uint8_t pin;  // RecoveryDevice::kNoSwitchPin if service() drives it
+    bool fireReported;
+    volatile ActionState state;
+  } Action;
+
+  Action actions[kMaxDeployments];
+  uint32_t cutAfterUs;
+  uint32_t cyclesPerUs = 80;
+
+  void arm();
+  static void onTimer();
+  static DeploymentScheduler *instance;
+};
+
+#endif
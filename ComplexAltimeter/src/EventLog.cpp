@@ -0,0 +1,109 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "EventLog.hpp"
+
+// Keeps the compiler from moving the event stores past the index update
+#define compilerBarrier() asm volatile("" ::: "memory")
+
+EventLog &EventLog::shared()
+{
+  static EventLog sharedInstance;
+  return sharedInstance;
+}
+
+bool EventLog::record(FlightEventType type, real_t altitude, uint8_t arg)
+{
+  return recordAt(micros(), type, altitude, arg);
+}
+
+bool EventLog::recordAt(uint32_t micros, FlightEventType type, real_t altitude,
+                        uint8_t arg)
+{
+  uint8_t h = head;
+  if ((uint8_t)(h - tail) >= kEventLogSize) {
+    dropped++;
+    return false;
+  }
+
+  long dm = lroundf(toFloat(altitude) * 10);
+  dm      = dm > INT16_MAX ? INT16_MAX : dm < INT16_MIN ? INT16_MIN : dm;
+
+  FlightEvent &e = events[h & (kEventLogSize - 1)];
+  e.micros       = micros;
+  e.type         = type;
+  e.arg          = arg;
+  e.value        = dm;
+  compilerBarrier();
+  head = h + 1;
+  return true;
+}
+
+bool EventLog::pop(FlightEvent *event)
+{
+  uint8_t t = tail;
+  if (t == head) {
+    return false;
+  }
+  compilerBarrier();
+  *event = events[t & (kEventLogSize - 1)];
+  compilerBarrier();
+  tail = t + 1;
+  return true;
+}
+
+const char *flightEventString(uint8_t type)
+{
+  switch (type) {
+    case kEventArmed:
+      return "Armed";
+    case kEventLaunchAcc:
+      return "Flight Started - ACC Trigger";
+    case kEventLaunchVelocity:
+      return "Flight Started - Velocity Trigger";
+    case kEventLaunchAlt:
+      return "Flight Started";
+    case kEventBurnout:
+      return "Burnout";
+    case kEventDescending:
+      return "Descending";
+    case kEventDeploy:
+      return "Deploy";
+    case kEventDeployOff:
+      return "Deploy Off";
+    case kEventLanded:
+      return "Landed";
+    case kEventFailsafe:
+      return "Failsafe";
+    case kEventBaroLockout:
+      return "Baro Lockout";
+    case kEventBaroRelease:
+      return "Baro Release";
+    case kEventState:
+      return "State";
+  }
+  return "";
+}
@@ -0,0 +1,101 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef eventlog_h
+#define eventlog_h
+
+#include <Arduino.h>
+#include <AltimeterCore.h>
+
+// Flight events are recorded into a fixed size ring from the control tick and
+// drained to the serial port and the flight file from the main loop, so a
+// state change costs a few stores rather than a println.
+//
+// There is exactly one producer and one consumer.  The producer only writes
+// head and the consumer only writes tail, so no locking is required.  Both
+// run on the main loop.  Never record from an interrupt: it could land in
+// the middle of another record() and corrupt head.  Things timed in an
+// interrupt are recorded later with recordAt().
+
+#define kEventLogSize 32  // Must be a power of two
+
+typedef enum : uint8_t {
+  kEventNone = 0,
+  kEventArmed,
+  kEventLaunchAcc,
+  kEventLaunchAlt,
+  kEventBurnout,
+  kEventDescending,  // Older flights.  Now a kEventState
+  kEventDeploy,      // arg is the recovery device channel
+  kEventDeployOff,   // arg is the recovery device channel
+  kEventLanded,      // Older flights.  Now a kEventState
+  kEventFailsafe,
+  kEventBaroLockout,
+  kEventBaroRelease,  // arg is the step back onto the barometer in m
+  kEventState,        // arg is the FlightState left << 4 | the one entered
+  kEventLaunchVelocity,
+} FlightEventType;
+
+const char *flightEventString(uint8_t type);
+
+typedef struct {
+  uint32_t micros;
+  uint8_t type;
+  uint8_t arg;
+  int16_t value;  // Altitude in decimetres
+} FlightEvent;
+
+class EventLog
+{
+ public:
+  static EventLog &shared();
+
+  EventLog() {}
+  EventLog(EventLog const &) = delete;
+  void operator=(EventLog const &) = delete;
+
+  // Records an event timestamped now.  Main loop (and the control tick) only.
+  // Returns false, and counts the event as dropped, if the ring is full.
+  bool record(FlightEventType type, real_t altitude, uint8_t arg = 0);
+
+  // Records an event that happened at |micros|, for things timed elsewhere.
+  // Events are kept in the order they're recorded, not by time.
+  bool recordAt(uint32_t micros, FlightEventType type, real_t altitude,
+                uint8_t arg = 0);
+
+  // Removes the oldest event.  Returns false if there are none.
+  bool pop(FlightEvent *event);
+
+  uint32_t getDropped() { return dropped; }
+
+ private:
+  FlightEvent events[kEventLogSize];
+  volatile uint8_t head     = 0;
+  volatile uint8_t tail     = 0;
+  volatile uint32_t dropped = 0;
+};
+
+#endif
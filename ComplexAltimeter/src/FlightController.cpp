@@ -27,13 +27,56 @@
 #include "FlightController.hpp"
 #include <FS.h>
 #include "DataLogger.hpp"
+#include "EventLog.hpp"
+#include "SerialLog.hpp"
 
 #include "../Configuration.h"
 #include "types.h"
 
 #define kMaxBlinks 64
-
-FlightController::FlightController() : imu(1000 / SENSOR_READ_DELAY_MS)
+#define kEventsPerLoop 4
+
+static const LaunchConfig kLaunchConfig = {
+    LAUNCH_WINDOW,
+    LAUNCH_ACC_VOTES,
+    LAUNCH_VELOCITY_VOTES,
+    FLIGHT_START_THRESHOLD_ACC,
+    LAUNCH_VELOCITY_THRESHOLD,
+    FLIGHT_START_THRESHOLD_ALT,
+    LAUNCH_MOTION_ACC,
+};
+
+// Alpha-beta gains for the fused altitude.  The IMU does the tracking and
+// these just hold it onto the barometer.  Tuned in replay with 1% scale
+// error and 0.2 m/s/s of bias on the accelerometer.
+static const BaroLockoutConfig kBaroLockoutConfig = {
+    BARO_LOCKOUT_VELOCITY,
+    BARO_RELEASE_VELOCITY,
+    BARO_LOCKOUT_GATE,
+    BARO_RELEASE_RATE_GATE,
+    BARO_LOCKOUT_MIN_MS,
+    BARO_LOCKOUT_MAX_MS,
+    BARO_RELEASE_SAMPLES,
+    0.1,  // alpha
+    0.5,  // beta
+};
+
+// The horizon covers a slow tick or two.  The descent rate doesn't change
+// enough in that time to be worth waiting for another sample.
+static const DeploymentPlanConfig kDeploymentPlanConfig = {
+    PYRO_ACTUATION_MS,
+    SERVO_ACTUATION_MS,
+    DEPLOYMENT_MIN_DESCENT_RATE,
+    DEPLOYMENT_MAX_LEAD,
+    100,  // horizonMs
+};
+
+FlightController::FlightController()
+    : imu(1000 / SENSOR_READ_DELAY_MS),
+      launchDetector(kLaunchConfig),
+      baroLockout(kBaroLockoutConfig),
+      deployments(MAX_FIRE_TIME),
+      deploymentPlanner(kDeploymentPlanConfig)
 {
   SPIFFS.begin();
 
@@ -41,7 +84,8 @@ FlightController::FlightController() : imu(1000 / SENSOR_READ_DELAY_MS)
   DataLogger::sharedLogger();
 
   DataLogger::log("Creating Flight Controller");
-  blinker = new Blinker(MESSAGE_PIN, BUZZER_PIN);
+  blinker = new Blinker<TickerTimerSource, BoardConfig::MessagePin,
+                        BoardConfig::BuzzerPin>();
   DataLogger::log("Creating Flight Controller --");
 
   this->initialize();
@@ -76,15 +120,15 @@ void FlightController::initialize()
   pinMode(RESET_PIN, INPUT_PULLUP);
 
   // All LED pins sset to outputs
-  pinMode(MESSAGE_PIN, OUTPUT);
-  pinMode(STATUS_PIN, OUTPUT);
-  pinMode(READY_PIN, OUTPUT);
-  pinMode(BUZZER_PIN, OUTPUT);
+  BoardConfig::MessagePin::begin();
+  BoardConfig::StatusPin::begin();
+  BoardConfig::ReadyPin::begin();
+  BoardConfig::BuzzerPin::begin();
 
   // Start in the "error" state.  Status pin should be high and message
   // pin should be low to indicate a good startup
-  digitalWrite(STATUS_PIN, LOW);
-  digitalWrite(MESSAGE_PIN, HIGH);
+  BoardConfig::StatusPin::write(LOW);
+  BoardConfig::MessagePin::write(HIGH);
 
   barometerReady = altimeter.start();
   mpuReady       = imu.start();
@@ -111,27 +155,39 @@ void FlightController::initRecoveryDevices()
     offAngle = kChuteReleaseArmedAngle;
   }
 
-  for (int i = 0; i < 4; i++) {
-    devices[i] = new RecoveryDevice();
-  }
+  devices[0] = new BoardConfig::Channel1();
+  devices[1] = new BoardConfig::Channel2();
+  devices[2] = new BoardConfig::Channel3();
+  devices[3] = new BoardConfig::Channel4();
+
+  RecoveryDevice::offAngle = offAngle;
+  RecoveryDevice::onAngle  = onAngle;
+  DataLogger::log("Servo angles on:" + String(onAngle) +
+                  " off:" + String(offAngle));
+
+  devices[0]->init(ControlChannel1);
+  devices[1]->init(ControlChannel2);
+  devices[2]->init(ControlChannel3);
+  devices[3]->init(ControlChannel4);
 
-  RecoveryDevice::setOffAngle(offAngle, false);
-  RecoveryDevice::setOnAngle(onAngle, false);
+  if (!BoardConfig::kGimballing) {
+    setMainChannel(ControlChannel1);
+    setDrogueChannel(ControlChannel2);
+  } else {
+    // Use pyro channels gimballing
+    setMainChannel(ControlChannel3);
+    setDrogueChannel(ControlChannel4);
 
-#if !ENABLE_GIMBALLING
-  devices[0]->init(ControlChannel1, DEPL_CTL_1, CTL_1_TYPE);
-  devices[1]->init(ControlChannel2, DEPL_CTL_2, CTL_2_TYPE);
-  setMainChannel(ControlChannel1);
-  setDrogueChannel(ControlChannel2);
-#else
-  //Use pyro channels gimballing
-  devices[2]->init(ControlChannel3, DEPL_CTL_3, CTL_3_TYPE);
-  devices[3]->init(ControlChannel4, DEPL_CTL_4, CTL_4_TYPE);
-  setMainChannel(ControlChannel3);
-  setDrogueChannel(ControlChannel4);
+    attitudeControl = new AttitudeControl(imu);
+  }
 
-  attitudeControl = new AttitudeControl(imu);
-#endif
+  if (DROGUE_BACKUP_CHANNEL) {
+    drogueBackup = getRecoveryDevice(DROGUE_BACKUP_CHANNEL);
+  }
+  if (MAIN_BACKUP_CHANNEL) {
+    mainBackup = getRecoveryDevice(MAIN_BACKUP_CHANNEL);
+  }
+  deployments.begin();
 }
 
 void FlightController::setMainChannel(int channel)
@@ -157,7 +213,7 @@ StatusData const &FlightController::getStatusData()
   statusData.baroReady         = barometerReady;
   statusData.mpuReady          = mpuReady;
   statusData.padAltitude       = altimeter.referenceAltitude();
-  statusData.lastApogee        = flightData.apogee;
+  statusData.lastApogee        = toFloat(flightData.apogee);
   statusData.referencePressure = altimeter.getRefPressure();
 
   return statusData;
@@ -173,6 +229,19 @@ String FlightController::getStatus()
   ret += "Flight Count :" + String(flightCount) + "<br/>";
   ret += "Deployment Altitude: " + String(deploymentAltitude) + "<br/>";
   ret += "Pad Altitude:" + String(altimeter.referenceAltitude()) + "<br/>";
+  ret += "Baro Rate:" + String(altimeter.sampleRate()) + "Hz<br/>";
+  ret += "Baro Max Block:" + String(altimeter.maxBlockingTime()) + "us<br/>";
+  ret += "Baro Lockouts:" + String(baroLockout.getLockoutCount()) + " (" +
+         String(toFloat(baroLockout.getMaxReleaseError())) + "m)<br/>";
+  ret += "Free Heap:" + String(ESP.getFreeHeap()) + "<br/>";
+  ret += "Display FPS:" + String(userInterface.framesPerSecond()) + "<br/>";
+  ret += "Display Bus:" + String(userInterface.busUtilisation()) + "%<br/>";
+  ret += "Frames Skipped:" + String(userInterface.skippedFrames()) + "<br/>";
+  ret += "Events Dropped:" + String(EventLog::shared().getDropped()) + "<br/>";
+  ret += "Log Dropped:" + String(SerialLog::shared().getDropped()) + "<br/>";
+  ret += "Web Max Slice:" + String(server.getMaxSlice()) + "us<br/>";
+  ret += "Samples Deferred:" + String(samplesDeferred) + "<br/>";
+  ret += "Samples Missed:" + String(samplesMissed) + "<br/>";
   if (flightState != kReadyToFly) {
     ret += "Last Flight:" + flightData.toString(flightCount) + "<br/>";
   }
@@ -182,6 +251,11 @@ String FlightController::getStatus()
 void readSensors(FlightController *f)
 {
   if (f != nullptr) {
+    if (f->sampleOnNextLoop) {
+      f->samplesMissed++;
+    } else if (f->server.isBusy()) {
+      f->samplesDeferred++;
+    }
     f->sampleOnNextLoop = true;
   }
 }
@@ -194,20 +268,31 @@ void FlightController::loop()
     userInterface.start();
   }
   failsafeCheck();
+  deployments.service(tickAltitude);
+  if (BoardConfig::kGimballing) {
+    attitudeControl->service();
+  }
 
-
-  // Ignore the wifis and oled when we're flying.
-  if (flightState == kReadyToFly || flightState == kOnGround) {
-    server.handleClient();
-    userInterface.eventLoop(true);
+  // Ignore the wifis when we're flying.  The display is governed by the
+  // i2c budget for the flight mode.
+  bool onPad = (flightState == kReadyToFly || flightState == kOnGround);
+  if (onPad) {
+    server.service(WEB_SLICE_US, &sampleOnNextLoop);
   } else {
-    userInterface.eventLoop(false);
+    server.cancelTransfer();
   }
+  userInterface.eventLoop(onPad || RUN_DISPLAY_WHILE_FLYING, !onPad,
+                          sampleOnNextLoop);
 
   if (sampleOnNextLoop) {
     flightControl();
-    attitudeControl->update();
+    if (BoardConfig::kGimballing) {
+      attitudeControl->update();
+    }
     sampleOnNextLoop = false;
+  } else {
+    drainEvents(kEventsPerLoop);
+    SerialLog::shared().service();
   }
 
   if (flightState == kReadyToFly && altimeter.isReady() &&
@@ -218,7 +303,8 @@ void FlightController::loop()
     blinker->blinkValue(2, 300, true, false);
     DataLogger::sharedLogger().openFlightDataFileWithIndex(flightCount);
     sensorTicker.attach_ms(SENSOR_READ_DELAY_MS, readSensors, this);
-    digitalWrite(READY_PIN, HIGH);
+    EventLog::shared().record(kEventArmed, altimeter.referenceAltitude());
+    BoardConfig::ReadyPin::write(HIGH);
     flightControl();
   }
 
@@ -232,7 +318,7 @@ void FlightController::loop()
     sensorTicker.detach();
     flightControl();
     blinker->cancelSequence();
-    digitalWrite(READY_PIN, LOW);
+    BoardConfig::ReadyPin::write(LOW);
     if (lastApogee) {
       DataLogger::log(String(F("Starting Blinker: ")) + String(lastApogee));
       blinker->blinkValue(lastApogee, BLINK_SPEED_MS, true);
@@ -251,12 +337,32 @@ void FlightController::failsafeCheck()
     SensorData d;
     readSensorData(&d);
     if(d.altitude < FAILSAFE_ALTITUDE) {
-       setRecoveryDeviceState(ON, mainChute);
-       setRecoveryDeviceState(ON, drogueChute);
+       bool fired = false;
+       if (!mainChute->deployed) {
+         fired |= deployments.fire(mainChute, 0);
+       }
+       if (!drogueChute->deployed) {
+         fired |= deployments.fire(drogueChute, 0);
+       }
+       if (fired) {
+         EventLog::shared().record(kEventFailsafe, d.altitude);
+       }
     }
   }
 }
 
+// Writes out up to |maxEvents| events from the event log.  This is called
+// between control ticks so the serial port never holds one up.
+void FlightController::drainEvents(int maxEvents)
+{
+  FlightEvent e;
+  while (maxEvents-- && EventLog::shared().pop(&e)) {
+    LOG_INFO("%uus %s %u Alt:%.1f", e.micros, flightEventString(e.type),
+             e.arg, e.value / 10.0);
+    DataLogger::sharedLogger().logEvent(e);
+  }
+}
+
 void FlightController::setDeploymentAltitude(int altitude)
 {
   DataLogger::log("Deployment Altitude Set to " + String(altitude));
@@ -272,8 +378,11 @@ void FlightController::resetAll()
 }
 
 void FlightController::stop() {
-  attitudeControl->stop();
-  flightState = kOnGround;
+  deployments.cancel(tickAltitude);
+  if (BoardConfig::kGimballing) {
+    attitudeControl->stop();
+  }
+  kFlightStates.enter(flightState, kOnGround, *this);
 }
 
 void FlightController::reset()
@@ -285,9 +394,14 @@ void FlightController::reset()
   flightCount = DataLogger::sharedLogger().nextFlightIndex();
   flightData.reset();
   resetTime = millis();
+  altimeter.setProfile(kPadIdleProfile);
   altimeter.reset();
   imu.reset();
+  launchDetector.reset();
+  baroLockout.reset(0);
+  baroLockout.setInertialEnabled(mpuReady);
 
+  deployments.cancel(tickAltitude);
   setRecoveryDeviceState(OFF, drogueChute);
   drogueChute->reset();
   setRecoveryDeviceState(OFF, mainChute);
@@ -295,10 +409,13 @@ void FlightController::reset()
 
   testFlightTimeStep = 0;
   blinker->cancelSequence();
-  flightState = kReadyToFly;
+  tickAltitude = 0;
+  kFlightStates.enter(flightState, kReadyToFly, *this);
 
-  attitudeControl->calibrate();
-  attitudeControl->start();
+  if (BoardConfig::kGimballing) {
+    attitudeControl->calibrate();
+    attitudeControl->start();
+  }
 
   DataLogger::log(F("Ready To Fly..."));
 }
@@ -307,6 +424,8 @@ void FlightController::runTest()
 {
   if (flightState == kReadyToFly && testFlightTimeStep == 0) {
     testFlightTimeStep = 1;
+    // The test flight has no IMU data to bridge with
+    baroLockout.setInertialEnabled(false);
   }
 }
 
@@ -319,33 +438,156 @@ void FlightController::readSensorData(SensorData *d)
 
   // Our relative altitude... Relative to wherever we last reset the altimeter.
   if (altimeter.isReady()) {
+    unsigned long samples = altimeter.getSampleCount();
     altimeter.update();
     d->altitude         = altimeter.altitude();
     d->verticalVelocity = altimeter.verticalVelocity();
+    d->rawAltitude      = altimeter.rawAltitude();
+    d->newBaroSample    = altimeter.getSampleCount() != samples;
   }
   imu.update();
   d->heading      = imu.getRelativeHeading();
   d->acc_vec      = imu.getAcceleration();
   d->gyro_vec     = imu.getGyro();
-  d->acceleration = d->acc_vec.length();
+  d->acceleration = toReal(d->acc_vec.length());
+  d->verticalAcceleration = imu.getVerticalAcceleration();
+}
+
+//////////  Flight states /////////////
+
+// The table is in AltimeterCore's FlightPhases.hpp
+constexpr FlightStateMachine<FlightState, FlightController>
+    FlightController::kFlightStates(Phases::kFlightTransitions,
+                                    stampTransition);
+
+bool FlightController::isLaunched(FlightController &c)
+{
+  return c.launchDetector.update(c.tickTime, c.tickAcceleration,
+                                 c.sensorData.verticalVelocity,
+                                 c.tickAltitude);
+}
+
+void FlightController::onLaunch(FlightController &c)
+{
+  long firstMotion = c.launchDetector.getFirstMotionTime();
+  switch (c.launchDetector.getTrigger()) {
+    case kLaunchAcc:
+      EventLog::shared().record(kEventLaunchAcc, c.tickAltitude);
+      c.flightData.accTriggerTime = firstMotion - c.resetTime;
+      break;
+    case kLaunchVelocity:
+      EventLog::shared().record(kEventLaunchVelocity, c.tickAltitude);
+      c.flightData.velTriggerTime = firstMotion - c.resetTime;
+      break;
+    default:
+      EventLog::shared().record(kEventLaunchAlt, c.tickAltitude);
+      c.flightData.altTriggerTime = firstMotion - c.resetTime;
+      break;
+  }
+  c.altimeter.setProfile(kBoostProfile);
+  // For testing - to indicate we're in the ascending mode
+  BoardConfig::ReadyPin::write(LOW);
+  BoardConfig::MessagePin::write(HIGH);
+  DataLogger::sharedLogger().triggerRecording(firstMotion -
+                                              LAUNCH_PRE_ROLL_MS);
+}
+
+// DESCENT_THRESHOLD meters below our apogee
+bool FlightController::isPastApogee(FlightController &c)
+{
+  return c.tickAltitude < c.flightData.apogee - DESCENT_THRESHOLD;
+}
+
+void FlightController::onApogee(FlightController &c)
+{
+  c.altimeter.setProfile(kDescentProfile);
+  // Deploy our drogue chute
+  c.deployments.fire(c.drogueChute, DROGUE_DELAY_MS);
+  if (c.drogueBackup) {
+    c.deployments.fire(c.drogueBackup, DROGUE_DELAY_MS + BACKUP_DELAY_MS);
+  }
+  c.flightData.drogueEjectionAltitude = c.tickAltitude;
+}
+
+bool FlightController::isLanded(FlightController &c)
+{
+  return c.tickAltitude < FLIGHT_END_THRESHOLD_ALT;
+}
+
+void FlightController::onLanding(FlightController &c)
+{
+  c.altimeter.setProfile(kPadIdleProfile);
+  c.lastApogee = toFloat(c.flightData.apogee);
+
+  // The flight is over, so flush everything into the flight file now.  Any
+  // backup charges still waiting are dropped; we're on the ground.
+  c.deployments.cancel(c.tickAltitude);
+  c.drainEvents(kEventLogSize);
+
+  DataLogger::log(c.flightData.toString(c.flightCount));
+  DataLogger::sharedLogger().endDataRecording(c.flightData, c.flightCount);
+  c.server.bindFlight(c.flightCount);
+
+  DataLogger::log(F("Resetting Pyro"));
+  c.resetRecoveryDeviceIfRequired(c.drogueChute);
+  c.resetRecoveryDeviceIfRequired(c.mainChute);
+  DataLogger::log(F("Relays Reset"));
+  c.enableBuzzer = true;
+}
+
+void FlightController::stampTransition(FlightController &c, FlightState from,
+                                       FlightState to)
+{
+  EventLog::shared().record(kEventState, c.tickAltitude, from << 4 | to);
 }
 
 void FlightController::flightControl()
 {
   long t = millis();
   readSensorData(&sensorData);
-  double acceleration = sensorData.acceleration;
-  double altitude     = sensorData.altitude;
 
-  FlightDataPoint dp = FlightDataPoint(t, altitude, acceleration);
+  bool wasLockedOut = baroLockout.isLockedOut();
+  baroLockout.update(t, sensorData.verticalAcceleration,
+                     sensorData.rawAltitude, sensorData.newBaroSample);
+  if (baroLockout.isLockedOut() != wasLockedOut) {
+    if (wasLockedOut) {
+      // Whatever the IMU drifted by was in the apogee too
+      real_t step = baroLockout.takeRebase();
+      flightData.apogee += step;
+      EventLog::shared().record(kEventBaroRelease, baroLockout.altitude(),
+                                MIN(toFloat(realAbs(step)), 255));
+    } else {
+      EventLog::shared().record(kEventBaroLockout, baroLockout.altitude());
+    }
+  }
+
+  real_t acceleration = sensorData.acceleration;
+  real_t altitude     = baroLockout.altitude();
+
+  FlightDataPoint dp =
+      FlightDataPoint(t, toFloat(altitude), toFloat(acceleration));
+  dp.verticalVelocity = toFloat(baroLockout.velocity());
+  dp.accVec[0]        = sensorData.acc_vec.XAxis;
+  dp.accVec[1]        = sensorData.acc_vec.YAxis;
+  dp.accVec[2]        = sensorData.acc_vec.ZAxis;
+  dp.gyroVec[0]       = sensorData.gyro_vec.XAxis;
+  dp.gyroVec[1]       = sensorData.gyro_vec.YAxis;
+  dp.gyroVec[2]       = sensorData.gyro_vec.ZAxis;
+  dp.flightState      = flightState;
+  imu.getQuaternion(dp.quaternion);
+  if (BoardConfig::kGimballing) {
+    dp.gimbal[0] = attitudeControl->getPitchOffset();
+    dp.gimbal[1] = attitudeControl->getYawOffset();
+  }
 
   // Log every 5 samples when going fast and every 20 when in a slow descent.
   int sampleDelay = (flightState != kDescending) ? 5 : 20;
   logCounterUI    = !logCounterUI ? sampleDelay : logCounterUI - 1;
   if (0 == logCounterUI && flightState != kOnGround) {
-     DataLogger::log("Alt:" + String(altitude) + "  " +
-                     sensorData.heading.toString() + +"   " +
-                     sensorData.acc_vec.toString());
+    LOG_DEBUG("Alt:%f  %f:%f:%f   %f:%f:%f", toFloat(altitude),
+              sensorData.heading.roll, sensorData.heading.pitch,
+              sensorData.heading.yaw, sensorData.acc_vec.XAxis,
+              sensorData.acc_vec.YAxis, sensorData.acc_vec.ZAxis);
   }
 
   DataLogger::sharedLogger().logDataPoint(dp, false);
@@ -354,72 +596,36 @@ void FlightController::flightControl()
   flightData.apogee          = MAX(flightData.apogee, altitude);
   flightData.maxAcceleration = MAX(flightData.maxAcceleration, acceleration);
 
-  if (flightState == kReadyToFly && acceleration > FLIGHT_START_THRESHOLD_ACC) {
-    DataLogger::log("Flight Started - ACC Trigger");
-    flightState               = kAscending;
-    flightData.accTriggerTime = t - resetTime;
-    digitalWrite(READY_PIN, LOW);
-    digitalWrite(MESSAGE_PIN, HIGH);
-  }
+  tickTime         = t;
+  tickAltitude     = altitude;
+  tickAcceleration = acceleration;
+  static_assert(transitionsSorted(Phases::kFlightTransitions),
+                "Flight transitions must be sorted by the state they leave");
+  kFlightStates.step(flightState, *this);
 
-  if (flightState == kAscending && acceleration < 11.0 &&
+  if (flightState == kAscending && acceleration < real_t(11) &&
       flightData.burnoutTime == 0) {
     // We're on the way up, but gravity has taken over... We're now coasting.
     flightData.burnoutTime     = t - resetTime;
     flightData.burnoutAltitude = altitude;
-  }
-
-  if (flightState == kReadyToFly && altitude > FLIGHT_START_THRESHOLD_ALT) {
-    // Transition to "InFlight" if we've exceeded the threshold altitude.
-    DataLogger::log(F("Flight Started"));
-    flightState               = kAscending;
-    flightData.altTriggerTime = t - resetTime;
-    // For testing - to indicate we're in the ascending mode
-    digitalWrite(READY_PIN, LOW);
-    digitalWrite(MESSAGE_PIN, HIGH);
-    DataLogger::sharedLogger().logDataPoint(dp, true);
-  } else if (flightState == kAscending &&
-             altitude < (flightData.apogee - DESCENT_THRESHOLD)) {
-    // Transition to kDescendining if we've we're DESCENT_THRESHOLD meters below
-    // our apogee
-    DataLogger::log(F("Descending"));
-    flightState = kDescending;
-    // Deploy our drogue chute
-    setRecoveryDeviceState(ON, drogueChute);
-    flightData.drogueEjectionAltitude = altitude;
-    DataLogger::sharedLogger().logDataPoint(dp, false);
-  } else if (flightState == kDescending &&
-             altitude < FLIGHT_END_THRESHOLD_ALT) {
-    flightState = kOnGround;
-    DataLogger::log(F("Landed"));
-    lastApogee = flightData.apogee;
-
-    DataLogger::log(flightData.toString(flightCount));
-    DataLogger::sharedLogger().endDataRecording(flightData, flightCount);
-    server.bindFlight(flightCount);
-
-    DataLogger::log(F("Resetting Pyro"));
-    resetRecoveryDeviceIfRequired(drogueChute);
-    resetRecoveryDeviceIfRequired(mainChute);
-    DataLogger::log(F("Relays Reset"));
-    enableBuzzer = true;
+    altimeter.setProfile(kCoastProfile);
+    EventLog::shared().record(kEventBurnout, altitude);
   }
 
   // Main chute deployment at kDeployment Altitude
-  if ((flightState == kDescending) && !mainChute->deployed &&
-      altitude < deploymentAltitude) {
-    // If we're descening and we're below our deployment altitude, deploy the
-    // chute!
-    flightData.ejectionAltitude = altitude;
-    DataLogger::log(F("Deploy Main"));
-    setRecoveryDeviceState(ON, mainChute);
-  }
-
-  // Safety measure in case we don't switch to the onGround state.  This will
-  // disable the igniter relay after 5 seconds to avoid draining or damaging the
-  // battery
-  checkChuteIgnitionTimeout(mainChute, MAX_FIRE_TIME);
-  checkChuteIgnitionTimeout(drogueChute, MAX_FIRE_TIME);
+  if (flightState == kDescending && !mainChute->deployed &&
+      !deployments.isScheduled(mainChute)) {
+    // The test flight data has no sensor lag
+    long lag  = testFlightTimeStep ? 0 : altimeter.lag() / 1000;
+    long wait = deploymentPlanner.plan(mainChute->type, deploymentAltitude,
+                                       altitude, baroLockout.velocity(), lag);
+    if (wait != kPlanNotYet && deployments.fire(mainChute, wait)) {
+      flightData.ejectionAltitude = deploymentPlanner.getFiringAltitude();
+      if (mainBackup) {
+        deployments.fire(mainBackup, wait + BACKUP_DELAY_MS);
+      }
+    }
+  }
 }
 
 void FlightController::resetRecoveryDeviceIfRequired(RecoveryDevice *c)
@@ -430,28 +636,19 @@ void FlightController::resetRecoveryDeviceIfRequired(RecoveryDevice *c)
   }
 }
 
-void FlightController::checkChuteIgnitionTimeout(RecoveryDevice *c,
-                                                 int maxIgnitionTime)
-{
-  if (!c->timedReset && c->deployed &&
-      millis() - c->deploymentTime > maxIgnitionTime && c->type == kPyro) {
-    setRecoveryDeviceState(OFF, c);
-    c->timedReset = true;
-  }
-}
-
 void FlightController::setRecoveryDeviceState(RecoveryDeviceState deviceState,
                                               RecoveryDevice *c)
 {
   if (deviceState == c->deviceState) return;
-  int chuteId = c->id;
 
   switch (deviceState) {
     case ON:
       c->enable();
+      EventLog::shared().record(kEventDeploy, sensorData.altitude, c->id);
       break;
     case OFF:
       c->disable();
+      EventLog::shared().record(kEventDeployOff, sensorData.altitude, c->id);
       break;
   }
 }
@@ -463,6 +660,8 @@ void FlightController::testFlightData(SensorData *d)
     fakeData.altitude     = 0;
     fakeData.acceleration = 0;
     d->altitude           = fakeData.altitude;
+    d->rawAltitude        = fakeData.altitude;
+    d->newBaroSample      = true;
     d->acceleration       = fakeData.acceleration;
     isTestAscending       = true;
     return;
@@ -472,11 +671,13 @@ void FlightController::testFlightData(SensorData *d)
     isTestAscending = false;
   }
 
-  double increment = isTestAscending ? 5.0 : -2.0;
+  real_t increment = isTestAscending ? 5.0 : -2.0;
   fakeData.altitude += increment;
 
   testFlightTimeStep++;
 
-  d->altitude     = fakeData.altitude;
-  d->acceleration = fakeData.acceleration;
+  d->altitude      = fakeData.altitude;
+  d->rawAltitude   = fakeData.altitude;
+  d->newBaroSample = true;
+  d->acceleration  = fakeData.acceleration;
 }
@@ -30,12 +30,18 @@
 
 #include <Arduino.h>
 
+#include <AltimeterCore.h>
+#include <Blinker.hpp>
+#include <RecoveryDevice.h>
 #include <Ticker.h>
-#include "IO/Blinker.hpp"
-#include "RecoveryDevice.h"
+#include <TickerTimerSource.hpp>
 #include "Sensor/Altimeter.hpp"
+#include "Sensor/BaroLockout.hpp"
 #include "Sensor/Imu.hpp"
 #include "AttitudeControl.hpp"
+#include "DeploymentPlanner.hpp"
+#include "DeploymentScheduler.hpp"
+#include "LaunchDetector.hpp"
 #include "WebServer.hpp"
 
 #include "../Configuration.h"
@@ -75,7 +81,12 @@ class FlightController
   void runTest();
   void resetAll();
 
-  bool sampleOnNextLoop = false;
+  volatile bool sampleOnNextLoop = false;
+
+  // Sensor reads that came due while the web server had the loop, and ones
+  // that came due before the last had been handled
+  volatile uint32_t samplesDeferred = 0;
+  volatile uint32_t samplesMissed   = 0;
 
   RecoveryDevice *getRecoveryDevice(int channel);
 
@@ -91,13 +102,19 @@ class FlightController
 
   Altimeter altimeter;
   Imu imu;
+  LaunchDetector launchDetector;
+  BaroLockout baroLockout;
 
   int lastApogee        = 0;
   bool refreshInterface = false;
 
   RecoveryDevice *mainChute;
   RecoveryDevice *drogueChute;
-  AttitudeControl *attitudeControl;
+  RecoveryDevice *mainBackup   = nullptr;
+  RecoveryDevice *drogueBackup = nullptr;
+  DeploymentScheduler deployments;
+  DeploymentPlanner deploymentPlanner;
+  AttitudeControl *attitudeControl = nullptr;
 
   int flightCount        = 0;      // The number of flights recorded in EEPROM
   int resetTime          = 0;      // millis() after starting the current flight
@@ -106,7 +123,8 @@ class FlightController
   bool mpuReady          = false;  // True if the barometer/altimeter is ready
   bool barometerReady    = false;  // True if the barometer/altimeter is ready
 
-  Blinker *blinker;
+  Blinker<TickerTimerSource, BoardConfig::MessagePin, BoardConfig::BuzzerPin>
+      *blinker;
   Ticker sensorTicker;
 
   int logCounterUI     = 0;
@@ -118,15 +136,34 @@ class FlightController
   StatusData statusData;
 
   SensorData fakeData;
-  double testApogee = 400;
+  real_t testApogee = 400;
   bool isTestAscending;
   void failsafeCheck();
   bool checkResetPin();
   void blinkLastAltitude();
 
   void flightControl();
+  void drainEvents(int maxEvents);
+
+  // The control tick the flight state guards and actions are looking at
+  long tickTime           = 0;
+  real_t tickAltitude     = 0;
+  real_t tickAcceleration = 0;
+
+  typedef FlightPhases<FlightState, FlightController, FlightController> Phases;
+  friend Phases;
+  static const FlightStateMachine<FlightState, FlightController>
+      kFlightStates;
+
+  static bool isLaunched(FlightController &c);
+  static void onLaunch(FlightController &c);
+  static bool isPastApogee(FlightController &c);
+  static void onApogee(FlightController &c);
+  static bool isLanded(FlightController &c);
+  static void onLanding(FlightController &c);
+  static void stampTransition(FlightController &c, FlightState from,
+                              FlightState to);
 
-  void checkChuteIgnitionTimeout(RecoveryDevice *c, int maxIgnitionTime);
   void setRecoveryDeviceState(RecoveryDeviceState deviceState,
                               RecoveryDevice *c);
   void resetRecoveryDeviceIfRequired(RecoveryDevice *c);
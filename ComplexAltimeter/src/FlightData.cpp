@@ -28,21 +28,23 @@
 
 const bool FlightData::isValid()
 {
-  return apogee || ejectionAltitude || drogueEjectionAltitude ||
-         maxAcceleration || burnoutAltitude;
+  return apogee != 0 || ejectionAltitude != 0 || drogueEjectionAltitude != 0 ||
+         maxAcceleration != 0 || burnoutAltitude != 0;
 }
 
 const String FlightData::toString(int index)
 {
   return String("index : " + String(index) + "," +
-                "apogee:" + String(apogee) + "," +
-                "main_alt : " + String(ejectionAltitude) + "," +
-                "drogue_alt : " + String(drogueEjectionAltitude) + "," +
-                "max_acc : " + String(maxAcceleration) + "," +
+                "apogee:" + String(toFloat(apogee)) + "," +
+                "main_alt : " + String(toFloat(ejectionAltitude)) + "," +
+                "drogue_alt : " + String(toFloat(drogueEjectionAltitude)) +
+                "," +
+                "max_acc : " + String(toFloat(maxAcceleration)) + "," +
                 "apogee_time : " + String(apogeeTime) + "," +
-                "burnout_alt : " + String(burnoutAltitude) + "," +
+                "burnout_alt : " + String(toFloat(burnoutAltitude)) + "," +
                 "burnout_time : " + String(burnoutTime) + "," +
                 "acc_trigger_time :" + String(accTriggerTime) + "," +
+                "vel_trigger_time : " + String(velTriggerTime) + "," +
                 "alt_trigger_time :  " + String(altTriggerTime));
 }
 
@@ -54,6 +56,7 @@ void FlightData::reset()
   maxAcceleration        = 0;
   burnoutAltitude        = 0;
   accTriggerTime         = 0;
+  velTriggerTime         = 0;
   altTriggerTime         = 0;
   apogeeTime             = 0;
   burnoutTime            = 0;
@@ -28,18 +28,20 @@
 #define flightdata_h
 
 #include <Arduino.h>
+#include <AltimeterCore.h>
 
 class FlightData
 {
  public:
-  double apogee                 = 0;
-  double ejectionAltitude       = 0;
-  double drogueEjectionAltitude = 0;
-  double maxAcceleration        = 0;
-  double burnoutAltitude        = 0;
+  real_t apogee                 = 0;
+  real_t ejectionAltitude       = 0;
+  real_t drogueEjectionAltitude = 0;
+  real_t maxAcceleration        = 0;
+  real_t burnoutAltitude        = 0;
 
   int apogeeTime     = 0;
   int accTriggerTime = 0;
+  int velTriggerTime = 0;
   int altTriggerTime = 0;
   int burnoutTime    = 0;
 
@@ -0,0 +1,86 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "HttpRange.hpp"
+
+// Reads a decimal number.  Returns false if there are no digits or it
+// overflows.
+static bool parseNumber(const char **p, size_t *value)
+{
+  const char *s = *p;
+  size_t v      = 0;
+  while (*s >= '0' && *s <= '9') {
+    size_t next = v * 10 + (*s - '0');
+    if (next / 10 != v) {
+      return false;
+    }
+    v = next;
+    s++;
+  }
+  if (s == *p) {
+    return false;
+  }
+  *p     = s;
+  *value = v;
+  return true;
+}
+
+RangeResult parseByteRange(const char *header, size_t size, size_t *first,
+                           size_t *last)
+{
+  const char *p = header;
+  if (!p || strncmp(p, "bytes=", 6)) {
+    return kRangeNone;
+  }
+  p += 6;
+
+  size_t a, b;
+  bool hasFirst = parseNumber(&p, &a);
+  if (*p++ != '-') {
+    return kRangeNone;
+  }
+  bool hasLast = parseNumber(&p, &b);
+  if (*p != 0 || (!hasFirst && !hasLast) || (hasFirst && hasLast && b < a)) {
+    return kRangeNone;
+  }
+
+  if (!hasFirst) {
+    // The last b bytes
+    if (b == 0 || size == 0) {
+      return kRangeUnsatisfiable;
+    }
+    *first = b < size ? size - b : 0;
+    *last  = size - 1;
+    return kRangeSatisfiable;
+  }
+
+  if (a >= size) {
+    return kRangeUnsatisfiable;
+  }
+  *first = a;
+  *last  = (hasLast && b < size) ? b : size - 1;
+  return kRangeSatisfiable;
+}
@@ -0,0 +1,46 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef httprange_h
+#define httprange_h
+
+#include <Arduino.h>
+
+// Byte range support for file downloads so interrupted transfers can resume.
+
+typedef enum {
+  kRangeNone,           // No range, or one we don't support.  Send it all.
+  kRangeSatisfiable,    // Send bytes first to last inclusive as a 206
+  kRangeUnsatisfiable,  // Send a 416
+} RangeResult;
+
+// Parses a Range header of the form "bytes=first-last", "bytes=first-" or
+// "bytes=-suffix" against a resource of |size| bytes.  Lists of ranges are
+// ignored, which the spec allows.
+RangeResult parseByteRange(const char *header, size_t size, size_t *first,
+                           size_t *last);
+
+#endif
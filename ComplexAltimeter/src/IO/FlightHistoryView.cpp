@@ -41,8 +41,14 @@ void FlightHistoryView::refresh()
   } 
 }
 
-void FlightHistoryView::setHistoryInfo(String info)
+void FlightHistoryView::setHistoryInfo(const String &info)
 {
-  setText(info, 0, false);
+  // One history entry per line.  setText stops copying at the newline.
+  const char *text = info.c_str();
+  for (int i = 0; i < kMaxLines; i++) {
+    setText(text, i, false);
+    const char *next = strchr(text, '\n');
+    text             = next ? next + 1 : "";
+  }
   update();
 }
\ No newline at end of file
@@ -35,7 +35,7 @@ class FlightHistoryView : public View
  public:
   FlightHistoryView(Display &displayRef) : View(displayRef){};
 
-  void setHistoryInfo(String info);
+  void setHistoryInfo(const String &info);
 
   void refresh();
   void dismiss();
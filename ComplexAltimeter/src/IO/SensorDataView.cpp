@@ -44,11 +44,18 @@ void SensorDataView::refresh()
 
 void SensorDataView::setData(SensorData &data)
 {
-  setText(data.toString(), 0,
-          false);  // acceleration, vertical velocity and altitude
-  setText(data.heading.toString(), 1, false);   // roll pitch yaw
-  setText(data.acc_vec.toString(), 2, false);   // raw accelerometer values
-  setText(data.gyro_vec.toString(), 3, false);  // raw gyro values
+  // altitude, acceleration and vertical velocity
+  setTextf(0, "A:%.1f C:%.1f V:%.1f", toFloat(data.altitude),
+           toFloat(data.acceleration), toFloat(data.verticalVelocity));
+  // roll pitch yaw
+  setTextf(1, "%.2f:%.2f:%.2f", data.heading.roll, data.heading.pitch,
+           data.heading.yaw);
+  // raw accelerometer values
+  setTextf(2, "%.2f:%.2f:%.2f", data.acc_vec.XAxis, data.acc_vec.YAxis,
+           data.acc_vec.ZAxis);
+  // raw gyro values
+  setTextf(3, "%.2f:%.2f:%.2f", data.gyro_vec.XAxis, data.gyro_vec.YAxis,
+           data.gyro_vec.ZAxis);
   update();
 }
 
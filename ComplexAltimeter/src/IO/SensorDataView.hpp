@@ -33,7 +33,8 @@
 class SensorDataView : public View
 {
  public:
-  SensorDataView(Display &displayRef) : View(displayRef){};
+  // Live telemetry is the only view that changes continuously
+  SensorDataView(Display &displayRef) : View(displayRef) { targetFps = 5; };
 
   void setData(SensorData &data);
   void setWaiting();
@@ -36,23 +36,18 @@ void SettingsView::dismiss()
 void SettingsView::refresh()
 {
   if (needsRefresh) {
-    String deplAlt =
-        String(String(F("Main:")) +
-               String(FlightController::shared().deploymentAltitude));
     setText(F("==::: Settings :::=="), 0, false);
-    setText(deplAlt, 1, false);
-    String resetText =
-        resetOnNextLongPress ? F("Press Again To Reset") : F("Hold To Reset");
-    setText(resetText, 2, false);
+    setTextf(1, "Main:%d", FlightController::shared().deploymentAltitude);
+    setText(resetOnNextLongPress ? F("Press Again To Reset")
+                                 : F("Hold To Reset"),
+            2, false);
 
     FSInfo fs_info;
     SPIFFS.info(fs_info);
 
     setText("", 3, false);
-    setText(String("FS Size Kb: ") + String(fs_info.totalBytes / 1024), 4,
-            false);
-    setText(String("FS Used Kb: ") + String(fs_info.usedBytes / 1024), 5,
-            false);
+    setTextf(4, "FS Size Kb: %u", (unsigned)(fs_info.totalBytes / 1024));
+    setTextf(5, "FS Used Kb: %u", (unsigned)(fs_info.usedBytes / 1024));
     update();
     needsRefresh = false;
   }
@@ -47,17 +47,12 @@ void StatusView::setInfo(StatusData const &data)
 
     setText(F("==:::: Status ::::=="), 0, false);
     setText(flightStateString(data.status), 1, false);
-    String sensorStatus =
-        (data.baroReady ? String(F("Baro OK")) : String(F("Baro Fail"))) +
-        String(F(":")) +
-        (data.mpuReady ? String(F("IMU OK")) : String(F("IMU Fail")));
-    setText(sensorStatus, 2, false);
-    setText((String("Depl:") + String(data.deploymentAlt) + String("m")), 3,
-            false);
-    setText(
-        (String("Pressure:") + String(data.referencePressure) + String("kPa")),
-        4, false);
-    setText(WiFi.localIP().toString(), 5, false);
+    setTextf(2, "Baro %s:IMU %s", data.baroReady ? "OK" : "Fail",
+             data.mpuReady ? "OK" : "Fail");
+    setTextf(3, "Depl:%dm", data.deploymentAlt);
+    setTextf(4, "Pressure:%.2fkPa", data.referencePressure);
+    IPAddress ip = WiFi.localIP();
+    setTextf(5, "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
     update();
     needsRefresh = false;
   }
@@ -67,13 +67,11 @@ void TestView::refresh()
   setText(F("===::: TEST :::==="), 0, false);
 
   for (int i = 1; i < 5; i++) {
-    String label;
     if (i == activeOption) {
-      label = String("::Test Chan ") + String(i) + String("::");
+      setTextf(i, "::Test Chan %d::", i);
     } else {
-      label = String("  Test Chan ") + String(i);
+      setTextf(i, "  Test Chan %d", i);
     }
-    setText(label, i, false);
   }
   needsRefresh = false;
   update();
@@ -27,7 +27,7 @@
 #ifndef TESTVIEW_H
 #define TESTVIEW_H
 
-#include "../RecoveryDevice.h"
+#include <RecoveryDevice.h>
 #include "../types.h"
 #include "View.hpp"
 
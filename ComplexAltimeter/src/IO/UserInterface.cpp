@@ -27,15 +27,71 @@
 #include "UserInterface.h"
 #include "View.hpp"
 
-void UserInterface::eventLoop(bool dispDirty)
+void UserInterface::eventLoop(bool dispDirty, bool inFlight,
+                              bool controlTickPending)
 {
   long t = millis();
   primaryButton.update(t);
   secondaryButton.update(t);
-  if (dispDirty) {
-    View *view = views[activeViewIndex];
-    view->refresh();
+  updateStats(t);
+
+  if (!dispDirty) {
+    return;
+  }
+
+  View *view = views[activeViewIndex];
+  if (!frameDue(view, t, inFlight)) {
+    return;
+  }
+
+  // Sensor sampling always takes priority over the display
+  if (controlTickPending) {
+    skippedFrameCount++;
+    return;
+  }
+
+  lastFrameTime      = t;
+  unsigned long sent = view->framesPushed;
+  view->refresh();
+  if (view->framesPushed != sent) {
+    busCredit -= kDisplayFrameBytes;
+    framesInWindow++;
+  }
+}
+
+bool UserInterface::frameDue(View *view, unsigned long t, bool inFlight)
+{
+  int fps    = view->targetFps;
+  int budget = inFlight ? UI_I2C_BUDGET_FLYING : UI_I2C_BUDGET_GROUND;
+
+  // Top up the i2c budget.  ~9 bits per byte on the wire.  We don't let it
+  // bank more than a couple of frames worth.  A minute fills that at any
+  // budget over 1%, and keeps the product inside a long however long we've
+  // been idle.
+  long bytesPerSecond   = (long)(I2C_BUS_SPEED / 9) * budget / 100;
+  unsigned long elapsed = MIN(t - lastCreditTime, 60000UL);
+  busCredit += (long)elapsed * bytesPerSecond / 1000;
+  busCredit      = MIN(busCredit, 2 * kDisplayFrameBytes);
+  lastCreditTime = t;
+
+  if (fps <= 0 || t - lastFrameTime < 1000 / fps) {
+    return false;
+  }
+  return busCredit >= kDisplayFrameBytes;
+}
+
+void UserInterface::updateStats(unsigned long t)
+{
+  unsigned long elapsed = t - statsWindowStart;
+  if (elapsed < 1000) {
+    return;
   }
+  double busBytesPerSecond = I2C_BUS_SPEED / 9.0;
+  achievedFps              = framesInWindow * 1000.0 / elapsed;
+  achievedBusUtilisation =
+      100.0 * achievedFps * kDisplayFrameBytes / busBytesPerSecond;
+  framesInWindow   = 0;
+  statsWindowStart = t;
 }
 
 void UserInterface::addView(View *view, bool show)
@@ -64,10 +120,10 @@ void UserInterface::previousView()
 void UserInterface::setActiveView(int index)
 {
   View *lastView   = views[activeViewIndex];
-  lastView->active = false;
-  activeViewIndex  = index;
-  View *view       = views[index];
-  view->active     = true;
+  lastView->setActive(false);
+  activeViewIndex = index;
+  View *view      = views[index];
+  view->setActive(true);
   view->refresh();
   view->update();
   lastView->dismiss();
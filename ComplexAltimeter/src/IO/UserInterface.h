@@ -52,6 +52,10 @@ typedef Adafruit_SH1106 Display;
 
 #define kMaxViews 8
 
+// Bytes on the i2c bus for one SH1106 display() including addressing and
+// page/column commands.
+#define kDisplayFrameBytes 1233
+
 class UserInterface : public ButtonInputDelegate
 {
  public:
@@ -103,7 +107,14 @@ class UserInterface : public ButtonInputDelegate
   void previousView();
   void setActiveView(int index);
 
-  void eventLoop(bool dispDirty);
+  // Services the buttons and, if dispDirty is set, refreshes the active view
+  // subject to its frame rate and the i2c budget for the current flight mode.
+  // Frames are skipped outright if a control tick is pending.
+  void eventLoop(bool dispDirty, bool inFlight, bool controlTickPending);
+
+  double framesPerSecond() { return achievedFps; }
+  double busUtilisation() { return achievedBusUtilisation; }  // % of the bus
+  unsigned long skippedFrames() { return skippedFrameCount; }
 
  private:
   Display display;
@@ -119,6 +130,19 @@ class UserInterface : public ButtonInputDelegate
   View *views[kMaxViews];
   short activeViewIndex = 0;
   short viewCount       = 0;
+
+  unsigned long lastFrameTime  = 0;
+  unsigned long lastCreditTime = 0;
+  long busCredit               = 0;  // i2c bytes we're allowed to use
+
+  unsigned long statsWindowStart  = 0;
+  int framesInWindow              = 0;
+  double achievedFps              = 0;
+  double achievedBusUtilisation   = 0;
+  unsigned long skippedFrameCount = 0;
+
+  bool frameDue(View *view, unsigned long time, bool inFlight);
+  void updateStats(unsigned long time);
 };
 
 #endif
\ No newline at end of file
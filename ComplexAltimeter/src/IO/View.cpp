@@ -27,37 +27,101 @@
 #include "View.hpp"
 #include "../DataLogger.hpp"
 
-void View::setText(String text, int line, boolean updateDisplay)
+void View::setLine(const char *text, int line)
+{
+  // Compare as we copy so we only redraw the lines that actually changed
+  char *dest   = lines[line];
+  bool changed = false;
+  int i        = 0;
+  for (; i < kMaxLineLength && text[i] && text[i] != '\n'; i++) {
+    if (dest[i] != text[i]) {
+      dest[i] = text[i];
+      changed = true;
+    }
+  }
+  if (dest[i] != 0) {
+    dest[i] = 0;
+    changed = true;
+  }
+  if (changed) {
+    dirtyLines |= (1 << line);
+  }
+}
+
+void View::setText(const char *text, int line, boolean updateDisplay)
 {
   if (line >= kMaxLines) {
     return;
   }
-  lines[line] = text;
+  setLine(text, line);
   if (updateDisplay) {
     this->update();
   }
 }
 
+void View::setText(const __FlashStringHelper *text, int line,
+                   boolean updateDisplay)
+{
+  char buffer[kMaxLineLength + 1];
+  strncpy_P(buffer, (const char *)text, kMaxLineLength);
+  buffer[kMaxLineLength] = 0;
+  setText(buffer, line, updateDisplay);
+}
+
+void View::setTextf(int line, const char *format, ...)
+{
+  if (line >= kMaxLines) {
+    return;
+  }
+  char buffer[kMaxLineLength + 1];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  setLine(buffer, line);
+}
+
 void View::clear()
 {
   for (int i = 0; i < kMaxLines; i++) {
-    lines[i] = F("");
+    setLine("", i);
   }
   update();
 }
 
+void View::setActive(bool active)
+{
+  this->active = active;
+  if (active) {
+    redrawAll = true;
+  }
+}
+
 void View::update()
 {
   if (!active) {
     return;
   }
 
-  display.clearDisplay();
-  display.setCursor(0, 0);
+  if (redrawAll) {
+    display.clearDisplay();
+    dirtyLines = 0xFF;
+    redrawAll  = false;
+  }
+
+  if (!dirtyLines) {
+    return;
+  }
+
   for (int i = 0; i < kMaxLines; i++) {
-    if (lines[i].length() > 0) {
-      display.println(lines[i].c_str());
+    if (dirtyLines & (1 << i)) {
+      int y = i * kLineHeight;
+      display.fillRect(0, y, display.width(), kLineHeight, BLACK);
+      display.setCursor(0, y);
+      display.print(lines[i]);
     }
   }
+  dirtyLines = 0;
   display.display();
+  framesPushed++;
 }
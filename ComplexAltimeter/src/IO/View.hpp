@@ -27,7 +27,10 @@
 #ifndef OLEDVIEW_H
 #define OLEDVIEW_H
 
-#define kMaxLines 6
+// The 128x64 display fits 8 lines of 21 characters in the default 6x8 font
+#define kMaxLines 8
+#define kMaxLineLength 21
+#define kLineHeight 8
 
 #include <Arduino.h>
 #include "../../Configuration.h"
@@ -45,13 +48,24 @@ typedef Adafruit_SH1106 Display;
 class View
 {
  public:
-  View(Display &displayRef) : display(displayRef){};
+  View(Display &displayRef) : display(displayRef)
+  {
+    memset(lines, 0, sizeof(lines));
+  };
   ~View(){};
 
-  void setText(String text, int line, boolean update);
+  // Copies text into the line buffer.  Text is truncated at kMaxLineLength or
+  // at the first newline.  Lines are only redrawn if their contents change.
+  void setText(const char *text, int line, boolean update);
+  void setText(const __FlashStringHelper *text, int line, boolean update);
+  // printf style formatting directly into the line buffer
+  void setTextf(int line, const char *format, ...);
   void clear();
   void update();
 
+  // Activating a view forces a full redraw on the next update()
+  void setActive(bool active);
+
   virtual void refresh()          = 0;
   virtual void dismiss()          = 0;
   virtual void longPressAction()  = 0;
@@ -61,9 +75,22 @@ class View
 
   bool active = false;
 
+  // Maximum refresh rate for this view.  The UserInterface may refresh it
+  // less often than this to stay within the i2c budget.
+  uint8_t targetFps = 4;
+
+  // Number of frames actually pushed to the display
+  unsigned long framesPushed = 0;
+
  protected:
-  String lines[kMaxLines];
+  char lines[kMaxLines][kMaxLineLength + 1];
   bool needsRefresh = true;
+
+ private:
+  uint8_t dirtyLines = 0;  // Bitmask of lines changed since the last update
+  bool redrawAll     = true;
+
+  void setLine(const char *text, int line);
 };
 
 #endif
\ No newline at end of file
@@ -70,6 +70,9 @@ POSSIBILITY OF SUCH DAMAGE.
 #define _swap_int16_t(a, b) { int16_t t = a; a = b; b = t; }
 #endif
 
+// Widest custom font glyph handled by the drawChar() column fast path
+#define kMaxGlyphColumns 16
+
 /**************************************************************************/
 /*!
    @brief    Instatiate a GFX context for graphics! Can only be done by a superclass
@@ -1037,6 +1040,19 @@ void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
 
         if(!_cp437 && (c >= 176)) c++; // Handle 'classic' charset behavior
 
+        // Fast path: whole 8px columns straight into the framebuffer
+        bool opaque = (bg != color);
+        if((size == 1) && (rotation == 0) &&
+           writeGlyphColumn(x, y, pgm_read_byte(&font[c * 5]), 8,
+             color, bg, opaque)) {
+            for(int8_t i=1; i<5; i++) {
+                writeGlyphColumn(x+i, y, pgm_read_byte(&font[c * 5 + i]), 8,
+                  color, bg, opaque);
+            }
+            if(opaque) writeGlyphColumn(x+5, y, 0, 8, color, bg, true);
+            return;
+        }
+
         startWrite();
         for(int8_t i=0; i<5; i++ ) { // Char bitmap = 5 columns
             uint8_t line = pgm_read_byte(&font[c * 5 + i]);
@@ -1085,6 +1101,37 @@ void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
 
         // Todo: Add character clipping here
 
+        // Fast path: transpose the row-major glyph bitmap into columns and
+        // write each column straight into the framebuffer.
+        if((size == 1) && (rotation == 0) &&
+           (w <= kMaxGlyphColumns) && (h <= 32)) {
+            uint32_t columns[kMaxGlyphColumns];
+            memset(columns, 0, sizeof(columns));
+            for(yy=0; yy<h; yy++) {
+                for(xx=0; xx<w; xx++) {
+                    if(!(bit++ & 7)) {
+                        bits = pgm_read_byte(&bitmap[bo++]);
+                    }
+                    if(bits & 0x80) {
+                        columns[xx] |= (1UL << yy);
+                    }
+                    bits <<= 1;
+                }
+            }
+            if(w == 0 ||
+               writeGlyphColumn(x+xo, y+yo, columns[0], h, color, color,
+                 false)) {
+                for(xx=1; xx<w; xx++) {
+                    writeGlyphColumn(x+xo+xx, y+yo, columns[xx], h, color,
+                      color, false);
+                }
+                return;
+            }
+            // Not supported by this display.  Rewind and draw pixels.
+            bo = pgm_read_word(&glyph->bitmapOffset);
+            bit = 0;
+        }
+
         // NOTE: THERE IS NO 'BACKGROUND' COLOR OPTION ON CUSTOM FONTS.
         // THIS IS ON PURPOSE AND BY DESIGN.  The background color feature
         // has typically been used with the 'classic' font to overwrite old
@@ -1122,6 +1169,50 @@ void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
 
     } // End classic vs custom font
 }
+bool Adafruit_GFX::writeGlyphColumn(int16_t x, int16_t y, uint32_t bits,
+  uint8_t h, uint16_t color, uint16_t bg, bool opaque) {
+    return false;
+}
+
+static inline void applyPageMask(uint8_t *p, uint8_t mask, uint16_t color) {
+    switch(color) {
+        case 0: *p &= ~mask; break; // BLACK
+        case 1: *p |=  mask; break; // WHITE
+        case 2: *p ^=  mask; break; // INVERSE
+    }
+}
+
+void Adafruit_GFX::writePageColumn(uint8_t *buffer, int16_t bufWidth,
+  int16_t bufHeight, int16_t x, int16_t y, uint32_t bits, uint8_t h,
+  uint16_t color, uint16_t bg, bool opaque) {
+    if((x < 0) || (x >= bufWidth) || (h == 0)) return;
+
+    uint32_t cover = (h >= 32) ? 0xFFFFFFFFUL : ((1UL << h) - 1);
+    bits &= cover;
+    if(y < 0) { // Clip top
+        if(-y >= h) return;
+        bits  >>= -y;
+        cover >>= -y;
+        y = 0;
+    }
+
+    // Spread the column over the (at most 5) pages it overlaps
+    int16_t page  = y >> 3;
+    uint8_t shift = y & 7;
+    int16_t pages = bufHeight >> 3;
+    while(cover && (page < pages)) {
+        uint8_t *p   = &buffer[x + page * bufWidth];
+        uint8_t mask = (uint8_t)(cover << shift);
+        uint8_t on   = (uint8_t)(bits << shift) & mask;
+        applyPageMask(p, on, color);
+        if(opaque) applyPageMask(p, mask & ~on, bg);
+        bits  >>= (8 - shift);
+        cover >>= (8 - shift);
+        shift = 0;
+        page++;
+    }
+}
+
 /**************************************************************************/
 /*!
     @brief  Print one byte/character of data, used to support print()
@@ -28,6 +28,12 @@ class Adafruit_GFX : public Print {
   virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
   virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
   virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  // Glyph column fast path used by drawChar().  Writes h pixels of a single
+  // column starting at (x,y), bit 0 of bits being the top pixel.  Returns false
+  // if the display can't take whole columns (in which case drawChar() falls
+  // back to writePixel()).  Only called with rotation 0 and text size 1.
+  virtual bool writeGlyphColumn(int16_t x, int16_t y, uint32_t bits, uint8_t h,
+                                uint16_t color, uint16_t bg, bool opaque);
   virtual void endWrite(void);
 
   // CONTROL API
@@ -126,6 +132,12 @@ class Adafruit_GFX : public Print {
   int16_t getCursorY(void) const;
 
  protected:
+  // Helper for monochrome displays with a page-oriented framebuffer (each
+  // byte is 8 vertical pixels, bit 0 at the top).  color/bg use the common
+  // BLACK=0, WHITE=1, INVERSE=2 convention.
+  static void writePageColumn(uint8_t *buffer, int16_t bufWidth,
+    int16_t bufHeight, int16_t x, int16_t y, uint32_t bits, uint8_t h,
+    uint16_t color, uint16_t bg, bool opaque);
   void
     charBounds(char c, int16_t *x, int16_t *y,
       int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy);
@@ -170,6 +170,16 @@ void Adafruit_SH1106::drawPixel(int16_t x, int16_t y, uint16_t color)
   }
 }
 
+bool Adafruit_SH1106::writeGlyphColumn(int16_t x, int16_t y, uint32_t bits,
+                                       uint8_t h, uint16_t color, uint16_t bg,
+                                       bool opaque)
+{
+  if (getRotation() != 0) return false;
+  writePageColumn(buffer, SH1106_LCDWIDTH, SH1106_LCDHEIGHT, x, y, bits, h,
+                  color, bg, opaque);
+  return true;
+}
+
 Adafruit_SH1106::Adafruit_SH1106(int8_t SID, int8_t SCLK, int8_t DC, int8_t RST,
                                  int8_t CS)
     : Adafruit_GFX(SH1106_LCDWIDTH, SH1106_LCDHEIGHT)
@@ -159,6 +159,8 @@ class Adafruit_SH1106 : public Adafruit_GFX
   void dim(uint8_t contrast);
 
   void drawPixel(int16_t x, int16_t y, uint16_t color);
+  bool writeGlyphColumn(int16_t x, int16_t y, uint32_t bits, uint8_t h,
+                        uint16_t color, uint16_t bg, bool opaque);
 
   virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
   virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
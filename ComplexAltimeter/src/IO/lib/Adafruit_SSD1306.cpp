@@ -616,6 +616,18 @@ void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
   }
 }
 
+/*!
+    @brief  Write a column of glyph pixels straight into the buffer.
+    @return false if the current rotation isn't supported (the caller
+            falls back to drawPixel()).
+*/
+bool Adafruit_SSD1306::writeGlyphColumn(int16_t x, int16_t y, uint32_t bits,
+  uint8_t h, uint16_t color, uint16_t bg, bool opaque) {
+  if(!buffer || getRotation() != 0) return false;
+  writePageColumn(buffer, WIDTH, HEIGHT, x, y, bits, h, color, bg, opaque);
+  return true;
+}
+
 /*!
     @brief  Clear contents of display buffer (set all pixels to off).
     @return None (void).
@@ -138,6 +138,8 @@ class Adafruit_SSD1306 : public Adafruit_GFX {
   void         invertDisplay(boolean i);
   void         dim(boolean dim);
   void         drawPixel(int16_t x, int16_t y, uint16_t color);
+  bool         writeGlyphColumn(int16_t x, int16_t y, uint32_t bits,
+                 uint8_t h, uint16_t color, uint16_t bg, bool opaque);
   virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
   virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
   void         startscrollright(uint8_t start, uint8_t stop);
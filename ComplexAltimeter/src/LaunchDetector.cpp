@@ -0,0 +1,90 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "LaunchDetector.hpp"
+
+// Samples below threshold before a run is over
+#define kRunMaxQuiet 2
+
+void LaunchDetector::Run::update(bool on, long time)
+{
+  if (on) {
+    if (!active) {
+      start  = time;
+      active = true;
+    }
+    quiet = 0;
+  } else if (active && ++quiet > kRunMaxQuiet) {
+    active = false;
+  }
+}
+
+void LaunchDetector::reset()
+{
+  uint8_t window  = config.window < kLaunchMaxWindow ? config.window
+                                                     : kLaunchMaxWindow;
+  windowMask      = (1UL << window) - 1;
+  accBits         = 0;
+  velocityBits    = 0;
+  accRun          = Run();
+  velocityRun     = Run();
+  trigger         = kLaunchNone;
+  firstMotionTime = 0;
+  launchTime      = 0;
+}
+
+bool LaunchDetector::update(long time, real_t acceleration, real_t velocity,
+                            real_t altitude)
+{
+  if (trigger != kLaunchNone) {
+    return false;
+  }
+
+  bool accVote      = acceleration > config.accThreshold;
+  bool velocityVote = velocity > config.velocityThreshold;
+  accBits           = ((accBits << 1) | accVote) & windowMask;
+  velocityBits      = ((velocityBits << 1) | velocityVote) & windowMask;
+  accRun.update(acceleration > config.motionThreshold, time);
+  velocityRun.update(velocity > config.velocityThreshold * real_t(0.5), time);
+
+  if (__builtin_popcount(accBits) >= config.accVotes) {
+    trigger = kLaunchAcc;
+  } else if (__builtin_popcount(velocityBits) >= config.velocityVotes) {
+    trigger = kLaunchVelocity;
+  } else if (altitude > config.altitudeThreshold) {
+    trigger = kLaunchAltitude;
+  } else {
+    return false;
+  }
+
+  // The motor starts before the barometer notices so prefer the IMU's idea
+  // of when motion began
+  launchTime      = time;
+  firstMotionTime = accRun.active        ? accRun.start
+                    : velocityRun.active ? velocityRun.start
+                                         : time;
+  return true;
+}
@@ -0,0 +1,103 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef launchdetector_h
+#define launchdetector_h
+
+#include <Arduino.h>
+#include <AltimeterCore.h>
+
+// Votes on launch over a sliding window of samples rather than trusting any
+// single one.  A bump on the pad gives a sample or two of high acceleration;
+// a motor gives a run of them.
+//
+// Either sensor can confirm a launch on its own so a failed IMU or barometer
+// doesn't stop the flight being recorded:
+//  - accVotes of the last window samples over accThreshold
+//  - velocityVotes of the last window samples over velocityThreshold
+//  - any sample over altitudeThreshold, as a last resort
+//
+// Once confirmed, getFirstMotionTime() is the start of the run of motion
+// that led to the launch so the recording can be back-filled from there.
+
+#define kLaunchMaxWindow 16
+
+typedef enum : uint8_t {
+  kLaunchNone,
+  kLaunchAcc,
+  kLaunchVelocity,
+  kLaunchAltitude
+} LaunchTrigger;
+
+typedef struct {
+  uint8_t window;            // Samples voted over, at most kLaunchMaxWindow
+  uint8_t accVotes;          // Votes needed to launch on acceleration
+  uint8_t velocityVotes;     // Votes needed to launch on velocity
+  real_t accThreshold;       // m/s/s
+  real_t velocityThreshold;  // m/s
+  real_t altitudeThreshold;  // m
+  real_t motionThreshold;    // m/s/s.  A run over this is the first motion.
+} LaunchConfig;
+
+class LaunchDetector
+{
+ public:
+  LaunchDetector(const LaunchConfig &config) : config(config) { reset(); }
+
+  void reset();
+
+  // Adds a sample.  Returns true on the sample that confirms the launch.
+  bool update(long time, real_t acceleration, real_t velocity,
+              real_t altitude);
+
+  LaunchTrigger getTrigger() { return trigger; }
+  long getFirstMotionTime() { return firstMotionTime; }
+  long getLaunchTime() { return launchTime; }
+
+ private:
+  // Tracks the start of a run of samples over a threshold, allowing for a
+  // short dropout within the run
+  struct Run {
+    long start    = 0;
+    uint8_t quiet = 0;
+    bool active   = false;
+
+    void update(bool on, long time);
+  };
+
+  LaunchConfig config;
+  uint16_t windowMask;
+  uint16_t accBits;
+  uint16_t velocityBits;
+  Run accRun;
+  Run velocityRun;
+
+  LaunchTrigger trigger;
+  long firstMotionTime;
+  long launchTime;
+};
+
+#endif
@@ -0,0 +1,231 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "SampleCodec.hpp"
+
+static size_t putVarint(uint8_t *buf, int32_t value)
+{
+  uint32_t v = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+  size_t len = 0;
+  while (v >= 0x80) {
+    buf[len++] = (v & 0x7F) | 0x80;
+    v >>= 7;
+  }
+  buf[len++] = v;
+  return len;
+}
+
+// Returns the number of bytes read or 0 if the varint runs past |end|
+static size_t getVarint(const uint8_t *buf, const uint8_t *end, int32_t *value)
+{
+  uint32_t v    = 0;
+  uint8_t shift = 0;
+  for (const uint8_t *p = buf; p < end && shift < 35; p++, shift += 7) {
+    v |= (uint32_t)(*p & 0x7F) << shift;
+    if (!(*p & 0x80)) {
+      *value = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+      return p - buf + 1;
+    }
+  }
+  return 0;
+}
+
+void SampleBlockEncoder::begin(Print *out)
+{
+  uint8_t offset = 0;
+  for (uint8_t tag = 0; tag < tagCount; tag++) {
+    offsets[tag] = offset;
+    offset += components[tag];
+  }
+
+  this->out      = out;
+  tickCount      = 0;
+  blockCount     = 0;
+  tickFrames     = 0;
+  tickValueCount = 0;
+
+  blockLength = kCodecBlockHeaderSize;
+  blockTicks  = 0;
+  knownTags   = 0;
+}
+
+void SampleBlockEncoder::beginTick(uint32_t time)
+{
+  tickFrames        = 0;
+  tickValueCount    = 0;
+  tickMaxLength     = 0;
+  tickOnlyIfChanged = 0;
+  int32_t t         = time;
+  add(kCodecTimeTag, &t);
+}
+
+bool SampleBlockEncoder::add(uint8_t tag, const int32_t *values,
+                             bool onlyIfChanged)
+{
+  if (tag >= tagCount) {
+    return false;
+  }
+  size_t maxLength = 1 + components[tag] * kCodecMaxVarintSize;
+  if (tickFrames >= kCodecMaxTickFrames ||
+      tickValueCount + components[tag] > kCodecMaxTickValues ||
+      tickMaxLength + maxLength > kCodecBlockSize - kCodecBlockHeaderSize) {
+    return false;
+  }
+  tickMaxLength += maxLength;
+  tickTags[tickFrames] = tag;
+  if (onlyIfChanged) {
+    tickOnlyIfChanged |= 1UL << tickFrames;
+  }
+  memcpy(tickValues + tickValueCount, values,
+         components[tag] * sizeof(int32_t));
+  tickValueCount += components[tag];
+  tickFrames++;
+  return true;
+}
+
+// Encodes the staged tick against |previous|.  With |commit| the block's
+// delta state is updated, otherwise this only measures the tick.
+size_t SampleBlockEncoder::encodeTick(uint8_t *buf, bool commit)
+{
+  int32_t prev[kCodecMaxValues];
+  uint16_t known = knownTags;
+  memcpy(prev, previous, sizeof(prev));
+
+  size_t len           = 0;
+  const int32_t *value = tickValues;
+  for (uint8_t f = 0; f < tickFrames; f++) {
+    uint8_t tag  = tickTags[f];
+    uint8_t n    = components[tag];
+    int32_t *p   = prev + offsets[tag];
+    bool isKnown = known & (1 << tag);
+
+    if (!(isKnown && (tickOnlyIfChanged & (1UL << f)) &&
+          !memcmp(value, p, n * sizeof(int32_t)))) {
+      buf[len++] = tag;
+      for (uint8_t i = 0; i < n; i++) {
+        // Modular so values that wrap, like micros(), take a small delta
+        uint32_t delta = (uint32_t)value[i] - (isKnown ? (uint32_t)p[i] : 0);
+        len += putVarint(buf + len, (int32_t)delta);
+      }
+      memcpy(p, value, n * sizeof(int32_t));
+      known |= 1 << tag;
+    }
+    value += n;
+  }
+
+  if (commit) {
+    memcpy(previous, prev, sizeof(prev));
+    knownTags = known;
+  }
+  return len;
+}
+
+void SampleBlockEncoder::endTick()
+{
+  uint8_t encoded[kCodecBlockSize];
+  size_t len = encodeTick(encoded, false);
+  if (blockLength + len > kCodecBlockSize) {
+    writeBlock();
+  }
+  len = encodeTick(block + blockLength, true);
+  blockLength += len;
+  blockTicks++;
+  tickCount++;
+  tickFrames     = 0;
+  tickValueCount = 0;
+}
+
+void SampleBlockEncoder::finish()
+{
+  if (blockTicks) {
+    writeBlock();
+  }
+}
+
+void SampleBlockEncoder::writeBlock()
+{
+  block[0] = kCodecBlockMagic;
+  block[1] = 0;
+  block[2] = blockTicks & 0xFF;
+  block[3] = blockTicks >> 8;
+  memset(block + blockLength, 0, kCodecBlockSize - blockLength);
+  if (out) {
+    out->write(block, kCodecBlockSize);
+  }
+  blockCount++;
+
+  blockLength = kCodecBlockHeaderSize;
+  blockTicks  = 0;
+  knownTags   = 0;
+}
+
+int SampleBlockDecoder::decodeBlock(const uint8_t *block,
+                                    const uint8_t *components,
+                                    uint8_t tagCount, FrameCallback callback)
+{
+  if (block[0] != kCodecBlockMagic || tagCount > kCodecMaxTags) {
+    return -1;
+  }
+
+  uint8_t offsets[kCodecMaxTags];
+  uint8_t offset = 0;
+  for (uint8_t tag = 0; tag < tagCount; tag++) {
+    offsets[tag] = offset;
+    offset += components[tag];
+  }
+  if (offset > kCodecMaxValues) {
+    return -1;
+  }
+
+  uint16_t ticks     = block[2] | (block[3] << 8);
+  const uint8_t *p   = block + kCodecBlockHeaderSize;
+  const uint8_t *end = block + kCodecBlockSize;
+  int32_t previous[kCodecMaxValues] = {0};
+  uint16_t tick = 0;
+
+  while (p < end) {
+    uint8_t tag = *p;
+    if (tag == kCodecTimeTag && tick++ == ticks) {
+      break;  // Into the padding
+    }
+    if (tag >= tagCount) {
+      return -1;
+    }
+    p++;
+    int32_t *values = previous + offsets[tag];
+    for (uint8_t i = 0; i < components[tag]; i++) {
+      int32_t delta;
+      size_t len = getVarint(p, end, &delta);
+      if (!len) {
+        return -1;
+      }
+      values[i] = (int32_t)((uint32_t)values[i] + (uint32_t)delta);
+      p += len;
+    }
+    callback(tag, values, components[tag]);
+  }
+  return ticks;
+}
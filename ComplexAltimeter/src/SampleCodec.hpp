@@ -0,0 +1,133 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef samplecodec_h
+#define samplecodec_h
+
+#include <Arduino.h>
+#include <functional>
+
+// Compressed sample storage for the flight logs.
+//
+// A stream is a sequence of ticks.  Each tick is a time frame (tag 0)
+// followed by a frame for every channel sampled on that tick:
+//
+//   tag, zig-zag varint delta of each of the channel's components
+//
+// Values are integers, already quantised by the caller, and each delta is
+// against the previous frame with the same tag so slowly changing values
+// take a byte per component.  A tag may appear more than once in a tick,
+// which is how bursts of events are stored.  Ticks are packed whole into
+// fixed size blocks:
+//
+//   kCodecBlockMagic, 0, uint16 tick count, frames, zero padding
+//
+// The deltas restart at the top of every block so each block decodes on its
+// own.  Block n of a stream always starts at n*kCodecBlockSize, which gives
+// random access by block.
+
+#define kCodecBlockSize 256
+#define kCodecBlockHeaderSize 4
+#define kCodecBlockMagic 0xB6
+#define kCodecMaxTags 16
+#define kCodecMaxValues 32  // Total components over all the tags
+#define kCodecMaxTickFrames 24
+#define kCodecMaxTickValues 64
+#define kCodecMaxVarintSize 5
+#define kCodecTimeTag 0
+
+typedef std::function<void(uint8_t tag, const int32_t *values, uint8_t count)>
+    FrameCallback;
+
+class SampleBlockEncoder
+{
+ public:
+  // |components| is the number of values for each of |tagCount| tags.  Tag 0
+  // is the time and must have one component.  The components are read in
+  // begin().
+  SampleBlockEncoder(const uint8_t *components, uint8_t tagCount)
+      : components(components), tagCount(tagCount)
+  {
+  }
+
+  // Starts a new stream of blocks written to |out|
+  void begin(Print *out);
+
+  // Stages a tick.  Nothing is encoded until endTick().
+  void beginTick(uint32_t time);
+
+  // Adds a frame to the current tick.  With |onlyIfChanged| the frame is
+  // dropped when it's the same as the last one in the block.  Returns false
+  // if the tick is full.  A tick is limited to what is guaranteed to fit in
+  // an empty block.
+  bool add(uint8_t tag, const int32_t *values, bool onlyIfChanged = false);
+
+  // Encodes the tick, writing out the current block first if it won't fit.
+  void endTick();
+
+  // Writes out the final partial block
+  void finish();
+
+  uint32_t getTickCount() { return tickCount; }
+  uint32_t getBlockCount() { return blockCount; }
+
+ private:
+  const uint8_t *components;
+  uint8_t tagCount;
+  uint8_t offsets[kCodecMaxTags];
+  Print *out = nullptr;
+
+  uint8_t block[kCodecBlockSize];
+  size_t blockLength  = kCodecBlockHeaderSize;
+  uint16_t blockTicks = 0;
+  int32_t previous[kCodecMaxValues];
+  uint16_t knownTags = 0;  // Tags with a frame in this block
+
+  // The staged tick
+  uint8_t tickTags[kCodecMaxTickFrames];
+  uint32_t tickOnlyIfChanged = 0;
+  int32_t tickValues[kCodecMaxTickValues];
+  uint8_t tickFrames     = 0;
+  uint8_t tickValueCount = 0;
+  size_t tickMaxLength   = 0;  // Worst case encoded size
+
+  uint32_t tickCount  = 0;
+  uint32_t blockCount = 0;
+
+  size_t encodeTick(uint8_t *buf, bool commit);
+  void writeBlock();
+};
+
+class SampleBlockDecoder
+{
+ public:
+  // Decodes one kCodecBlockSize block, calling |callback| for each frame.
+  // Returns the number of ticks or -1 if |block| isn't a valid block.
+  static int decodeBlock(const uint8_t *block, const uint8_t *components,
+                         uint8_t tagCount, FrameCallback callback);
+};
+
+#endif
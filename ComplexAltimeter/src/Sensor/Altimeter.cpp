@@ -28,6 +28,55 @@
 #include "../../Configuration.h"
 #include "../DataLogger.hpp"
 
+constexpr TrackingGains Altimeter::kAltitudeGains;
+
+#if USE_BMP280
+// Normal mode sampling profiles.  The sensor free-runs at
+// 1 / (t_measure + t_standby) where t_measure (ms, max) is
+// 1.25 + 2.3 * osrs_t + 2.3 * osrs_p + 0.575.  The IIR filter needs 2, 5 and 22
+// samples to reach 75% of a step at x2, x4 and x16 so the filter latency is
+// that many sample periods.  RMS noise is per the datasheet with the filter
+// off.
+//
+// At a steady rate of climb or descent the filter output trails the input by
+// (coefficient - 1) sample periods, and the sample itself is on average half a
+// period old.  That's the ramp lag.
+//
+//           osrs_t/p  IIR   standby   rate     noise   75% step   ramp lag
+// Pad Idle  x2/x16    x4    62.5ms    ~9.5Hz   ~5cm    ~530ms     ~370ms
+// Boost     x1/x4     x2    0.5ms     ~72Hz    ~11cm   ~28ms      ~21ms
+// Coast     x1/x4     x4    0.5ms     ~72Hz    ~11cm   ~69ms      ~48ms
+// Descent   x1/x8     x4    0.5ms     ~43Hz    ~8cm    ~115ms     ~81ms
+struct BaroSamplingProfile {
+  Adafruit_BMP280::sensor_sampling tempSampling;
+  Adafruit_BMP280::sensor_sampling pressSampling;
+  Adafruit_BMP280::sensor_filter filter;
+  Adafruit_BMP280::standby_duration standby;
+  unsigned long samplePeriod;  // micros
+  unsigned long rampLag;       // micros
+};
+
+static const BaroSamplingProfile kSamplingProfiles[] = {
+    {Adafruit_BMP280::SAMPLING_X2, Adafruit_BMP280::SAMPLING_X16,
+     Adafruit_BMP280::FILTER_X4, Adafruit_BMP280::STANDBY_MS_63, 105700,
+     370000},
+    {Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::SAMPLING_X4,
+     Adafruit_BMP280::FILTER_X2, Adafruit_BMP280::STANDBY_MS_1, 13800, 20700},
+    {Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::SAMPLING_X4,
+     Adafruit_BMP280::FILTER_X4, Adafruit_BMP280::STANDBY_MS_1, 13800, 48300},
+    {Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::SAMPLING_X8,
+     Adafruit_BMP280::FILTER_X4, Adafruit_BMP280::STANDBY_MS_1, 23000, 80500},
+};
+#endif
+
+#if USE_BMP085
+// The BMP085 has no normal mode or IIR filter.  The oversampling setting
+// (0-3) sets the conversion time to 5, 8, 14 or 26ms.  With no filter the
+// ramp lag is just the sample age, half a conversion.
+static const char kOversampling[] = {3, 1, 1, 2};
+static const unsigned long kRampLag[] = {13000, 4000, 4000, 7000};  // micros
+#endif
+
 bool Altimeter::start()
 {
   #if USE_BMP280
@@ -39,13 +88,14 @@ bool Altimeter::start()
 
   if (ready) {
 #ifdef STATUS_PIN_LEVEL
-    analogWrite(STATUS_PIN, STATUS_PIN_LEVEL);
+    BoardConfig::StatusPin::analog(STATUS_PIN_LEVEL);
 #else
-    digitalWrite(STATUS_PIN, HIGH);
+    BoardConfig::StatusPin::write(HIGH);
 #endif
-    digitalWrite(MESSAGE_PIN, LOW);
+    BoardConfig::MessagePin::write(LOW);
     DataLogger::log(F("Barometer Started"));
     barometerReady = true;
+    setProfile(kPadIdleProfile);
     reset();
   } else {
     // If the unit starts with the status pin off and the message pin on,
@@ -58,49 +108,83 @@ bool Altimeter::start()
 void Altimeter::reset()
 {
   altitudeFilter.reset(0);
-  velocityFilter.reset(0);
 
   baselinePressure = pressure();
   #if USE_BMP280
   refAltitude = barometer.readAltitude(); 
   #endif
-  lastRefreshTime  = 0;
+  lastRefreshTime      = 0;
+  lastRecordedAltitude = 0;
+  lastSampleTime       = 0;
+
+  sampleWindowStart  = 0;
+  samplesInWindow    = 0;
+  achievedSampleRate = 0;
+  maxUpdateTime      = 0;
   DataLogger::log(String(F("Barometer reset: ")) + String(baselinePressure));
 }
 
 double Altimeter::referenceAltitude() { return refAltitude; }
 
-double Altimeter::altitude() { return altitudeFilter.getCurrentValue(); }
+real_t Altimeter::altitude() { return altitudeFilter.getCurrentValue(); }
 
-double Altimeter::verticalVelocity()
-{
-  return velocityFilter.getCurrentValue();
-}
+real_t Altimeter::verticalVelocity() { return altitudeFilter.getRate(); }
 
 void Altimeter::update()
 {
+  unsigned long startTime = micros();
   #if USE_BMP085
-  double p = pressure();
+  // The sampler only produces a new pressure value every few ticks while a
+  // conversion is in progress.  There's nothing to filter until it does.
+  if (!sampler.poll()) {
+    maxUpdateTime = MAX(maxUpdateTime, micros() - startTime);
+    return;
+  }
+  double p = sampler.pressure();
   if (p == 0) {
+    // A failed read still held up the loop
+    maxUpdateTime = MAX(maxUpdateTime, micros() - startTime);
     return;
   }
   double relativeAlt = barometer.altitude(p, baselinePressure);
   #endif
   #if USE_BMP280
+  // Don't waste i2c bandwidth reading the same sample twice.
+  if (lastSampleTime && startTime - lastSampleTime < samplePeriod) {
+    return;
+  }
+  lastSampleTime     = startTime;
   double relativeAlt = barometer.readAltitude() - refAltitude;
   #endif
 
-  double lastAlt = altitudeFilter.getCurrentValue();
+  real_t alt = toReal(relativeAlt);
+  long t     = micros();
+  if (lastRefreshTime) {
+    altitudeFilter.step(alt, secondsFromMicros(t - lastRefreshTime));
+  } else {
+    altitudeFilter.reset(alt);
+  }
+  lastRefreshTime      = t;
+  lastRecordedAltitude = alt;
+
+  recordSample(startTime);
+}
 
-  altitudeFilter.step(relativeAlt);
+void Altimeter::recordSample(unsigned long startTime)
+{
+  unsigned long now = micros();
+  maxUpdateTime     = MAX(maxUpdateTime, now - startTime);
 
-  long t = micros();
-  if (lastRefreshTime) {
-    long dt         = t - lastRefreshTime;
-    double velocity = ((relativeAlt - lastAlt) / dt) * 1000000;
-    velocityFilter.step(velocity);
+  sampleCount++;
+  samplesInWindow++;
+  if (sampleWindowStart == 0) {
+    sampleWindowStart = now;
+  } else if (now - sampleWindowStart >= 1000000) {
+    achievedSampleRate =
+        samplesInWindow * 1000000.0 / (double)(now - sampleWindowStart);
+    samplesInWindow   = 0;
+    sampleWindowStart = now;
   }
-  lastRefreshTime = t;
 }
 
 double Altimeter::pressure()
@@ -109,25 +193,25 @@ double Altimeter::pressure()
   return barometer.readPressure();
   #endif
   #if USE_BMP085
-  char status;
-  double t, p, p0, a;
-  status = barometer.startTemperature();
-  if (status != 0) {
-    delay(status);
-    status = barometer.getTemperature(t);
-    if (status != 0) {
-      status = barometer.startPressure(3);
-      if (status != 0) {
-        delay(status);
-        status = barometer.getPressure(p, t);
-        if (status != 0) {
-          return (p);
-        }
-      }
-    }
-  }
+  return sampler.readBlocking();
   #endif
   return 0;
 }
 
+void Altimeter::setProfile(BaroProfile p)
+{
+  profile = p;
+  #if USE_BMP280
+  const BaroSamplingProfile &s = kSamplingProfiles[p];
+  barometer.setSampling(Adafruit_BMP280::MODE_NORMAL, s.tempSampling,
+                        s.pressSampling, s.filter, s.standby);
+  samplePeriod = s.samplePeriod;
+  rampLag      = s.rampLag;
+  #endif
+  #if USE_BMP085
+  sampler.setOversampling(kOversampling[p]);
+  rampLag = kRampLag[p];
+  #endif
+}
+
 bool Altimeter::isReady() { return barometerReady; }
@@ -28,30 +28,40 @@
 #define alitmeter_h
 
 #include "../../Configuration.h"
-#include "Filters.hpp"
+#include <AltimeterCore.h>
 
 
 // Sensor libraries
 #if USE_BMP280
-#include "lib/Adafruit_BMP280.h"
+#include <drivers/Adafruit_BMP280.h>
 typedef Adafruit_BMP280 Barometer;
 #define SEA_LEVEL_PRESSURE 1013.7
 #endif
 
 #if USE_BMP085
+#include "BMP180Sampler.hpp"
 #include "lib/SFE_BMP180.h"
 typedef SFE_BMP180 Barometer;  // 180 and 085 use the same interface
 #define SEA_LEVEL_PRESSURE 101370
 #endif
 
+// Barometer sampling profiles.  Each flight phase trades sample rate against
+// noise and power.  See kSamplingProfiles in Altimeter.cpp.
+typedef enum {
+  kPadIdleProfile,  // Low rate, low power while waiting on the pad
+  kBoostProfile,    // Highest rate, minimal filter lag
+  kCoastProfile,    // High rate with a little more filtering for apogee
+  kDescentProfile   // Lower noise for the main deployment altitude
+} BaroProfile;
+
 class Altimeter
 {
  public:
-  Altimeter() : velocityFilter(0.5, 0), altitudeFilter(0)
-  {
-    altitudeFilter.reset(0);
-    velocityFilter.reset(0);
-  };
+#if USE_BMP085
+  Altimeter() : altitudeFilter(kAltitudeGains), sampler(barometer) {}
+#else
+  Altimeter() : altitudeFilter(kAltitudeGains) {}
+#endif
 
   ~Altimeter(){};
 
@@ -60,25 +70,63 @@ class Altimeter
   void update();
   void reset();
 
-  double altitude();           // meters above the reference altitude
+  real_t altitude();           // meters above the reference altitude
   double referenceAltitude();  // Altitude when start() was called
-  double verticalVelocity();   // in meters per second based on rate of
+  real_t verticalVelocity();   // in meters per second based on rate of
                                // barometric pressure change
+  real_t rawAltitude() { return lastRecordedAltitude; }  // Unfiltered
+
+  // Incremented for every new barometer sample
+  unsigned long getSampleCount() { return sampleCount; }
   double pressure();
   double getRefPressure() { return baselinePressure; }
 
+  void setProfile(BaroProfile profile);
+  BaroProfile getProfile() { return profile; }
+
+  // How far altitude() trails the truth at a steady vertical speed, in
+  // micros, for the current profile
+  unsigned long lag() { return rampLag; }
+
+  // New barometer samples per second, updated once per second
+  double sampleRate() { return achievedSampleRate; }
+  // Longest time spent in a single call to update() in microseconds
+  unsigned long maxBlockingTime() { return maxUpdateTime; }
+
  private:
   Barometer barometer;
   bool barometerReady = false;
   double refAltitude  = 0;
 
-  KalmanFilter altitudeFilter;
-  LowPassFilter velocityFilter;
+  // Altitude and vertical velocity.  The barometer's own IIR filter takes
+  // most of the noise out so these gains lean on the measurements.
+  static constexpr TrackingGains kAltitudeGains = alphaBetaGains(0.5);
+  AlphaBetaFilter<real_t> altitudeFilter;
 
   double baselinePressure = 0;
 
   long lastRefreshTime        = 0;
-  double lastRecordedAltitude = 0;
+  real_t lastRecordedAltitude = 0;
+
+#if USE_BMP085
+  BMP180Sampler sampler;
+#endif
+
+  BaroProfile profile = kPadIdleProfile;
+  // Minimum time between fresh samples for the current profile in micros.
+  // In normal mode the sensor free-runs so reading faster than this just
+  // returns the previous result.
+  unsigned long samplePeriod = 0;
+  unsigned long lastSampleTime = 0;
+  unsigned long rampLag        = 0;
+
+  unsigned long sampleWindowStart = 0;
+  int samplesInWindow             = 0;
+  double achievedSampleRate       = 0;
+  unsigned long maxUpdateTime     = 0;
+  unsigned long sampleCount       = 0;
+
+  void recordSample(unsigned long startTime);
 };
 
 #endif
@@ -0,0 +1,116 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "BMP180Sampler.hpp"
+
+bool BMP180Sampler::startConversion(unsigned long time)
+{
+  char wait;
+  if (!haveTemperature || pressureCount >= kTemperatureInterval) {
+    wait  = sensor.startTemperature();
+    state = kConvertingTemp;
+  } else {
+    wait  = sensor.startPressure(oversampling);
+    state = kConvertingPressure;
+  }
+
+  if (wait == 0) {
+    state = kIdle;
+    return false;
+  }
+
+  conversionStart = time;
+  conversionTime  = (unsigned long)wait * 1000;
+  return true;
+}
+
+bool BMP180Sampler::collect()
+{
+  ConversionState finished = state;
+  state                    = kIdle;
+
+  if (finished == kConvertingTemp) {
+    double t;
+    if (sensor.getTemperature(t)) {
+      lastTemperature = t;
+      haveTemperature = true;
+      pressureCount   = 0;
+    }
+    return false;
+  }
+
+  double p;
+  if (sensor.getPressure(p, lastTemperature)) {
+    lastPressure = p;
+    pressureCount++;
+    return true;
+  }
+  return false;
+}
+
+bool BMP180Sampler::poll()
+{
+  unsigned long t = micros();
+
+  if (state == kIdle) {
+    startConversion(t);
+    return false;
+  }
+
+  if (t - conversionStart < conversionTime) {
+    return false;
+  }
+
+  bool newSample = collect();
+
+  // Kick off the next conversion right away so the sensor is never idle.
+  startConversion(t);
+  return newSample;
+}
+
+double BMP180Sampler::readBlocking()
+{
+  reset();
+  unsigned long start = millis();
+  while (millis() - start < kBlockingReadTimeout) {
+    if (poll()) {
+      return lastPressure;
+    }
+    if (state == kIdle) {
+      // The sensor failed to start a conversion
+      return 0;
+    }
+    delayMicroseconds(500);
+  }
+  return 0;
+}
+
+void BMP180Sampler::reset()
+{
+  state           = kIdle;
+  haveTemperature = false;
+  pressureCount   = 0;
+}
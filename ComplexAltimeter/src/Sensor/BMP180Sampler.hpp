@@ -0,0 +1,90 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef BMP180SAMPLER_H
+#define BMP180SAMPLER_H
+
+#include <Arduino.h>
+#include "lib/SFE_BMP180.h"
+
+// The temperature is only used to compensate the pressure reading and changes
+// very slowly so we only refresh it every kTemperatureInterval pressure samples.
+#define kTemperatureInterval 20
+
+// A temperature and pressure conversion takes ~31ms at the highest
+// oversampling.  Give up on blocking reads after this many ms.
+#define kBlockingReadTimeout 100
+
+// Non-blocking wrapper around the SFE_BMP180 conversion cycle.  The BMP180
+// requires us to start a conversion, wait 5-26ms and then read the result.
+// Rather than calling delay(), poll() starts a conversion and returns
+// immediately.  The result is collected on a later call to poll() once the
+// conversion time has elapsed.
+class BMP180Sampler
+{
+ public:
+  BMP180Sampler(SFE_BMP180 &sensor, char oversampling = 3)
+      : sensor(sensor), oversampling(oversampling)
+  {
+  }
+
+  // Advances the conversion state machine.  Returns true if a new pressure
+  // sample was collected on this call.
+  bool poll();
+
+  // Blocks until a complete temperature and pressure sample is available.
+  // Only for use on the pad (calibration and resets).
+  double readBlocking();
+
+  // Discards any conversion in progress.  The next poll() will refresh the
+  // temperature.
+  void reset();
+
+  void setOversampling(char oss) { oversampling = oss; }
+
+  double pressure() { return lastPressure; }
+  double temperature() { return lastTemperature; }
+
+ private:
+  typedef enum { kIdle, kConvertingTemp, kConvertingPressure } ConversionState;
+
+  SFE_BMP180 &sensor;
+  char oversampling;
+
+  ConversionState state = kIdle;
+  unsigned long conversionStart = 0;  // micros() when conversion was started
+  unsigned long conversionTime  = 0;  // conversion time in micros
+
+  byte pressureCount     = 0;  // Pressure samples since the last temp read
+  bool haveTemperature   = false;
+  double lastTemperature = 0;
+  double lastPressure    = 0;
+
+  bool startConversion(unsigned long time);
+  bool collect();
+};
+
+#endif
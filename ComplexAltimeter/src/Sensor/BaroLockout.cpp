@@ -0,0 +1,150 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "BaroLockout.hpp"
+
+constexpr TrackingGains BaroLockout::kBaroTrackGains;
+
+void BaroLockout::reset(real_t altitude)
+{
+  estAltitude     = altitude;
+  estVelocity     = 0;
+  lastTime        = 0;
+  lockedOut       = false;
+  lockoutStart    = 0;
+  agreeCount      = 0;
+  steadyCount     = 0;
+  lockoutCount    = 0;
+  maxReleaseError = 0;
+  rebase          = 0;
+  lastBaroTime    = 0;
+  baroTrack.reset(altitude);
+}
+
+void BaroLockout::update(long time, real_t verticalAcceleration,
+                         real_t baroAltitude, bool newBaroSample)
+{
+  if (!inertialEnabled) {
+    if (newBaroSample) {
+      real_t dt   = lastTime ? secondsFromMillis(time - lastTime) : 0;
+      estVelocity = dt > 0 ? (baroAltitude - estAltitude) / dt : 0;
+      estAltitude = baroAltitude;
+      lastTime    = time;
+    }
+    return;
+  }
+
+  if (lastTime) {
+    long dt   = time - lastTime;
+    real_t dv = overMillis(verticalAcceleration, dt);
+    estAltitude += overMillis(estVelocity + dv * real_t(0.5), dt);
+    estVelocity += dv;
+  }
+  lastTime = time;
+
+  bool steady  = newBaroSample && trackBaro(time, baroAltitude);
+  real_t error = baroAltitude - estAltitude;
+  bool suspect = realAbs(error) > config.innovationGate;
+
+  if (!lockedOut) {
+    if (realAbs(estVelocity) > config.lockoutVelocity ||
+        (newBaroSample && suspect)) {
+      lockedOut    = true;
+      lockoutStart = time;
+      agreeCount   = 0;
+      steadyCount  = 0;
+      lockoutCount++;
+    } else if (newBaroSample) {
+      correct(error);
+    }
+    return;
+  }
+
+  if (!newBaroSample) {
+    return;
+  }
+  bool agrees =
+      steady &&
+      realAbs(baroTrack.getRate() - estVelocity) <= config.releaseRateGate;
+  long held   = time - lockoutStart;
+  steadyCount = !steady ? 0 : (steadyCount < 255 ? steadyCount + 1 : 255);
+  agreeCount  = !agrees ? 0 : (agreeCount < 255 ? agreeCount + 1 : 255);
+  if ((held >= config.minLockoutMs &&
+       realAbs(estVelocity) < config.releaseVelocity &&
+       agreeCount >= config.releaseSamples) ||
+      (held > config.maxLockoutMs &&
+       realAbs(baroTrack.getRate()) < config.releaseVelocity &&
+       steadyCount >= config.releaseSamples)) {
+    // Past maxLockoutMs the IMU has drifted too far to be any use and we
+    // have to trust the barometer's rate over it, as long as the barometer
+    // isn't in the middle of a glitch
+    release();
+  }
+}
+
+void BaroLockout::correct(real_t error)
+{
+  estAltitude += config.alpha * error;
+  estVelocity += config.beta * error;
+}
+
+// Steps the baro-only track.  Returns true if the sample is consistent with
+// it and the track's rate has settled, which it won't have for a while after
+// a glitch even once the altitude has.
+bool BaroLockout::trackBaro(long time, real_t baroAltitude)
+{
+  if (!lastBaroTime) {
+    baroTrack.reset(baroAltitude, estVelocity);
+    lastBaroTime = time;
+    return false;
+  }
+  real_t dt        = secondsFromMillis(time - lastBaroTime);
+  real_t rate      = baroTrack.getRate();
+  real_t predicted = baroTrack.getCurrentValue() + rate * dt;
+  lastBaroTime     = time;
+  baroTrack.step(baroAltitude, dt);
+  return realAbs(baroAltitude - predicted) <= config.innovationGate &&
+         realAbs(baroTrack.getRate() - rate) <= config.releaseRateGate;
+}
+
+void BaroLockout::release()
+{
+  real_t error = baroTrack.getCurrentValue() - estAltitude;
+  lockedOut    = false;
+  estAltitude  = baroTrack.getCurrentValue();
+  estVelocity  = baroTrack.getRate();
+  rebase += error;
+  if (realAbs(error) > maxReleaseError) {
+    maxReleaseError = realAbs(error);
+  }
+}
+
+real_t BaroLockout::takeRebase()
+{
+  real_t r = rebase;
+  rebase   = 0;
+  return r;
+}
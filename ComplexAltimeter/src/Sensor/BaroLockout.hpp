@@ -0,0 +1,134 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef barolockout_h
+#define barolockout_h
+
+#include <Arduino.h>
+#include <AltimeterCore.h>
+
+// Fuses barometric altitude with the IMU's vertical acceleration and locks
+// the barometer out when it can't be trusted.
+//
+// Near Mach 1 the shock waves passing the static ports make the pressure
+// jump.  The altitude that comes out can read tens of meters off in either
+// direction, which is enough to fake an apogee.  The estimate is normally
+// an alpha-beta filter driven by the accelerometer and corrected by each
+// baro sample.  The barometer is locked out when:
+//  - the estimated velocity is over lockoutVelocity, or
+//  - a baro sample is more than innovationGate meters from the estimate
+//    (a pressure rate no rocket could produce)
+// While locked out, altitude and velocity are dead-reckoned from the IMU
+// alone.  The lock is released once we've slowed below releaseVelocity,
+// held it for at least minLockoutMs, and the barometer agrees again.
+//
+// Agreement can't be judged against the dead-reckoned altitude, which has
+// drifted by more than innovationGate by then.  A second alpha-beta filter
+// tracks the barometer alone.  A sample is steady when it lands within
+// innovationGate of that track and the track's rate has settled, and agrees
+// when the rate is also within releaseRateGate of the IMU's velocity, which
+// drifts far less than its altitude.  Past maxLockoutMs we stop waiting for
+// the IMU and release on steady samples alone, once the barometer's own rate
+// is below releaseVelocity.
+//
+// By then the IMU has drifted by a few meters to tens of meters.  Easing
+// back onto the barometer would look like a drop in altitude and fake the
+// apogee we were trying to protect, so the estimate snaps back onto the
+// barometer instead, and the velocity onto the barometer's rate.  The size of
+// the step is handed to whoever is tracking the apogee through takeRebase()
+// so they can move it by the same amount.
+
+typedef struct {
+  real_t lockoutVelocity;  // m/s
+  real_t releaseVelocity;  // m/s
+  real_t innovationGate;   // m
+  real_t releaseRateGate;  // m/s, baro rate against the IMU velocity
+  uint16_t minLockoutMs;
+  uint16_t maxLockoutMs;   // Give up on the IMU after this long
+  uint8_t releaseSamples;  // Agreeing baro samples needed to release
+  real_t alpha;            // Altitude correction gain per baro sample
+  real_t beta;             // Velocity correction gain per baro sample (1/s)
+} BaroLockoutConfig;
+
+class BaroLockout
+{
+ public:
+  BaroLockout(const BaroLockoutConfig &config)
+      : config(config), baroTrack(kBaroTrackGains)
+  {
+    reset(0);
+  }
+
+  // Starts the estimate at |altitude|, at rest
+  void reset(real_t altitude);
+
+  // Advances the estimate to |time| (ms).  |verticalAcceleration| excludes
+  // gravity.  |baroAltitude| is only used if |newBaroSample| is set.
+  void update(long time, real_t verticalAcceleration, real_t baroAltitude,
+              bool newBaroSample);
+
+  // Without an IMU there's nothing to bridge with so the estimate just
+  // follows the barometer
+  void setInertialEnabled(bool enabled) { inertialEnabled = enabled; }
+
+  real_t altitude() { return estAltitude; }
+  real_t velocity() { return estVelocity; }
+
+  bool isLockedOut() { return lockedOut; }
+  int getLockoutCount() { return lockoutCount; }
+  // Largest disagreement with the barometer when a lockout ended
+  real_t getMaxReleaseError() { return maxReleaseError; }
+
+  // Returns the step applied to the altitude since the last call
+  real_t takeRebase();
+
+ private:
+  static constexpr TrackingGains kBaroTrackGains = alphaBetaGains(0.5);
+
+  BaroLockoutConfig config;
+  bool inertialEnabled = true;
+
+  AlphaBetaFilter<real_t> baroTrack;  // The barometer alone
+  long lastBaroTime = 0;
+
+  real_t estAltitude = 0;
+  real_t estVelocity = 0;
+  long lastTime      = 0;
+
+  bool lockedOut         = false;
+  long lockoutStart      = 0;
+  uint8_t agreeCount     = 0;  // Steady, and at the IMU's velocity
+  uint8_t steadyCount    = 0;  // Consistent with the baro track
+  int lockoutCount       = 0;
+  real_t maxReleaseError = 0;
+  real_t rebase          = 0;
+
+  void correct(real_t error);
+  bool trackBaro(long time, real_t baroAltitude);
+  void release();
+};
+
+#endif
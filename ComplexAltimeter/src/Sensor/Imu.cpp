@@ -81,6 +81,18 @@ void Imu::update()
 
 Heading Imu::getRelativeHeading() { return heading - referenceHeading; }
 
+real_t Imu::getVerticalAcceleration()
+{
+  float g = gravityReference.length();
+  if (g == 0) {
+    return 0;
+  }
+  float along = acceleration.XAxis * gravityReference.XAxis +
+                acceleration.YAxis * gravityReference.YAxis +
+                acceleration.ZAxis * gravityReference.ZAxis;
+  return toReal(along / g - g);
+}
+
 void Imu::calibrate()
 {
   for (int i = 0; i < 20; i++) {
@@ -32,10 +32,10 @@
 #include "../DataLogger.hpp"
 #include "../types.h"
 #include "lib/MadgwickAHRS.h"
-#include "lib/MahonyAHRS.h"
+#include <drivers/MahonyAHRS.h>
 
 #if USE_MPU9250
-#include "lib/MPU9250.h"
+#include <drivers/MPU9250.h>
 typedef MPU9250 ImuSensor;
 #endif
 
@@ -65,7 +65,8 @@ class Imu
     mpuReady = !(imuSensor.begin() < 0);
   #endif
   #if USE_MPU6050
-    mpuReady = imuSensor.begin(MPU6050_SCALE_2000DPS, MPU6050_RANGE_2G, IMU_I2C_ADDR);
+    // 2g would clip every motor we fly
+    mpuReady = imuSensor.begin(MPU6050_SCALE_2000DPS, MPU6050_RANGE_16G, IMU_I2C_ADDR);
   #endif
     DataLogger::log(mpuReady ? "IMU OK" : "IMU failed");
     return mpuReady;
@@ -83,12 +84,20 @@ class Imu
   // Rotational acceleration
   Vector const &getGyro() { return gyro; }
 
+  // Acceleration along the direction gravity pointed when we were calibrated
+  // on the pad, less gravity.  That's vertical for as long as the rocket
+  // flies straight.
+  real_t getVerticalAcceleration();
+
   // Reference heading on startup
   Heading const &getReferenceHeading() { return referenceHeading; }
 
   // Euler angles relative to our reference heading
   Heading getRelativeHeading();
 
+  // Orientation quaternion (w, x, y, z) from the sensor fusion
+  void getQuaternion(float *q) { sensorFusion.getQuaternion(q); }
+
  private:
   bool mpuReady;
   int frequency;
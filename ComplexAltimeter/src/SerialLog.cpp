@@ -0,0 +1,217 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "SerialLog.hpp"
+
+SerialLog &SerialLog::shared()
+{
+  static SerialLog sharedInstance;
+  return sharedInstance;
+}
+
+void SerialLog::enqueue(uint8_t level, const char *format, const LogArg *args,
+                        uint8_t count, uint16_t types)
+{
+  Record r;
+  r.size = sizeof(Record) + count * sizeof(LogArg);
+  if (!reserve(r.size)) {
+    return;
+  }
+  r.level    = level;
+  r.argCount = count;
+  r.argTypes = types;
+  r.time     = millis();
+  r.format   = format;
+  put(&r, sizeof(r));
+  put(args, count * sizeof(LogArg));
+}
+
+void SerialLog::text(uint8_t level, const char *text, size_t len)
+{
+  // Leave room in the line for the time stamp and the line ending
+  len = len > kLogLineLength - 24 ? kLogLineLength - 24 : len;
+
+  Record r;
+  r.size = sizeof(Record) + len;
+  if (!reserve(r.size)) {
+    return;
+  }
+  r.level    = level;
+  r.argCount = kLogText;
+  r.argTypes = 0;
+  r.time     = millis();
+  r.format   = nullptr;
+  put(&r, sizeof(r));
+  put(text, len);
+}
+
+bool SerialLog::reserve(size_t size)
+{
+  size_t used = head - tail;
+  if (used + size > kLogBufferSize) {
+    dropped++;
+    return false;
+  }
+  if (used + size > highWater) {
+    highWater = used + size;
+  }
+  return true;
+}
+
+void SerialLog::put(const void *data, size_t len)
+{
+  size_t pos   = head & (kLogBufferSize - 1);
+  size_t first = len < kLogBufferSize - pos ? len : kLogBufferSize - pos;
+  memcpy(buffer + pos, data, first);
+  memcpy(buffer, (const uint8_t *)data + first, len - first);
+  head += len;
+}
+
+void SerialLog::get(void *data, size_t len)
+{
+  size_t pos   = tail & (kLogBufferSize - 1);
+  size_t first = len < kLogBufferSize - pos ? len : kLogBufferSize - pos;
+  memcpy(data, buffer + pos, first);
+  memcpy((uint8_t *)data + first, buffer, len - first);
+  tail += len;
+}
+
+void SerialLog::service()
+{
+  while (linePos < lineLength || nextLine()) {
+    int room = out->availableForWrite();
+    if (room <= 0) {
+      return;
+    }
+    size_t len = lineLength - linePos;
+    len        = (size_t)room < len ? room : len;
+    out->write((const uint8_t *)line + linePos, len);
+    linePos += len;
+  }
+}
+
+void SerialLog::flush()
+{
+  while (linePos < lineLength || nextLine()) {
+    out->write((const uint8_t *)line + linePos, lineLength - linePos);
+    linePos = lineLength;
+  }
+}
+
+// Formats the next message into |line|.  Returns false if there are none.
+bool SerialLog::nextLine()
+{
+  linePos    = 0;
+  lineLength = 0;
+  if (head != tail) {
+    Record r;
+    get(&r, sizeof(r));
+    format(r);
+    return true;
+  }
+
+  // Report drops once we've caught up so the gap is roughly where the
+  // messages went missing
+  if (dropped != droppedReported) {
+    uint32_t count  = dropped - droppedReported;
+    droppedReported = dropped;
+    lineLength      = snprintf(line, kLogLineLength,
+                          "-- %lu log messages dropped\r\n",
+                          (unsigned long)count);
+    return true;
+  }
+  return false;
+}
+
+void SerialLog::format(const Record &r)
+{
+  const size_t end = kLogLineLength - 2;  // Room for the line ending
+  size_t len = snprintf(line, kLogLineLength, "%lu %c ", (unsigned long)r.time,
+                        "DIWE"[r.level & 3]);
+
+  if (r.argCount == kLogText) {
+    size_t textLen = r.size - sizeof(Record);
+    get(line + len, textLen);
+    len += textLen;
+  } else {
+    LogArg args[kLogMaxArgs];
+    get(args, r.argCount * sizeof(LogArg));
+    uint8_t argIndex = 0;
+
+    for (const char *p = r.format; *p && len < end; p++) {
+      if (*p != '%') {
+        line[len++] = *p;
+        continue;
+      }
+
+      p++;
+      int precision = 2;
+      if (*p == '.' && isdigit(p[1])) {
+        precision = p[1] - '0';
+        p += 2;
+      }
+      if (*p == '%') {
+        line[len++] = '%';
+        continue;
+      }
+      if (!*p) {
+        break;
+      }
+
+      // The argument's own type decides how it's printed so a mismatched
+      // specifier can't read the wrong member
+      char num[24] = "?";
+      const char *s = num;
+      if (argIndex < r.argCount) {
+        const LogArg &a = args[argIndex];
+        bool hex        = *p == 'x';
+        switch ((r.argTypes >> (argIndex * 2)) & 3) {
+          case kLogArgInt:
+            snprintf(num, sizeof(num), hex ? "%lx" : "%ld", (long)a.i);
+            break;
+          case kLogArgUnsigned:
+            snprintf(num, sizeof(num), hex ? "%lx" : "%lu",
+                     (unsigned long)a.u);
+            break;
+          case kLogArgFloat:
+            dtostrf(a.f, 1, precision, num);
+            break;
+          case kLogArgString:
+            s = a.s ? a.s : "(null)";
+            break;
+        }
+        argIndex++;
+      }
+      while (*s && len < end) {
+        line[len++] = *s++;
+      }
+    }
+  }
+
+  line[len++] = '\r';
+  line[len++] = '\n';
+  lineLength  = len;
+}
@@ -0,0 +1,214 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef seriallog_h
+#define seriallog_h
+
+#include <Arduino.h>
+#include "../Configuration.h"
+
+// Buffered serial logging.
+//
+// Messages are queued in a static ring and written out by service() from the
+// main loop, only as fast as the UART will take them without blocking.  When
+// the ring is full the message is dropped and counted; a logging call never
+// waits on the serial port.
+//
+// The format and any %s arguments are not copied, only the pointers, so they
+// must be string literals or otherwise outlive the message.  Numbers are
+// copied and formatted when the message is written out.  Supports %d, %i,
+// %u, %x, %f (and %.Nf), %s and %%.
+//
+//   LOG_INFO("Apogee %.1f at %u ms", apogee, time);
+//
+// Messages below LOG_LEVEL aren't compiled in.  DataLogger::log(String)
+// queues a copy of the string at kLogLevelInfo.
+
+#define kLogLevelDebug 0
+#define kLogLevelInfo 1
+#define kLogLevelWarn 2
+#define kLogLevelError 3
+#define kLogLevelNone 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL kLogLevelInfo
+#endif
+
+#define kLogBufferSize 2048  // Must be a power of two
+#define kLogMaxArgs 8
+#define kLogLineLength 160
+#define kLogText 0xFF  // argCount for a record holding a copied string
+
+#if LOG_LEVEL <= kLogLevelDebug
+#define LOG_DEBUG(...) SerialLog::shared().write(kLogLevelDebug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= kLogLevelInfo
+#define LOG_INFO(...) SerialLog::shared().write(kLogLevelInfo, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= kLogLevelWarn
+#define LOG_WARN(...) SerialLog::shared().write(kLogLevelWarn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= kLogLevelError
+#define LOG_ERROR(...) SerialLog::shared().write(kLogLevelError, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+typedef union {
+  int32_t i;
+  uint32_t u;
+  float f;
+  const char *s;
+} LogArg;
+
+typedef enum : uint8_t {
+  kLogArgInt,
+  kLogArgUnsigned,
+  kLogArgFloat,
+  kLogArgString
+} LogArgType;
+
+class SerialLog
+{
+ public:
+  static SerialLog &shared();
+
+  SerialLog() {}
+  SerialLog(SerialLog const &) = delete;
+  void operator=(SerialLog const &) = delete;
+
+  // Queues a message with up to kLogMaxArgs numeric or static string
+  // arguments.  Use the LOG_ macros rather than calling this directly.
+  template <typename... Args>
+  void write(uint8_t level, const char *format, Args... args)
+  {
+    static_assert(sizeof...(Args) <= kLogMaxArgs, "Too many log arguments");
+    LogArg values[sizeof...(Args) + 1];
+    uint16_t types = 0;
+    uint8_t count  = 0;
+    pack(values, types, count, args...);
+    enqueue(level, format, values, count, types);
+  }
+
+  // Queues a copy of |len| characters of |text|
+  void text(uint8_t level, const char *text, size_t len);
+
+  // Writes out as much of the queue as the UART will take without blocking
+  void service();
+
+  // Writes out everything, blocking.  For use before a restart.
+  void flush();
+
+  uint32_t getDropped() { return dropped; }
+  size_t getHighWater() { return highWater; }
+
+  // For testing.  Defaults to Serial.
+  void setOutput(HardwareSerial *out) { this->out = out; }
+
+ private:
+  typedef struct {
+    uint16_t size;  // Including this header
+    uint8_t level;
+    uint8_t argCount;
+    uint16_t argTypes;  // Two bits per argument
+    uint32_t time;
+    const char *format;
+  } Record;
+
+  uint8_t buffer[kLogBufferSize];
+  size_t head              = 0;  // Free running, masked on access
+  size_t tail              = 0;
+  size_t highWater         = 0;
+  uint32_t dropped         = 0;
+  uint32_t droppedReported = 0;
+
+  char line[kLogLineLength];
+  size_t lineLength = 0;
+  size_t linePos    = 0;
+
+  HardwareSerial *out = &Serial;
+
+  static uint8_t setArg(LogArg &a, int v)
+  {
+    a.i = v;
+    return kLogArgInt;
+  }
+  static uint8_t setArg(LogArg &a, long v)
+  {
+    a.i = v;
+    return kLogArgInt;
+  }
+  static uint8_t setArg(LogArg &a, unsigned int v)
+  {
+    a.u = v;
+    return kLogArgUnsigned;
+  }
+  static uint8_t setArg(LogArg &a, unsigned long v)
+  {
+    a.u = v;
+    return kLogArgUnsigned;
+  }
+  static uint8_t setArg(LogArg &a, double v)
+  {
+    a.f = v;
+    return kLogArgFloat;
+  }
+  static uint8_t setArg(LogArg &a, const char *v)
+  {
+    a.s = v;
+    return kLogArgString;
+  }
+
+  static void pack(LogArg *, uint16_t &, uint8_t &) {}
+
+  template <typename T, typename... Rest>
+  static void pack(LogArg *values, uint16_t &types, uint8_t &count, T first,
+                   Rest... rest)
+  {
+    types |= setArg(values[count], first) << (count * 2);
+    count++;
+    pack(values, types, count, rest...);
+  }
+
+  void enqueue(uint8_t level, const char *format, const LogArg *args,
+               uint8_t count, uint16_t types);
+  bool reserve(size_t size);
+  void put(const void *data, size_t len);
+  void get(void *data, size_t len);
+  bool nextLine();
+  void format(const Record &r);
+};
+
+#endif
@@ -24,73 +24,59 @@
  * SOFTWARE.
  **********************************************************************************/
 
-#ifndef Filters_h
-#define Filters_h
+#include "ServoActuator.hpp"
 
-class Filter
+void ServoActuator::attach(uint8_t pin, int angle)
 {
-  public:
-  virtual double step(double value)        = 0;
-  virtual void reset(double startingValue) = 0;
+  servo.attach(pin);
+  nextFrame   = micros() + config.frameUs;
+  frameServed = 0;
+  set(angle);
+}
 
-  double getCurrentValue() { return currentValue; }
-
- protected:
-  double currentValue;
-};
-
-// Returns the unweighted moving average of an input for n steps
-class AveragingFilter : public Filter
+void ServoActuator::set(int angle)
 {
-  AveragingFilter(int numSteps, double startingValue)
-  {
-    steps  = numSteps;
-    values = new double[steps];
-    reset(startingValue);
-  }
-
-  ~AveragingFilter() { delete values; }
-
-public:
-  double step(double nextValue);
-  void reset(double startingValue);
-
-private:
-  int steps;
-  double *values;
-  int valueIndex;
-};
-
-// Simple low pass filter
-class LowPassFilter : public Filter
+  target    = angle;
+  position  = angle;
+  written   = angle;
+  lastWrite = micros();
+  servo.write(angle);
+  writes++;
+}
+
+void ServoActuator::service()
 {
-  LowPassFilter(double bias, double startingValue) { this->bias = bias; }
-
-public:
-  double step(double value);
-  void reset(double startingValue);
+  unsigned long now = micros();
+  bool missed       = false;
+  if ((long)(now - nextFrame) >= 0) {
+    missed = frameServed != nextFrame;
+    nextFrame += ((now - nextFrame) / config.frameUs + 1) * config.frameUs;
+  }
 
- private:
-  double bias;
-  double currentValue;
-};
+  if (missed) {
+    // Too late for the frame that just started, so this one lands on the
+    // next.  The window for that still gets a fresher write if we make it.
+    write(now);
+  } else if (frameServed != nextFrame && nextFrame - now <= config.leadUs) {
+    frameServed = nextFrame;
+    write(now);
+  }
+}
 
-//Simple KalmanFilter
-class KalmanFilter : public Filter
+void ServoActuator::write(unsigned long now)
 {
- private:
-  float err_measured  = 0;
-  float err_estimated = 0;
-  float q             = 0;
-  float last_estimate = 0;
+  unsigned long dt = min(now - lastWrite, (unsigned long)config.frameUs);
+  lastWrite        = now;
 
- public:
-  KalmanFilter(double startingValue) { reset(startingValue); }
+  float step  = config.slewRate * dt / 1000000.0f;
+  float delta = target - position;
+  position += delta > step ? step : delta < -step ? -step : delta;
 
-  double step(double measurement);
-  void reset(double startingValue);
-
-  void configure(double measuredError, double estimatedError, double gain);
-};
-
-#endif //Filters_h
\ No newline at end of file
+  int angle = lroundf(position);
+  if (angle == written || fabsf(position - written) < config.deadband) {
+    return;
+  }
+  written = angle;
+  servo.write(angle);
+  writes++;
+}
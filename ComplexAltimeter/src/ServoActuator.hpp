@@ -0,0 +1,93 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef servoactuator_h
+#define servoactuator_h
+
+#include <Arduino.h>
+#include <Servo.h>
+
+// Sits between a control law and a hobby servo.
+//
+// A servo only takes a new pulse width once per PWM frame (20ms), so
+// writing it on every control tick mostly rewrites the same pulse.  The
+// control law calls command() as often as it likes.  service() is called
+// from the main loop and writes once per frame, in the last leadUs before
+// the frame starts, with the latest command.  That's the freshest value the
+// servo could have acted on anyway.  If the loop misses that window the
+// write goes out as soon as it's back, and lands a frame late.
+//
+// Writes move at most slewRate toward the command, which keeps a noisy
+// control law from slamming the gimbal.  Writes that would move less than
+// deadband from the last one written are skipped.
+//
+// The frames are timed from attach().  That's when the core starts the
+// servo's waveform, and it picks up a new width at the start of a period.
+
+typedef struct {
+  uint16_t frameUs;  // Servo PWM period
+  uint16_t leadUs;   // Write this long before a frame starts
+  float slewRate;    // deg/s
+  float deadband;    // deg
+} ServoActuatorConfig;
+
+class ServoActuator
+{
+ public:
+  ServoActuator(const ServoActuatorConfig &config) : config(config) {}
+
+  // Attaches to |pin| and sets |angle|
+  void attach(uint8_t pin, int angle);
+
+  // Writes |angle| now, ignoring the frame, slew and deadband
+  void set(int angle);
+
+  // The angle the control law wants, in degrees
+  void command(float angle) { target = angle; }
+
+  void service();
+
+  // The angle last written
+  int getAngle() { return written; }
+  unsigned long getWriteCount() { return writes; }
+
+ private:
+  ServoActuatorConfig config;
+  Servo servo;
+
+  float target   = 0;
+  float position = 0;  // Where the slew limit has got to
+  int written    = 0;
+
+  unsigned long nextFrame   = 0;  // micros() the next frame starts
+  unsigned long frameServed = 0;  // The last nextFrame we wrote for
+  unsigned long lastWrite   = 0;
+  unsigned long writes      = 0;
+
+  void write(unsigned long now);
+};
+
+#endif
@@ -0,0 +1,102 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "TarStream.hpp"
+
+// Field offsets in the ustar header
+#define kTarName 0
+#define kTarMode 100
+#define kTarUid 108
+#define kTarGid 116
+#define kTarSize 124
+#define kTarMtime 136
+#define kTarChecksum 148
+#define kTarType 156
+#define kTarMagic 257
+
+static void putOctal(uint8_t *field, size_t width, uint32_t value)
+{
+  // Zero padded, NUL terminated
+  field[width - 1] = 0;
+  for (int i = width - 2; i >= 0; i--) {
+    field[i] = '0' + (value & 7);
+    value >>= 3;
+  }
+}
+
+void TarStream::beginFile(const String &name, size_t size)
+{
+  remaining  = size;
+  readFailed = false;
+
+  memset(block, 0, kTarBlockSize);
+  size_t len = name.length() < 99 ? name.length() : 99;
+  memcpy(block + kTarName, name.c_str(), len);
+  putOctal(block + kTarMode, 8, 0644);
+  putOctal(block + kTarUid, 8, 0);
+  putOctal(block + kTarGid, 8, 0);
+  putOctal(block + kTarSize, 12, size);
+  putOctal(block + kTarMtime, 12, 0);  // There's no clock to speak of
+  block[kTarType] = '0';
+  memcpy(block + kTarMagic, "ustar\0" "00", 8);
+
+  // The checksum is calculated with its own field set to spaces
+  memset(block + kTarChecksum, ' ', 8);
+  uint32_t sum = 0;
+  for (int i = 0; i < kTarBlockSize; i++) {
+    sum += block[i];
+  }
+  putOctal(block + kTarChecksum, 7, sum);
+  writeBlock();
+}
+
+bool TarStream::writeData(File &f)
+{
+  if (!remaining) {
+    return false;
+  }
+  size_t len = remaining < kTarBlockSize ? remaining : kTarBlockSize;
+  size_t n   = readFailed ? 0 : f.read(block, len);
+  if (n != len && !readFailed) {
+    readFailed = true;
+    shortFiles++;
+  }
+  memset(block + n, 0, kTarBlockSize - n);
+  writeBlock();
+  remaining -= len;
+  return remaining > 0;
+}
+
+void TarStream::writeEnd()
+{
+  memset(block, 0, kTarBlockSize);
+  writeBlock();
+}
+
+void TarStream::writeBlock()
+{
+  out->write(block, kTarBlockSize);
+}
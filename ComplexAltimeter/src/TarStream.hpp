@@ -0,0 +1,72 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef tarstream_h
+#define tarstream_h
+
+#include <Arduino.h>
+#include "FS.h"
+
+// Writes a ustar archive to a Print one file at a time.  Only a single
+// kTarBlockSize buffer is used however large the files are, so whole flight
+// histories can be streamed over HTTP.
+//
+// For each file call beginFile(), then writeData() until it returns false.
+// End the archive by calling writeEnd() twice.  Each call writes exactly one
+// block, so the caller decides how much work is done at a time.
+
+#define kTarBlockSize 512
+
+class TarStream
+{
+ public:
+  TarStream(Print *out) : out(out) {}
+
+  // Writes the header for a file of |size| bytes.  Names are limited to 99
+  // characters.
+  void beginFile(const String &name, size_t size);
+
+  // Writes the next block of the current file from |f|.  Returns false once
+  // the file is complete.  A short file is zero filled to keep the archive
+  // valid and counted in getShortFiles().
+  bool writeData(File &f);
+
+  // Writes one of the two zero blocks that end the archive
+  void writeEnd();
+
+  int getShortFiles() { return shortFiles; }
+
+ private:
+  Print *out;
+  uint8_t block[kTarBlockSize];
+  size_t remaining = 0;  // Of the current file
+  bool readFailed  = false;
+  int shortFiles   = 0;
+
+  void writeBlock();
+};
+
+#endif
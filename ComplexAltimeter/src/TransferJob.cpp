@@ -0,0 +1,253 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "TransferJob.hpp"
+
+TransferJob::TransferJob(ESP8266WebServer *server)
+    : client(server->client()), chunked(false)
+{
+}
+
+TransferJob::TransferJob(ESP8266WebServer *server, const char *contentType,
+                         const String &headers)
+    : client(server->client()), chunked(true)
+{
+  String header = "HTTP/1.1 200 OK\r\nContent-Type: " + String(contentType) +
+                  "\r\nTransfer-Encoding: chunked\r\nConnection: close\r\n" +
+                  headers + "\r\n";
+  client.print(header);
+}
+
+bool TransferJob::step()
+{
+  if (complete || !client.connected()) {
+    return false;
+  }
+
+  if (offset == length) {
+    offset = 0;
+    length = produce(buffer, kTransferChunkSize);
+    if (!length) {
+      if (chunked) {
+        client.print("0\r\n\r\n");
+      }
+      complete = true;
+      return false;
+    }
+  }
+
+  // Writing more than the connection has room for would wait on the client
+  size_t room = client.availableForWrite();
+  if (chunked) {
+    room = room > kChunkFraming ? room - kChunkFraming : 0;
+  }
+  size_t len = length - offset;
+  len        = len < room ? len : room;
+  if (!len) {
+    return true;
+  }
+
+  if (chunked) {
+    client.print(String(len, HEX) + "\r\n");
+    len = client.write(buffer + offset, len);
+    client.print("\r\n");
+  } else {
+    len = client.write(buffer + offset, len);
+  }
+  offset += len;
+  sent += len;
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// FileRangeJob
+
+FileRangeJob::FileRangeJob(ESP8266WebServer *server, File &f, size_t first,
+                           size_t length)
+    : TransferJob(server), f(f), remaining(length)
+{
+  this->f.seek(first);
+}
+
+size_t FileRangeJob::produce(uint8_t *buf, size_t max)
+{
+  size_t len = remaining < max ? remaining : max;
+  size_t n   = len ? f.read(buf, len) : 0;
+  remaining  = n ? remaining - n : 0;
+  return n;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// FlightPageJob
+
+FlightPageJob::FlightPageJob(ESP8266WebServer *server, const String &path,
+                             const String &head, const String &graphFile,
+                             const String &tail)
+    : TransferJob(server, "text/html", ""),
+      graphFile(graphFile),
+      tail(tail)
+{
+  reader.open(path);
+  pending = head + "<script>";
+}
+
+size_t FlightPageJob::produce(uint8_t *buf, size_t max)
+{
+  while (pendingOffset >= pending.length()) {
+    if (!nextPiece()) {
+      return 0;
+    }
+  }
+  size_t len = pending.length() - pendingOffset;
+  len        = len < max ? len : max;
+  memcpy(buf, pending.c_str() + pendingOffset, len);
+  pendingOffset += len;
+  return len;
+}
+
+bool FlightPageJob::nextPiece()
+{
+  pendingOffset = 0;
+  switch (phase) {
+    case kPageData:
+      if (reader.next(pending)) {
+        return true;
+      }
+      pending = "</script>";
+      graph   = SPIFFS.open(graphFile, "r");
+      phase   = kPageGraph;
+      return true;
+
+    case kPageGraph:
+      if (graph && graph.available()) {
+        pending = graph.readStringUntil('\n') + "\n";
+        return true;
+      }
+      if (graph) {
+        graph.close();
+      }
+      pending = tail;
+      phase   = kPageTail;
+      return true;
+
+    case kPageTail:
+    case kPageDone:
+      phase = kPageDone;
+      break;
+  }
+  return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// ExportJob
+
+ExportJob::ExportJob(ESP8266WebServer *server)
+    : TransferJob(server, "application/x-tar",
+                  "Content-Disposition: attachment; "
+                  "filename=\"flights.tar\"\r\n"),
+      tar(&capture)
+{
+}
+
+ExportJob::~ExportJob()
+{
+  if (f) {
+    f.close();
+  }
+  if (tar.getShortFiles()) {
+    DataLogger::log("Export zero filled " + String(tar.getShortFiles()) +
+                    " short files");
+  }
+}
+
+size_t ExportJob::BlockCapture::write(const uint8_t *data, size_t size)
+{
+  memcpy(buf + length, data, size);
+  length += size;
+  return size;
+}
+
+// Each pass writes at most one kTarBlockSize block
+size_t ExportJob::produce(uint8_t *buf, size_t max)
+{
+  capture.buf    = buf;
+  capture.length = 0;
+  while (!capture.length) {
+    if (inFile) {
+      inFile = tar.writeData(f);
+      if (!inFile) {
+        f.close();
+      }
+    } else if (phase != kExportEnd) {
+      openNextFile();
+    } else if (endBlocks < 2) {
+      tar.writeEnd();
+      endBlocks++;
+    } else {
+      return 0;
+    }
+  }
+  return capture.length;
+}
+
+// Opens the next file and writes its header.  Moves to kExportEnd once
+// there are none left.
+void ExportJob::openNextFile()
+{
+  while (phase != kExportEnd) {
+    String name;
+    switch (phase) {
+      case kExportIndex:
+        f     = SPIFFS.open("/flights.txt", "r");
+        name  = "index.txt";
+        phase = kExportHistory;
+        break;
+      case kExportHistory:
+        f     = SPIFFS.open("/apogeeHistory.txt", "r");
+        name  = "apogeeHistory.txt";
+        dir   = SPIFFS.openDir(FLIGHTS_DIR);
+        phase = kExportFlights;
+        break;
+      case kExportFlights:
+        if (!dir.next()) {
+          phase = kExportEnd;
+          continue;
+        }
+        f = dir.openFile("r");
+        // Drop the leading slash so the archive unpacks relative
+        name = dir.fileName().substring(1);
+        flightCount++;
+        break;
+      case kExportEnd:
+        break;
+    }
+    if (f) {
+      tar.beginFile(name, f.size());
+      inFile = true;
+      return;
+    }
+  }
+}
@@ -0,0 +1,172 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef transferjob_h
+#define transferjob_h
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include "DataLogger.hpp"
+#include "FS.h"
+#include "TarStream.hpp"
+
+// Long responses are sent as jobs that the web server steps from the main
+// loop, a piece at a time, so a flight download never holds up a control
+// tick.
+//
+// A job whose length is known up front sends only the body; the handler sends
+// the headers.  A job whose length isn't known writes the whole response to
+// its own copy of the client, chunk framing included.  ESP8266WebServer's
+// chunked mode can't be used for that: from core 2.5 on it ends a chunked
+// response as soon as the handler returns, before the job has sent anything.
+// These responses are sent with "Connection: close" and never go through the
+// server's send(), so the server has nothing to finish for them.
+//
+// step() only writes what the connection will take without blocking, so a
+// step is bounded by producing one kTransferChunkSize piece.
+
+#define kTransferChunkSize 512
+#define kChunkFraming 8  // "200\r\n" and the closing CRLF for a 512 byte chunk
+
+class TransferJob
+{
+ public:
+  // Sends the body of a response the handler has started
+  explicit TransferJob(ESP8266WebServer *server);
+  // Sends a complete chunked 200 response.  |headers| are extra header
+  // lines, each ending in CRLF.
+  TransferJob(ESP8266WebServer *server, const char *contentType,
+              const String &headers);
+  virtual ~TransferJob() {}
+
+  // Sends the next piece if the connection has room.  Returns false once the
+  // body has been sent or the client has gone.
+  bool step();
+
+  size_t bytesSent() { return sent; }
+  bool isComplete() { return complete; }
+
+ protected:
+  // Fills |buf| with up to |max| bytes of the body.  Returns 0 at the end.
+  virtual size_t produce(uint8_t *buf, size_t max) = 0;
+
+ private:
+  WiFiClient client;
+  bool chunked;
+  bool complete = false;
+  size_t sent   = 0;
+
+  uint8_t buffer[kTransferChunkSize];
+  size_t length = 0;
+  size_t offset = 0;
+};
+
+// A byte range of a file
+class FileRangeJob : public TransferJob
+{
+ public:
+  FileRangeJob(ESP8266WebServer *server, File &f, size_t first,
+               size_t length);
+  ~FileRangeJob() { f.close(); }
+
+ protected:
+  size_t produce(uint8_t *buf, size_t max) override;
+
+ private:
+  File f;
+  size_t remaining;
+};
+
+// A flight as an html page: |head|, the flight data as javascript,
+// |graphFile| and |tail|
+class FlightPageJob : public TransferJob
+{
+ public:
+  FlightPageJob(ESP8266WebServer *server, const String &path,
+                const String &head, const String &graphFile,
+                const String &tail);
+
+ protected:
+  size_t produce(uint8_t *buf, size_t max) override;
+
+ private:
+  typedef enum { kPageData, kPageGraph, kPageTail, kPageDone } PagePhase;
+
+  FlightJsonReader reader;
+  File graph;
+  String graphFile;
+  String tail;
+  PagePhase phase = kPageData;
+
+  String pending;
+  size_t pendingOffset = 0;
+
+  bool nextPiece();
+};
+
+// The flight index and every flight file as a tar archive
+class ExportJob : public TransferJob
+{
+ public:
+  ExportJob(ESP8266WebServer *server);
+  ~ExportJob();
+
+  int getFlightCount() { return flightCount; }
+
+ protected:
+  size_t produce(uint8_t *buf, size_t max) override;
+
+ private:
+  typedef enum {
+    kExportIndex,
+    kExportHistory,
+    kExportFlights,
+    kExportEnd
+  } ExportPhase;
+
+  // Captures the block TarStream writes into produce()'s buffer
+  class BlockCapture : public Print
+  {
+   public:
+    uint8_t *buf  = nullptr;
+    size_t length = 0;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *data, size_t size) override;
+  };
+
+  BlockCapture capture;
+  TarStream tar;
+  ExportPhase phase = kExportIndex;
+  Dir dir;
+  File f;
+  bool inFile     = false;
+  int endBlocks   = 0;
+  int flightCount = 0;
+
+  void openNextFile();
+};
+
+#endif
@@ -28,6 +28,8 @@
 #include <FS.h>
 #include "DataLogger.hpp"
 #include "FlightController.hpp"
+#include "HttpRange.hpp"
+#include "TransferJob.hpp"
 
 #define RUN_AS_ACCESS_POINT 1
 
@@ -54,12 +56,60 @@ const char *disarmURL   = "/disarm";
 const char *statusURL   = "/status";
 const char *settingsURL = "/settings";
 const char *configURL   = "/config";
+const char *exportURL   = "/export";
+const char *rawURL      = "/raw";
 
 WebServer::WebServer() : server(80) {}
 
 WebServer::~WebServer() {}
 
-void WebServer::handleClient() { server.handleClient(); }
+void WebServer::service(uint32_t budgetUs, volatile bool *preempt)
+{
+  busy           = true;
+  uint32_t start = micros();
+  if (!transfer) {
+    server.handleClient();
+  }
+
+  // A handler may have just started a transfer
+  while (transfer && !*preempt && micros() - start < budgetUs) {
+    size_t sent = transfer->bytesSent();
+    if (!transfer->step()) {
+      endTransfer();
+    } else if (transfer->bytesSent() == sent) {
+      break;  // The connection is full.  Try again next time.
+    }
+    // Lets the sensor ticker in to set |preempt|
+    yield();
+  }
+
+  uint32_t slice = micros() - start;
+  maxSlice       = slice > maxSlice ? slice : maxSlice;
+  busy           = false;
+}
+
+void WebServer::startTransfer(TransferJob *job)
+{
+  endTransfer();
+  transfer = job;
+}
+
+void WebServer::endTransfer()
+{
+  if (!transfer) {
+    return;
+  }
+  if (transfer->isComplete()) {
+    DataLogger::log("Sent " + String(transfer->bytesSent()) + " bytes");
+  } else {
+    DataLogger::log("Transfer dropped after " +
+                    String(transfer->bytesSent()) + " bytes");
+  }
+  delete transfer;
+  transfer = nullptr;
+}
+
+void WebServer::cancelTransfer() { endTransfer(); }
 
 void WebServer::start(const IPAddress &ipAddress)
 {
@@ -82,8 +132,14 @@ void WebServer::start(const IPAddress &ipAddress)
   server.on(flightsURL, std::bind(&WebServer::handleFlights, this));
   server.on(resetAllURL, std::bind(&WebServer::handleResetAll, this));
   server.on(configURL, std::bind(&WebServer::handleConfig, this));
+  server.on(exportURL, std::bind(&WebServer::handleExport, this));
+  server.on(rawURL, std::bind(&WebServer::handleRawFlight, this));
   server.serveStatic(settingsURL, SPIFFS, "/settings.html");
 
+  // The server only keeps the headers it's asked to
+  const char *headers[] = {"Range"};
+  server.collectHeaders(headers, 1);
+
   bindSavedFlights();
   server.begin();
   Serial.println("HTTP server initialized");
@@ -111,8 +167,10 @@ String WebServer::savedFlightLinks()
   String ret;
   Dir dir = SPIFFS.openDir(FLIGHTS_DIR);
   while (dir.next()) {
+    String index = dir.fileName().substring(strlen(FLIGHTS_DIR) + 1);
     ret += "<h2><a href=\"" + dir.fileName() + "\">" + dir.fileName() +
-           "</a></h2><br>";
+           "</a> <a href=\"" + rawURL + "?flight=" + index +
+           "\">(raw)</a></h2><br>";
   }
   return ret;
 }
@@ -125,20 +183,66 @@ void WebServer::handleFlights()
   pageBuilder.closePageStream();
 }
 
+// The page is sent by a job as the flight is decoded, a block at a time
 void WebServer::handleFlight()
 {
   String path = server.uri();
   DataLogger::log("Reading " + path);
+  startTransfer(
+      new FlightPageJob(&server, path, HtmlHtml, "/graph.html", HtmlHtmlClose));
+}
 
-  pageBuilder.startPageStream(&server, "");
-  pageBuilder.sendRawText(HtmlHtml);
-  // Send the flight data as a JSON object
-  pageBuilder.sendRawText("<script>");
-  pageBuilder.sendFileRaw(path);
-  pageBuilder.sendRawText("</script>");
-  // Send the graphing fragment
-  pageBuilder.sendFileRaw("/graph.html");
-  pageBuilder.closePageStream();
+// Sends the index and every flight file as a tar archive in one chunked
+// response.  The flight files are sent as they're stored; use
+// tools/flight_export.py to unpack and decode them.
+void WebServer::handleExport()
+{
+  DataLogger::log(F("Exporting flights"));
+  startTransfer(new ExportJob(&server));
+}
+
+// Sends a flight file as it's stored.  Range requests are honoured so an
+// interrupted download can pick up where it stopped, and the length is
+// always known so the connection doesn't have to be closed to end it.
+void WebServer::handleRawFlight()
+{
+  String index = server.arg("flight");
+  File f;
+  if (index.length()) {
+    f = SPIFFS.open(DataLogger::flightPath(index.toInt()), "r");
+  }
+  if (!f) {
+    server.send(404, "text/plain", "No such flight");
+    return;
+  }
+
+  size_t size  = f.size();
+  size_t first = 0;
+  size_t last  = size - 1;
+  int code     = 200;
+  switch (parseByteRange(server.header("Range").c_str(), size, &first, &last)) {
+    case kRangeSatisfiable:
+      code = 206;
+      server.sendHeader("Content-Range", "bytes " + String(first) + "-" +
+                                             String(last) + "/" +
+                                             String(size));
+      break;
+    case kRangeUnsatisfiable:
+      server.sendHeader("Content-Range", "bytes */" + String(size));
+      server.send(416, "text/plain", "");
+      f.close();
+      return;
+    case kRangeNone:
+      break;
+  }
+
+  size_t length = size ? last - first + 1 : 0;
+  server.sendHeader("Accept-Ranges", "bytes");
+  server.sendHeader("Content-Disposition",
+                    "attachment; filename=\"flight" + index + ".oaf\"");
+  server.setContentLength(length);
+  server.send(code, "application/octet-stream", "");
+  startTransfer(new FileRangeJob(&server, f, first, length));
 }
 
 void WebServer::handleResetAll()
@@ -209,11 +313,17 @@ void WebServer::handleConfigSetting(String &arg, String &val)
       d->enable();
     }
   } else if (arg == String("onAngle")) {
-    uint angle = val.toInt();
-    RecoveryDevice::setOnAngle(angle, true);
+    uint angle              = val.toInt();
+    RecoveryDevice::onAngle = angle;
+    Settings s;
+    s.writeIntValue(angle, "servoOnAngle");
+    DataLogger::log(String("On Angle Set to ") + String(angle));
   } else if (arg == String("offAngle")) {
-    uint angle = val.toInt();
-    RecoveryDevice::setOffAngle(angle, true);
+    uint angle               = val.toInt();
+    RecoveryDevice::offAngle = angle;
+    Settings s;
+    s.writeIntValue(angle, "servoOffAngle");
+    DataLogger::log(String("Off Angle Set to ") + String(angle));
   }
 }
 
@@ -227,6 +337,7 @@ void WebServer::handleRoot()
 
   body += PageBuilder::makeLink(String(settingsURL), "Configure<br/>");
   body += PageBuilder::makeLink(String(flightsURL), "Flight List<br/>");
+  body += PageBuilder::makeLink(String(exportURL), "Export All Flights<br/>");
   body += PageBuilder::makeLink(String(statusURL), "Show Status<br/>");
   body += PageBuilder::makeLink(String(testURL), "Run Flight Test<br/>");
 
@@ -312,7 +423,6 @@ void PageBuilder::closePageStream()
 {
   sendRawText(HtmlHtmlClose);
   server->sendContent("");
-  server->client().stop();
   server = nullptr;
 }
 
@@ -34,6 +34,7 @@
 #include <WiFiClient.h>
 
 class WebServer;
+class TransferJob;
 
 class PageBuilder
 {
@@ -69,7 +70,16 @@ class WebServer
   ~WebServer();
 
   void start(const IPAddress &ipAddress);
-  void handleClient();
+
+  // Handles a request, or continues sending a long response, for up to
+  // |budgetUs|.  Gives up the rest of the slice as soon as |preempt| is set.
+  void service(uint32_t budgetUs, volatile bool *preempt);
+
+  // Drops any response that's being sent
+  void cancelTransfer();
+
+  bool isBusy() { return busy; }
+  uint32_t getMaxSlice() { return maxSlice; }
 
   void bindFlight(int index);
   String getIPAddress();
@@ -79,6 +89,13 @@ class WebServer
   ESP8266WebServer server;
 
   PageBuilder pageBuilder;
+  TransferJob *transfer = nullptr;
+  volatile bool busy    = false;
+  uint32_t maxSlice     = 0;
+
+  void startTransfer(TransferJob *job);
+  void endTransfer();
+
   void bindSavedFlights();
   String savedFlightLinks();
   void response();
@@ -87,6 +104,8 @@ class WebServer
   void handleStatus();
   void handleFlights();
   void handleFlight();
+  void handleExport();
+  void handleRawFlight();
   void handleConfig();
   void handleDisarm();
 
@@ -27,22 +27,17 @@
 #ifndef types_h
 #define types_h
 
+#include <AltimeterCore.h>
 #include <Servo.h>
 #include "DataLogger.hpp"
 #include "FlightData.hpp"
+#include "FlightState.hpp"
 
 #define NO_PIN -1
 
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 
-typedef enum { kNoEjection, kPyro, kServo, kServoChannel } RecoveryDeviceType;
-
-typedef enum { OFF = 0, ON = 1 } OnOffState;
-
-typedef OnOffState RecoveryDeviceState;
-typedef OnOffState BlinkerState;
-
 struct Vector {
   float XAxis = 0;
   float YAxis = 0;
@@ -57,9 +52,9 @@ struct Vector {
     ZAxis = z;
   }
 
-  double length()
+  float length()
   {
-    return sqrt((XAxis * XAxis) + (YAxis * YAxis) + (ZAxis * ZAxis));
+    return sqrtf((XAxis * XAxis) + (YAxis * YAxis) + (ZAxis * ZAxis));
   }
 
   Vector operator+(Vector rhs)
@@ -93,9 +88,9 @@ struct Heading {
     yaw   = y;
   }
 
-  double roll  = 0;
-  double pitch = 0;
-  double yaw   = 0;
+  float roll  = 0;
+  float pitch = 0;
+  float yaw   = 0;
 
   Heading operator-(Heading rhs)
   {
@@ -109,51 +104,41 @@ struct Heading {
 };
 
 typedef struct {
-  double altitude         = 0;
-  double acceleration     = 0;
-  double verticalVelocity = 0;
+  real_t altitude             = 0;
+  real_t acceleration         = 0;
+  real_t verticalVelocity     = 0;
+  real_t verticalAcceleration = 0;  // Less gravity
+  real_t rawAltitude          = 0;  // Unfiltered barometer altitude
+  bool newBaroSample          = false;
   Vector acc_vec;
   Vector gyro_vec;
   Heading heading;
 
   String toString()
   {
-    return String("A:" + String(altitude) + " C:" + String(acceleration) +
-                  " V:" + String(verticalVelocity));
+    return String("A:" + String(toFloat(altitude)) +
+                  " C:" + String(toFloat(acceleration)) +
+                  " V:" + String(toFloat(verticalVelocity)));
   }
 } SensorData;
 
-typedef enum {
-  kReadyToFly,
-  kInFlight,
-  kAscending,
-  kDescending,
-  kOnGround
-} FlightState;
-
-inline String flightStateString(FlightState s)
+inline const char *flightStateString(FlightState s)
 {
   switch (s) {
     case kReadyToFly:
-      return String("Ready");
-      break;
+      return "Ready";
     case kInFlight:
-      return String("In Flight");
-      break;
+      return "In Flight";
     case kAscending:
-      return String("Ascending");
-      break;
+      return "Ascending";
     case kDescending:
-      return String("Descending");
-      break;
+      return "Descending";
     case kOnGround:
-      return String("On Ground");
-      break;
+      return "On Ground";
   }
+  return "";
 }
 
-typedef enum { kNone, kActive, kPassive } PeizoStyle;
-
 struct StatusData {
   uint8_t deploymentAlt;
   FlightState status;
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Downloads and unpacks every flight from a ComplexAltimeter.
+
+/export on the altimeter streams a tar archive of the flight index and the
+raw flight files.  This fetches it (or reads a saved copy), unpacks it and
+optionally converts each flight to CSV with flightlog_decode.
+
+--flight fetches a single raw flight from /raw instead, resuming with range
+requests if the connection drops, which it will on a busy launch field.
+
+Usage:
+    flight_export.py [--host 192.4.0.1 | --archive flights.tar]
+                     [--out DIR] [--csv] [--save flights.tar]
+    flight_export.py [--host 192.4.0.1] --flight N [--out DIR] [--csv]
+"""
+
+import argparse
+import http.client
+import io
+import os
+import socket
+import sys
+import tarfile
+import time
+import urllib.error
+import urllib.request
+
+import flightlog_decode
+
+DEFAULT_HOST = '192.4.0.1'
+
+
+def fetch(host, timeout):
+    url = 'http://%s/export' % host
+    sys.stderr.write('Fetching %s\n' % url)
+    with urllib.request.urlopen(url, timeout=timeout) as response:
+        return response.read()
+
+
+def fetch_flight(host, index, path, timeout, retries=20):
+    """Downloads flight |index| to |path|, resuming a partial file."""
+    url = 'http://%s/raw?flight=%d' % (host, index)
+    for attempt in range(retries):
+        have = os.path.getsize(path) if os.path.exists(path) else 0
+        request = urllib.request.Request(url)
+        if have:
+            request.add_header('Range', 'bytes=%d-' % have)
+        try:
+            with urllib.request.urlopen(request, timeout=timeout) as response:
+                # A 200 means the server sent the whole file again
+                mode = 'ab' if response.status == 206 else 'wb'
+                length = int(response.headers.get('Content-Length', -1))
+                received = 0
+                with open(path, mode) as f:
+                    while True:
+                        chunk = response.read(4096)
+                        if not chunk:
+                            break
+                        f.write(chunk)
+                        received += len(chunk)
+                # A dropped connection can look like a clean end of file
+                if length >= 0 and received < length:
+                    raise ConnectionError('short read')
+            return os.path.getsize(path)
+        except urllib.error.HTTPError as e:
+            if e.code == 416:
+                return have  # Already complete
+            raise
+        except (urllib.error.URLError, http.client.HTTPException,
+                ConnectionError, socket.timeout) as e:
+            sys.stderr.write('Dropped at %d bytes (%s), resuming\n' %
+                             (os.path.getsize(path) if os.path.exists(path)
+                              else 0, e))
+            time.sleep(1)
+    raise IOError('gave up on %s after %d attempts' % (url, retries))
+
+
+def to_csv(path):
+    try:
+        channels, blocks, _ = flightlog_decode.read_flight(path)
+    except ValueError:
+        # Flights from older firmware were stored as javascript
+        sys.stderr.write('%s is not a binary flight file\n' % path)
+        return
+    with open(path + '.csv', 'w') as out:
+        flightlog_decode.write_csv(out, channels, blocks)
+
+
+def unpack(data, out_dir, csv):
+    """Extracts the archive into |out_dir|.  Returns the flight file paths."""
+    flights = []
+    with tarfile.open(fileobj=io.BytesIO(data), mode='r:') as tar:
+        for member in tar.getmembers():
+            # Only plain files with relative names are expected
+            name = os.path.normpath(member.name)
+            if not member.isfile() or name.startswith(('/', '..')):
+                sys.stderr.write('Skipping %s\n' % member.name)
+                continue
+            path = os.path.join(out_dir, name)
+            os.makedirs(os.path.dirname(path) or '.', exist_ok=True)
+            with open(path, 'wb') as f:
+                f.write(tar.extractfile(member).read())
+            if name.startswith('flights' + os.sep):
+                flights.append(path)
+
+    if csv:
+        for path in sorted(flights):
+            to_csv(path)
+    return flights
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    source = parser.add_mutually_exclusive_group()
+    source.add_argument('--host', default=DEFAULT_HOST,
+                        help='altimeter address (default %s)' % DEFAULT_HOST)
+    source.add_argument('--archive', help='unpack a saved archive instead')
+    parser.add_argument('--out', default='.', help='directory to unpack to')
+    parser.add_argument('--csv', action='store_true',
+                        help='also write <flight>.csv for each flight')
+    parser.add_argument('--save', help='keep a copy of the downloaded archive')
+    parser.add_argument('--flight', type=int,
+                        help='fetch just this flight, resuming if dropped')
+    parser.add_argument('--timeout', type=float, default=30)
+    args = parser.parse_args()
+
+    if args.flight is not None:
+        os.makedirs(args.out, exist_ok=True)
+        path = os.path.join(args.out, 'flight%d.oaf' % args.flight)
+        size = fetch_flight(args.host, args.flight, path, args.timeout)
+        sys.stderr.write('%s: %d bytes\n' % (path, size))
+        if args.csv:
+            to_csv(path)
+        return
+
+    if args.archive:
+        with open(args.archive, 'rb') as f:
+            data = f.read()
+    else:
+        data = fetch(args.host, args.timeout)
+        if args.save:
+            with open(args.save, 'wb') as f:
+                f.write(data)
+
+    flights = unpack(data, args.out, args.csv)
+    sys.stderr.write('%d flights in %d bytes\n' % (len(flights), len(data)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""Decodes a ComplexAltimeter flight file (/flights/<n> in SPIFFS).
+
+The file starts with a header and the channel schema, followed by fixed size
+blocks of tagged, delta encoded frames (see src/SampleCodec.hpp) and ends
+with the flight summary as text.  The schema in the file is all that's
+needed to decode it, so this works for any channel layout.
+
+Event channels (decimation 0xFF) may appear several times in a tick and are
+left out of the CSV.  --events lists them instead.
+
+Usage:
+    flightlog_decode.py <flight file> [--csv out.csv] [--channel NAME]...
+                        [--block N] [--summary] [--events]
+"""
+
+import argparse
+import struct
+import sys
+
+HEADER = struct.Struct('<4sHHB3x')
+CHANNEL = struct.Struct('<fBB10s')
+MAGIC = b'OAF2'
+BLOCK_MAGIC = 0xB6
+TIME_TAG = 0
+ON_EVENT = 0xFF
+
+# FlightEventType in src/EventLog.hpp
+EVENT_NAMES = ['None', 'Armed', 'Launch (acc)', 'Launch (alt)', 'Burnout',
+               'Descending', 'Deploy', 'Deploy off', 'Landed', 'Failsafe',
+               'Baro lockout', 'Baro release', 'State', 'Launch (velocity)']
+EVENT_STATE = 12
+
+# FlightState in src/types.h
+STATE_NAMES = ['Ready', 'In flight', 'Ascending', 'Descending', 'On ground']
+
+
+class Channel(object):
+    def __init__(self, raw):
+        self.resolution, self.components, self.decimation, name = \
+            CHANNEL.unpack(raw)
+        self.name = name.split(b'\0', 1)[0].decode()
+        self.is_event = self.decimation == ON_EVENT
+
+    def columns(self):
+        if self.components == 1:
+            return [self.name]
+        return ['%s%d' % (self.name, i) for i in range(self.components)]
+
+
+def read_varint(block, pos):
+    value = shift = 0
+    while True:
+        b = block[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return (value >> 1) ^ -(value & 1), pos
+
+
+def decode_block(block, channels):
+    """Yields (time_ms, {channel index: [values]}, [(channel, [values])])
+    for each tick.  Event channels are only in the list."""
+    if block[0] != BLOCK_MAGIC:
+        raise ValueError('not a sample block')
+    ticks, = struct.unpack_from('<H', block, 2)
+    previous = [[0] * c.components for c in channels]
+    pos = 4
+    tick = None
+    seen = 0
+    while pos < len(block):
+        tag = block[pos]
+        if tag == TIME_TAG:
+            if tick is not None:
+                yield tick
+            if seen == ticks:
+                return
+            seen += 1
+        pos += 1
+        values = previous[tag]
+        for i in range(len(values)):
+            delta, pos = read_varint(block, pos)
+            values[i] += delta
+        if tag == TIME_TAG:
+            tick = (values[0], {}, [])
+        elif channels[tag].is_event:
+            tick[2].append((tag, list(values)))
+        else:
+            tick[1][tag] = list(values)
+    if tick is not None:
+        yield tick
+
+
+def read_flight(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    magic, header_size, block_size, count = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise ValueError('%s is not a flight file' % path)
+    channels = [Channel(data[HEADER.size + i * CHANNEL.size:
+                             HEADER.size + (i + 1) * CHANNEL.size])
+                for i in range(count)]
+    blocks = []
+    pos = header_size
+    while pos + block_size <= len(data) and data[pos] == BLOCK_MAGIC:
+        blocks.append(data[pos:pos + block_size])
+        pos += block_size
+    summary = data[pos:].decode(errors='replace').strip()
+    return channels, blocks, summary
+
+
+def state_name(state):
+    return (STATE_NAMES[state] if state < len(STATE_NAMES)
+            else 'State %d' % state)
+
+
+def print_events(channels, blocks):
+    """Events are (micros, type, arg, altitude in dm).  The event time is
+    relative to the first one, which is normally when the altimeter armed."""
+    start = None
+    for block in blocks:
+        for time_ms, _, events in decode_block(block, channels):
+            for tag, (us, kind, arg, alt) in events:
+                us &= 0xFFFFFFFF
+                start = us if start is None else start
+                name = (EVENT_NAMES[kind] if kind < len(EVENT_NAMES)
+                        else 'Event %d' % kind)
+                if kind == EVENT_STATE:
+                    name = '%s>%s' % (state_name(arg >> 4),
+                                      state_name(arg & 0xF))
+                sys.stdout.write('%12.6f  %-22s arg %-3d alt %8.1f  tick %d\n'
+                                 % (((us - start) & 0xFFFFFFFF) / 1e6, name,
+                                    arg, alt * channels[tag].resolution / 10,
+                                    time_ms))
+
+
+def write_csv(out, channels, blocks, names=None):
+    """Writes one row per tick.  |names| limits the channels written."""
+    wanted = [i for i, c in enumerate(channels)
+              if i != TIME_TAG and not c.is_event and
+              (not names or c.name in names)]
+    out.write(','.join(['time_ms'] +
+                       sum((channels[i].columns() for i in wanted), [])) +
+              '\n')
+    # Channels logged at lower rates are carried forward between samples
+    last = {i: [''] * channels[i].components for i in wanted}
+    for block in blocks:
+        for time_ms, frames, _ in decode_block(block, channels):
+            for i in wanted:
+                if i in frames:
+                    res = channels[i].resolution
+                    last[i] = ['%g' % round(v * res, 6) for v in frames[i]]
+            out.write(','.join([str(time_ms)] +
+                               sum((last[i] for i in wanted), [])) + '\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('file')
+    parser.add_argument('--csv', help='write CSV here instead of stdout')
+    parser.add_argument('--channel', action='append',
+                        help='only output these channels')
+    parser.add_argument('--block', type=int,
+                        help='only decode this block')
+    parser.add_argument('--summary', action='store_true',
+                        help='print the schema and flight summary')
+    parser.add_argument('--events', action='store_true',
+                        help='list the flight events instead of the samples')
+    args = parser.parse_args()
+
+    channels, blocks, summary = read_flight(args.file)
+    if args.summary:
+        for i, c in enumerate(channels):
+            rate = ('event' if c.is_event else
+                    'every %d' % c.decimation if c.decimation else 'change')
+            sys.stderr.write('%2d %-8s x%d res %g %s\n' %
+                             (i, c.name, c.components, c.resolution, rate))
+        sys.stderr.write('%d blocks\n%s\n' % (len(blocks), summary))
+
+    if args.block is not None:
+        blocks = blocks[args.block:args.block + 1]
+
+    if args.events:
+        print_events(channels, blocks)
+        return
+
+    out = open(args.csv, 'w') if args.csv else sys.stdout
+    write_csv(out, channels, blocks, args.channel)
+    if args.csv:
+        out.close()
+
+
+if __name__ == '__main__':
+    main()
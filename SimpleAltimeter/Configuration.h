@@ -29,6 +29,20 @@
 
 #include "types.h"
 
+// The parts each pin configuration picks from.  See Board.hpp.  Outputs
+// are OutputPins, or NoOutput where the board doesn't have one, and each
+// chute is a RecoveryChannel over the output it drives.  Anything that isn't
+// fitted compiles to nothing.
+class Adafruit_BMP085;
+class Adafruit_BMP280;
+class MPU9250;
+class EepromTraceStorage;
+class SpiFlashTraceStorage;
+template <typename Output>
+class RecoveryChannel;
+template <uint8_t Pin>
+class ServoOutput;
+
 #define LOG_TO_SERIAL 1  // Set to 0 to disable serial logging...
 #define PLOT_ALTITUDE 1  // Set to 1 to watch the altitude on the serial plotter
 
@@ -69,96 +83,104 @@ const int MAX_FIRE_TIME = 5000;
 #if USE_PIN_CONFIG_1
 // Configuration A: 1 1/2" PCB - No deployment
 const int SERIAL_BAUD_RATE = 9600;
-const int STATUS_PIN = 4;    // Unit status pin.  On if OK
-const int MESSAGE_PIN = 2;   // Blinks out the altitude
-const int READY_PIN   = 13;  // Indicates the unit is ready for flight
-const int BUZZER_PIN = 8;    // Audible buzzer on landing
 const int RESET_PIN  = 6;
 const int TEST_PIN   = 7;
-const int MAIN_DEPL_RELAY_PIN = 12;    // parachute deployment pin
-const int DROGUE_DEPL_RELAY_PIN = 11;  // parachute deployment pin
 const int ALT_PIN_A             = 9;   // Main Chute Altitude Altitude Set Pin.
 const int ALT_PIN_B             = 10;  // Main Chute Altitude Altitude Set Pin
-const RecoveryDeviceType MAIN_TYPE   = kPyro;
-const RecoveryDeviceType DROGUE_TYPE = kPyro;
 const int BARO_I2C_ADDR          = 0x77;
 const PeizoStyle PEIZO_TYPE      = kActive;
-#define ENABLE_MPU 0
-#define USE_BMP085 0
-#define USE_BMP280 1
+
+struct BoardConfig : Board<Adafruit_BMP280, NoImu, EepromTraceStorage> {
+  typedef OutputPin<4> StatusPin;   // Unit status pin.  On if OK
+  typedef OutputPin<2> MessagePin;  // Blinks out the altitude
+  typedef OutputPin<13> ReadyPin;   // Indicates the unit is ready for flight
+  typedef OutputPin<8> BuzzerPin;   // Audible buzzer on landing
+  typedef RecoveryChannel<OutputPin<12>> MainChute;    // Pyro
+  typedef RecoveryChannel<OutputPin<11>> DrogueChute;  // Pyro
+};
 
 #elif USE_PIN_CONFIG_2
 // Configuration B: 2" PCB w. Servo Sled
 const int SERIAL_BAUD_RATE = 9600;
-const int STATUS_PIN = 4;   // Unit status pin.  On if OK
-const int MESSAGE_PIN = 5;  // Blinks out the altitude
-const int READY_PIN   = 6;  // Indicates the unit is ready for flight
-const int BUZZER_PIN = 3;   // Audible buzzer on landing
 const int RESET_PIN  = 7;
 const int TEST_PIN   = 12;
-const int MAIN_DEPL_RELAY_PIN = 11;    // parachute deployment pin
-const int DROGUE_DEPL_RELAY_PIN = 10;  // parachute deployment pin
 const int ALT_PIN_A = 8;               // Main Chute Altitude Set Pin.
 const int ALT_PIN_B = 9;               // Main Chute Altitude Set Pin
-const RecoveryDeviceType MAIN_TYPE   = kServo;
-const RecoveryDeviceType DROGUE_TYPE = kServo;
 const int BARO_I2C_ADDR          = 0x76;
 const PeizoStyle PEIZO_TYPE      = kPassive;
-#define ENABLE_MPU 0
-#define USE_BMP085 0
-#define USE_BMP280 1
+
+struct BoardConfig : Board<Adafruit_BMP280, NoImu, EepromTraceStorage> {
+  typedef OutputPin<4> StatusPin;   // Unit status pin.  On if OK
+  typedef OutputPin<5> MessagePin;  // Blinks out the altitude
+  typedef OutputPin<6> ReadyPin;    // Indicates the unit is ready for flight
+  typedef OutputPin<3> BuzzerPin;   // Audible buzzer on landing
+  typedef RecoveryChannel<ServoOutput<11>> MainChute;
+  typedef RecoveryChannel<ServoOutput<10>> DrogueChute;
+};
 
 #elif USE_PIN_CONFIG_3
 // Configuration B: Small PCB with servo pinout
 const int SERIAL_BAUD_RATE = 9600;
-const byte STATUS_PIN = 5;    // Unit status pin.  On if OK
-const byte MESSAGE_PIN = 3;   // Blinks out the altitude
-const byte READY_PIN   = 13;  // Indicates the unit is ready for flight
-const byte BUZZER_PIN = 2;    // Audible buzzer on landing
 const byte RESET_PIN           = 4;
 const byte TEST_PIN            = 10;
-const byte MAIN_DEPL_RELAY_PIN = 11;    // parachute deployment pin
-const char DROGUE_DEPL_RELAY_PIN = 12;  // parachute deployment pin
 const byte ALT_PIN_A = 8;               // Main Chute Altitude Set Pin.
 const byte ALT_PIN_B = 9;               // Main Chute Altitude Set Pin
-const RecoveryDeviceType MAIN_TYPE   = kServo;
-const RecoveryDeviceType DROGUE_TYPE = kNoEjection;
 #define BARO_I2C_ADDR
 #define STATUS_PIN_LEVEL 800
 const PeizoStyle PEIZO_TYPE      = kPassive;
-#define ENABLE_MPU 0
-#define USE_BMP085 0
-#define USE_BMP280 1
+
+struct BoardConfig : Board<Adafruit_BMP280, NoImu, EepromTraceStorage> {
+  typedef OutputPin<5> StatusPin;   // Unit status pin.  On if OK
+  typedef OutputPin<3> MessagePin;  // Blinks out the altitude
+  typedef OutputPin<13> ReadyPin;   // Indicates the unit is ready for flight
+  typedef OutputPin<2> BuzzerPin;   // Audible buzzer on landing
+  typedef RecoveryChannel<ServoOutput<11>> MainChute;
+  typedef RecoveryChannel<NoOutput> DrogueChute;
+};
 
 //The PWM function works on pins 3, 5, 6, 9, 10, and 1
 
 #elif USE_PIN_CONFIG_4
 //Tape backed
 const int SERIAL_BAUD_RATE     = 19200;
-const byte STATUS_PIN          = 13;
-const byte MESSAGE_PIN         = 9;  
-const byte READY_PIN           = 10;    
-const byte BUZZER_PIN          = 5;     
 const byte RESET_PIN           = 2;
 const byte TEST_PIN            = 7;
-const byte MAIN_DEPL_RELAY_PIN = 3;  
-const char DROGUE_DEPL_RELAY_PIN = NO_PIN;  
 const byte ALT_PIN_A = 11;              
 const byte ALT_PIN_B = 12;              
-const RecoveryDeviceType MAIN_TYPE   = kServo;
-const RecoveryDeviceType DROGUE_TYPE = kNoEjection;
 const int BARO_I2C_ADDR          = 0x76;  
 #define STATUS_PIN_LEVEL 800
 const PeizoStyle PEIZO_TYPE      = kPassive;
-#define ENABLE_MPU 0
-#define USE_BMP085 0
-#define USE_BMP280 1
+
+struct BoardConfig : Board<Adafruit_BMP280, NoImu, EepromTraceStorage> {
+  typedef OutputPin<13> StatusPin;
+  typedef OutputPin<9> MessagePin;
+  typedef OutputPin<10> ReadyPin;
+  typedef OutputPin<5> BuzzerPin;
+  typedef RecoveryChannel<ServoOutput<3>> MainChute;
+  typedef RecoveryChannel<NoOutput> DrogueChute;
+};
 
 #endif
 
 // The barometer can only refresh at about 50Hz.
 const byte SENSOR_READ_DELAY_MS = 30;
 
+// The altitude and acceleration trace of the last flight is recorded with
+// RECORDER_PRE_TRIGGER samples from before launch was detected.  It is kept
+// in the EEPROM after the flight journal (~640 bytes, around 40 seconds
+// at 1 in 4 samples) or, on a board with SpiFlashTraceStorage, in a W25Qxx
+// SPI flash.  Send 'd' over serial while on the ground to dump it.
+// tools/trace_decode.py decodes the dump.
+//
+// The flash uses the hardware SPI pins (11, 12 and 13 on a nano)
+const byte FLASH_CS_PIN         = 10;
+const uint32_t FLASH_TRACE_SIZE = 65536;
+const byte RECORDER_PRE_TRIGGER = 16;
+
+// Number of flight summaries kept in the EEPROM journal.  The journal
+// occupies the start of the EEPROM.  Older flights are overwritten.
+const byte JOURNAL_SLOTS = 12;
+
 // Delay between digit blinks.  Any faster is too quick to keep up with
 const short BLINK_SPEED_MS = 300;
 
@@ -0,0 +1,141 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "FlightJournal.h"
+#include <EEPROM.h>
+
+void FlightJournal::begin()
+{
+  Record r;
+  slotReads   = 0;
+  head        = -1;
+  nextSeq     = 0;
+  flightCount = 0;
+
+  if (readSlot(0, &r)) {
+    // Slots [0, lo] are in the first lap.  Find the last such slot.
+    uint16_t firstSeq = r.seq;
+    int lo            = 0;
+    int hi            = slotCount - 1;
+    while (lo < hi) {
+      int mid = (lo + hi + 1) / 2;
+      if (inFirstLap(mid, firstSeq)) {
+        lo = mid;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    head = lo;
+  } else if (readSlot(slotCount - 1, &r)) {
+    // Slot 0 is blank or was torn while wrapping.  The previous lap, if any,
+    // ended in the last slot.
+    head = slotCount - 1;
+  }
+
+  if (head >= 0) {
+    readSlot(head, &r);
+    nextSeq     = r.seq + 1;
+    flightCount = r.type == kFlightRecord ? r.flightNumber : 0;
+  }
+  bootReads = slotReads;
+}
+
+bool FlightJournal::inFirstLap(int slot, uint16_t firstSeq)
+{
+  Record r;
+  return readSlot(slot, &r) && (uint16_t)(r.seq - firstSeq) == slot;
+}
+
+int FlightJournal::append(const FlightData &d)
+{
+  flightCount++;
+  writeRecord(kFlightRecord, d);
+  return flightCount;
+}
+
+void FlightJournal::wipe()
+{
+  FlightData empty{};
+  flightCount = 0;
+  writeRecord(kWipeRecord, empty);
+}
+
+bool FlightJournal::read(int age, FlightData *d, int *flightNumber)
+{
+  if (age < 0 || age >= flightCount || age >= slotCount) {
+    return false;
+  }
+
+  Record r;
+  int slot = (head - age + slotCount) % slotCount;
+  if (!readSlot(slot, &r) || r.type != kFlightRecord ||
+      (uint16_t)(nextSeq - 1 - r.seq) != age) {
+    return false;
+  }
+
+  *d            = r.data;
+  *flightNumber = r.flightNumber;
+  return true;
+}
+
+void FlightJournal::writeRecord(RecordType type, const FlightData &d)
+{
+  Record r;
+  r.seq          = nextSeq++;
+  r.type         = type;
+  r.flightNumber = flightCount;
+  r.data         = d;
+  r.crc          = crc8((const uint8_t *)&r, offsetof(Record, crc));
+
+  head = (head + 1) % slotCount;
+  // put() only rewrites bytes that have changed
+  EEPROM.put(slotAddress(head), r);
+}
+
+bool FlightJournal::readSlot(int slot, Record *r)
+{
+  slotReads++;
+  EEPROM.get(slotAddress(slot), *r);
+  return (r->type == kFlightRecord || r->type == kWipeRecord) &&
+         r->crc == crc8((const uint8_t *)r, offsetof(Record, crc));
+}
+
+// The default seed means a zeroed slot doesn't checksum to zero
+uint8_t FlightJournal::crc8(const uint8_t *data, size_t len, uint8_t crc)
+{
+  while (len--) {
+    uint8_t b = *data++;
+    for (byte i = 0; i < 8; i++) {
+      uint8_t mix = (crc ^ b) & 0x01;
+      crc >>= 1;
+      if (mix) {
+        crc ^= 0x8C;
+      }
+      b >>= 1;
+    }
+  }
+  return crc;
+}
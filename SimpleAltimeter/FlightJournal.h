@@ -0,0 +1,104 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef FLIGHTJOURNAL_H
+#define FLIGHTJOURNAL_H
+
+#include "types.h"
+
+// Round-robin journal of flight summaries in EEPROM.
+//
+// Each slot holds one record tagged with a 16 bit sequence number and a CRC.
+// Records are written to consecutive slots, wrapping at the end of the
+// region, so every cell sees 1/nth of the writes.  Within the current lap
+// slot i holds sequence seq[0] + i; the first slot that breaks that run (or
+// fails its CRC) is the next one to be written, so the head is found with a
+// binary search over the slots instead of reading them all.
+//
+// Wiping the journal writes a single marker record.  Anything older than the
+// most recent marker is treated as erased and is overwritten as the journal
+// wraps.
+class FlightJournal
+{
+ public:
+  FlightJournal(int baseAddress, byte slotCount)
+      : baseAddress(baseAddress), slotCount(slotCount){};
+
+  // Locates the head of the journal.  Must be called before anything else.
+  void begin();
+
+  // Appends a flight summary and returns its flight number
+  int append(const FlightData &d);
+
+  // Erases all the flights by writing a wipe marker
+  void wipe();
+
+  // The number of flights recorded since the last wipe
+  int getFlightCount() { return flightCount; }
+
+  // Reads the flight recorded |age| flights ago (0 is the most recent).
+  // Returns false if there is no such flight.
+  bool read(int age, FlightData *d, int *flightNumber);
+
+  // Number of slots read when locating the head in begin()
+  byte getBootReads() { return bootReads; }
+
+  // Size in bytes of the EEPROM region used by a journal of |slots| slots
+  static int regionSize(byte slots) { return slots * sizeof(Record); }
+
+  // Dallas/Maxim CRC8.  Pass the previous result as |crc| to continue a CRC
+  // over several buffers.
+  static uint8_t crc8(const uint8_t *data, size_t len, uint8_t crc = 0xA5);
+
+ private:
+  typedef enum : uint8_t { kEmptyRecord, kFlightRecord, kWipeRecord } RecordType;
+
+  typedef struct {
+    uint16_t seq;
+    uint16_t flightNumber;
+    uint8_t type;
+    FlightData data;
+    uint8_t crc;
+  } Record;
+
+  int baseAddress;
+  byte slotCount;
+
+  int head         = -1;  // Slot of the newest record.  -1 if empty
+  uint16_t nextSeq = 0;
+  int flightCount  = 0;
+  byte bootReads   = 0;
+  byte slotReads   = 0;
+
+  bool readSlot(int slot, Record *r);
+  void writeRecord(RecordType type, const FlightData &d);
+  int slotAddress(int slot) { return baseAddress + slot * sizeof(Record); }
+
+  // True if slot i was written in the same lap as slot 0
+  bool inFirstLap(int slot, uint16_t firstSeq);
+};
+
+#endif  // FLIGHTJOURNAL_H
@@ -0,0 +1,297 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "FlightRecorder.h"
+#include "FlightJournal.h"
+
+// A zig-zag varint of a 17 bit delta is at most 3 bytes
+#define kMaxVarintBytes 3
+#define kMaxSampleBytes (2 * kMaxVarintBytes)
+
+// Header slots
+#define kOpenSlot 0
+#define kFinalSlot 1
+#define kDataStart (2 * sizeof(TraceHeader))
+
+static int16_t toFixed(double value, double scale)
+{
+  return constrain((long)(value * scale), -32768L, 32767L);
+}
+
+void FlightRecorder::arm()
+{
+  storage.prepare();
+
+  state           = kArmed;
+  flags           = 0;
+  ringHead        = 0;
+  ringCount       = 0;
+  preTrigger      = 0;
+  decimationCount = 0;
+  last            = TraceSample{0, 0};
+  sampleCount     = 0;
+  fifoHead        = 0;
+  fifoCount       = 0;
+  writeAddress    = kDataStart;
+  headerPending   = 0;
+}
+
+void FlightRecorder::sample(double altitude, double acceleration)
+{
+  if (state == kIdle) {
+    return;
+  }
+  if (++decimationCount < storage.decimation()) {
+    return;
+  }
+  decimationCount = 0;
+
+  TraceSample s = {toFixed(altitude, 10), toFixed(acceleration, 100)};
+
+  if (ringCount < RECORDER_PRE_TRIGGER) {
+    ring[(ringHead + ringCount) % RECORDER_PRE_TRIGGER] = s;
+    ringCount++;
+    return;
+  }
+
+  // The ring is full.  The oldest sample either falls out of the pre-trigger
+  // window or, once triggered, is written.
+  if (state == kRecording) {
+    encode(ring[ringHead]);
+  }
+  ring[ringHead] = s;
+  ringHead       = (ringHead + 1) % RECORDER_PRE_TRIGGER;
+}
+
+void FlightRecorder::trigger()
+{
+  if (state != kArmed) {
+    return;
+  }
+  state      = kRecording;
+  preTrigger = ringCount;
+
+  // Length, count and flight number are left erased until finish()
+  makeHeader(openHeader, 0xFFFF);
+  openHeader.flags       = kOpen;
+  openHeader.sampleCount = 0xFFFF;
+  openHeader.dataLength  = 0xFFFFFFFF;
+  openHeader.crc         = 0;
+  openHeader.crc =
+      FlightJournal::crc8((const uint8_t *)&openHeader, sizeof(openHeader));
+  headerPending = sizeof(openHeader);
+}
+
+void FlightRecorder::makeHeader(TraceHeader &h, uint16_t flightNumber)
+{
+  h.magic          = kMagic;
+  h.version        = kVersion;
+  h.flags          = flags;
+  h.samplePeriodMs = SENSOR_READ_DELAY_MS * storage.decimation();
+  h.sampleCount    = sampleCount;
+  h.flightNumber   = flightNumber;
+  h.preTrigger     = preTrigger;
+  h.crc            = 0;
+  h.dataLength     = writeAddress - kDataStart;
+}
+
+void FlightRecorder::finish(uint16_t flightNumber)
+{
+  if (state != kRecording) {
+    return;
+  }
+
+  flush();
+  while (ringCount) {
+    encode(ring[ringHead]);
+    ringHead = (ringHead + 1) % RECORDER_PRE_TRIGGER;
+    ringCount--;
+    flush();
+  }
+
+  TraceHeader h;
+  makeHeader(h, flightNumber);
+  h.crc = FlightJournal::crc8((const uint8_t *)&h, sizeof(h));
+  storage.writeAll(kFinalSlot * sizeof(h), (const uint8_t *)&h, sizeof(h));
+
+  state = kIdle;
+}
+
+void FlightRecorder::service()
+{
+  // The open header goes first so there's never data without one
+  while (headerPending) {
+    uint8_t done = sizeof(openHeader) - headerPending;
+    size_t n     = storage.write(kOpenSlot * sizeof(openHeader) + done,
+                                 (const uint8_t *)&openHeader + done,
+                                 headerPending);
+    if (!n) {
+      return;
+    }
+    headerPending -= n;
+  }
+
+  while (fifoCount) {
+    // Write up to the end of the FIFO buffer, the rest goes next time round
+    size_t n = kFifoSize - fifoHead;
+    if (n > fifoCount) {
+      n = fifoCount;
+    }
+    n = storage.write(writeAddress, fifo + fifoHead, n);
+    if (!n) {
+      return;
+    }
+    writeAddress += n;
+    fifoHead = (fifoHead + n) & (kFifoSize - 1);
+    fifoCount -= n;
+  }
+}
+
+void FlightRecorder::flush()
+{
+  while (headerPending || fifoCount) {
+    service();
+  }
+}
+
+void FlightRecorder::encode(const TraceSample &s)
+{
+  if (flags & kTruncated) {
+    return;
+  }
+  // Stop rather than drop samples from the middle of the delta stream
+  if (kFifoSize - fifoCount < kMaxSampleBytes ||
+      writeAddress + fifoCount + kMaxSampleBytes > storage.capacity()) {
+    flags |= kTruncated;
+    return;
+  }
+
+  push((int32_t)s.altitude - last.altitude);
+  push((int32_t)s.acceleration - last.acceleration);
+  last = s;
+  sampleCount++;
+}
+
+void FlightRecorder::push(int32_t delta)
+{
+  uint32_t v = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+  do {
+    uint8_t b = v & 0x7F;
+    v >>= 7;
+    if (v) {
+      b |= 0x80;
+    }
+    fifo[(fifoHead + fifoCount) & (kFifoSize - 1)] = b;
+    fifoCount++;
+  } while (v);
+}
+
+bool FlightRecorder::readHeader(uint8_t slot, TraceHeader &h)
+{
+  storage.read(slot * sizeof(h), (uint8_t *)&h, sizeof(h));
+  uint8_t crc = h.crc;
+  h.crc       = 0;
+  bool valid  = h.magic == kMagic && h.version == kVersion &&
+               crc == FlightJournal::crc8((const uint8_t *)&h, sizeof(h));
+  h.crc = crc;
+  return valid;
+}
+
+// Walks the samples of an open trace up to the first one that isn't
+// complete.  Storage past the end is erased and an erased byte starts a
+// varint that's too long to be real.
+void FlightRecorder::recover(TraceHeader &h)
+{
+  uint32_t end      = storage.capacity() - kDataStart;
+  uint32_t length   = 0;
+  uint32_t offset   = 0;
+  uint16_t samples  = 0;
+  uint8_t varints   = 0;
+  uint8_t varintLen = 0;
+  uint8_t chunk[kDumpChunk];
+
+  while (offset < end && samples < 0xFFFF) {
+    uint8_t len = min((uint32_t)kDumpChunk, end - offset);
+    storage.read(kDataStart + offset, chunk, len);
+    for (uint8_t i = 0; i < len; i++) {
+      if (++varintLen > kMaxVarintBytes) {
+        offset = end;
+        break;
+      }
+      if (chunk[i] & 0x80) {
+        continue;
+      }
+      varintLen = 0;
+      if (++varints == 2) {
+        varints = 0;
+        samples++;
+        length = offset + i + 1;
+      }
+    }
+    offset += len;
+  }
+
+  h.sampleCount = samples;
+  h.dataLength  = length;
+  h.crc         = 0;
+  h.crc         = FlightJournal::crc8((const uint8_t *)&h, sizeof(h));
+}
+
+void FlightRecorder::dump(Print &out)
+{
+  TraceHeader h;
+  bool valid = readHeader(kFinalSlot, h);
+  if (!valid && readHeader(kOpenSlot, h) && (h.flags & kOpen)) {
+    recover(h);
+    valid = true;
+  }
+
+  if (valid && h.dataLength <= storage.capacity() - kDataStart) {
+    writeFrame(out, 'H', (const uint8_t *)&h, sizeof(h));
+
+    uint8_t chunk[sizeof(uint32_t) + kDumpChunk];
+    for (uint32_t offset = 0; offset < h.dataLength; offset += kDumpChunk) {
+      uint8_t len = min((uint32_t)kDumpChunk, h.dataLength - offset);
+      memcpy(chunk, &offset, sizeof(offset));
+      storage.read(kDataStart + offset, chunk + sizeof(offset), len);
+      writeFrame(out, 'D', chunk, sizeof(offset) + len);
+    }
+  }
+  writeFrame(out, 'E', nullptr, 0);
+}
+
+void FlightRecorder::writeFrame(Print &out, uint8_t type, const uint8_t *data,
+                                uint8_t len)
+{
+  uint8_t prefix[] = {type, len};
+  uint8_t crc      = FlightJournal::crc8(prefix, sizeof(prefix));
+  crc              = FlightJournal::crc8(data, len, crc);
+
+  out.write(0x7E);
+  out.write(prefix, sizeof(prefix));
+  out.write(data, len);
+  out.write(crc);
+}
@@ -0,0 +1,141 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef FLIGHTRECORDER_H
+#define FLIGHTRECORDER_H
+
+#include "Configuration.h"
+#include "TraceStorage.h"
+
+// Records the altitude and acceleration trace of a flight.
+//
+// Every storage.decimation()'th sample goes through a ring of
+// RECORDER_PRE_TRIGGER samples.  On the pad the ring just holds the most
+// recent samples.  Once triggered it acts as a delay line so the samples
+// leading up to launch are the first ones written.  Samples are stored as
+// zig-zag varint deltas (altitude in dm, acceleration in centi-g), usually
+// two bytes per sample.  The encoded bytes are queued in a small FIFO and
+// written to storage from service() without blocking.
+//
+// The storage starts with two TraceHeader slots.  trigger() queues an open
+// header for the first slot, written ahead of the data, so a reset or
+// brown-out in flight still leaves a trace.  finish() writes the final
+// header to the second slot.  Flash can only clear bits, so the open header
+// is never rewritten.  dump() sends the final header if there is one.
+// Otherwise it recovers an open trace by reading up to the first sample that
+// runs into erased (0xFF) storage.  Only the most recent flight is kept:
+// arm() discards the previous trace.
+class FlightRecorder
+{
+ public:
+  FlightRecorder(TraceStorage &storage) : storage(storage){};
+
+  // Discards any previous trace and starts filling the pre-trigger ring.
+  // May block while flash is erased.
+  void arm();
+
+  // Called for each flight control sample
+  void sample(double altitude, double acceleration);
+
+  // Launch detected.  Starts writing the trace.
+  void trigger();
+
+  // Flushes the trace and writes the final header.  Blocks.
+  void finish(uint16_t flightNumber);
+
+  // Moves queued bytes to storage.  Call from loop().
+  void service();
+
+  // Writes the stored trace to |out| as a sequence of frames:
+  //   0x7E, type, payload length, payload, crc8(type, length, payload)
+  // 'H' carries the TraceHeader, each 'D' a 32 bit offset and up to
+  // kDumpChunk bytes of trace data, and 'E' ends the dump.  A recovered
+  // trace's header keeps kOpen, with the length and count it was read to.
+  void dump(Print &out);
+
+  bool isRecording() { return state == kRecording; }
+
+ private:
+  typedef enum { kIdle, kArmed, kRecording } RecorderState;
+
+  typedef struct {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t flags;
+    uint16_t samplePeriodMs;
+    uint16_t sampleCount;
+    uint16_t flightNumber;
+    uint8_t preTrigger;
+    uint8_t crc;
+    uint32_t dataLength;
+  } TraceHeader;
+
+  typedef struct {
+    int16_t altitude;
+    int16_t acceleration;
+  } TraceSample;
+
+  static const uint16_t kMagic    = 0x544F;  // "OT"
+  static const uint8_t kVersion   = 2;
+  static const uint8_t kTruncated = 0x01;
+  static const uint8_t kOpen      = 0x02;  // No final header was written
+  static const uint8_t kFifoSize  = 32;  // Must be a power of two
+  static const uint8_t kDumpChunk = 32;
+
+  TraceStorage &storage;
+  RecorderState state = kIdle;
+  uint8_t flags       = 0;
+
+  TraceSample ring[RECORDER_PRE_TRIGGER];
+  uint8_t ringHead        = 0;
+  uint8_t ringCount       = 0;
+  uint8_t preTrigger      = 0;
+  uint8_t decimationCount = 0;
+
+  TraceSample last;
+  uint16_t sampleCount = 0;
+
+  uint8_t fifo[kFifoSize];
+  uint8_t fifoHead      = 0;
+  uint8_t fifoCount     = 0;
+  uint32_t writeAddress = 0;
+
+  TraceHeader openHeader;
+  uint8_t headerPending = 0;  // Bytes of openHeader still to write
+
+  void makeHeader(TraceHeader &h, uint16_t flightNumber);
+  bool readHeader(uint8_t slot, TraceHeader &h);
+  void recover(TraceHeader &h);
+
+  void encode(const TraceSample &s);
+  void push(int32_t delta);
+  void flush();
+
+  void writeFrame(Print &out, uint8_t type, const uint8_t *data,
+                  uint8_t len);
+};
+
+#endif  // FLIGHTRECORDER_H
@@ -2,34 +2,41 @@
 #define SIMPLE_ALT_H
 
 
+#include <AltimeterCore.h>
 #include <EEPROM.h>
 #include <Servo.h>
 #include "Configuration.h"
 
-// Sensor libraries
-#if USE_BMP280
-#include "Adafruit_BMP280.h"  //https://github.com/adafruit/Adafruit_BMP280_Library/blob/master/Adafruit_BMP280.h
-typedef Adafruit_BMP280 Barometer;
-const double SEA_LEVEL_PRESSURE = 1013.7;
-#endif
+// Sensor libraries.  The board's BoardConfig picks the ones that are used.
+#include <Blinker.hpp>
+#include <RecoveryDevice.h>
+#include <SimpleTimer.h>
+#include <TimerSource.hpp>
+#include <drivers/Adafruit_BMP280.h>
+#include <drivers/MPU9250.h>
+#include <drivers/MahonyAHRS.h>
+#include "Adafruit_BMP085.h"
 
-#if USE_BMP085
-#include "Adafruit_BMP085.h"  //https://github.com/adafruit/Adafruit_BMP280_Library/blob/master/Adafruit_BMP085.h
-typedef Adafruit_BMP085 Barometer;
-const double SEA_LEVEL_PRESSURE = 101370;
-#endif
+// Today's pressure at sea level, in the units each barometer works in
+template <typename Barometer>
+struct SeaLevel;
 
-#if ENABLE_MPU
-#include "MPU9250.h"
-#include "MahonyAHRS.h"
-typedef MPU9250 ImuSensor;
-#endif
+template <>
+struct SeaLevel<Adafruit_BMP280> {
+  static constexpr double kPressure = 1013.7;  // hPa
+};
 
-#include "Filters.hpp"
-#include "SimpleTimer.h"
+template <>
+struct SeaLevel<Adafruit_BMP085> {
+  static constexpr double kPressure = 101370;  // Pa
+};
 
-#include "Blinker.hpp"
-#include "RecoveryDevice.h"
+const double SEA_LEVEL_PRESSURE = SeaLevel<BoardConfig::Barometer>::kPressure;
+
+typedef SelectType<BoardConfig::kHasImu, Mahony, NoFusion>::type SensorFusion;
+
+#include "FlightJournal.h"
+#include "FlightRecorder.h"
 #include "types.h"
 
 void playReadyTone();
@@ -43,13 +50,25 @@ void flightControllInterrupt();
 void readSensorData(SensorData *d);
 void flightControl(SensorData *d);
 
+// The guards and actions of the flight phases.  See FlightPhases.hpp
+// in AltimeterCore.
+struct FlightHandlers {
+  static bool isLaunched(ControlTick &t);
+  static void onLaunch(ControlTick &t);
+  static bool isPastApogee(ControlTick &t);
+  static void onApogee(ControlTick &t);
+  static bool isLanded(ControlTick &t);
+  static void onLanding(ControlTick &t);
+};
+void stampTransition(ControlTick &t, FlightState from, FlightState to);
+
 void setRecoveryDeviceState(RecoveryDeviceState deviceState, RecoveryDevice *c);
 
 void testFlightData(SensorData *d);
 
 void logData(int index, FlightData *d);
-bool isValid(FlightData *d);
 void configureEeprom();
+void logFlights();
 
 
 #endif
@@ -26,6 +26,7 @@
 
 #define VERSION 3
 
+#include <AltimeterCore.h>
 #include "SimpleAltimeter.h"
 
 /////////////////////////////////////////////////////////////////
@@ -34,29 +35,42 @@
 FlightData flightData;
 FlightState flightState = kOnGround;  // The flight state
 
-RecoveryDevice mainChute;
-RecoveryDevice drogueChute;
+// The table is in AltimeterCore's FlightPhases.hpp
+typedef FlightPhases<FlightState, ControlTick, FlightHandlers> Phases;
+constexpr FlightStateMachine<FlightState, ControlTick> kFlightStates(
+    Phases::kFlightTransitions, stampTransition);
+
+ControlTick tick;
+
+BoardConfig::MainChute mainChute;
+BoardConfig::DrogueChute drogueChute;
 
 double refAltitude = 0;  // The reference altitude (altitude of the launch pad)
-int flightCount    = 0;  // The number of flights recorded in EEPROM
 int resetTime      = 0;  // millis() after starting the current flight
 double deploymentAltitude = 100;  // Deployment altitude in m.
 int testFlightTimeStep    = 0;
 
-Barometer barometer;
-#if ENABLE_MPU
-ImuSensor imu(Wire, 0x68);
-#endif
+FlightJournal journal(0, JOURNAL_SLOTS);
+BoardConfig::TraceStore traceStorage;
+FlightRecorder recorder(traceStorage);
 
-KalmanFilter filter(0);
-#if ENABLE_MPU
-Mahony sensorFusion;
-#endif
+BoardConfig::Barometer barometer;
+BoardConfig::Imu imu(Wire, 0x68);
+
+// The barometer is read on every control tick so the filter gains are fixed
+// at compile time.  Sized for 20m/s/s of unmodelled acceleration against
+// 0.25m of barometer noise.
+const float kAltitudePeriod = SENSOR_READ_DELAY_MS / 1000.0;
+constexpr TrackingGains kAltitudeGains =
+    alphaBetaGainsForNoise(20, 0.25, SENSOR_READ_DELAY_MS / 1000.0);
+AlphaBetaFilter<float> filter(kAltitudeGains);
+SensorFusion sensorFusion;
 
 bool barometerReady = false;  // True if the barometer/altimeter is ready
 bool mpuReady       = false;  // True if the barometer/altimeter is ready
 SimpleTimer timer;
-Blinker blinker(timer, MESSAGE_PIN, BUZZER_PIN);
+Blinker<SimpleTimerSource, BoardConfig::MessagePin, BoardConfig::BuzzerPin>
+    blinker(timer);
 TimerProxy flightControlInterruptProxy(flightControllInterrupt);
 
 static unsigned long lastFireTime = 0;
@@ -74,10 +88,10 @@ void setup()
   pinMode(RESET_PIN, INPUT_PULLUP);
 
   // All LED pins sset to outputs
-  pinMode(MESSAGE_PIN, OUTPUT);
-  pinMode(STATUS_PIN, OUTPUT);
-  pinMode(READY_PIN, OUTPUT);
-  pinMode(BUZZER_PIN, OUTPUT);
+  BoardConfig::MessagePin::begin();
+  BoardConfig::StatusPin::begin();
+  BoardConfig::ReadyPin::begin();
+  BoardConfig::BuzzerPin::begin();
 
   if (TEST_PIN) {
     pinMode(TEST_PIN, INPUT_PULLUP);
@@ -85,39 +99,31 @@ void setup()
 
   // Start in the "error" state.  Status pin should be high and message
   // pin should be low to indicate a good startup
-  digitalWrite(STATUS_PIN, LOW);
-  digitalWrite(MESSAGE_PIN, HIGH);
+  BoardConfig::StatusPin::write(LOW);
+  BoardConfig::MessagePin::write(HIGH);
 
-  mainChute.init(2, MAIN_DEPL_RELAY_PIN, MAIN_TYPE);
-  drogueChute.init(1, DROGUE_DEPL_RELAY_PIN, DROGUE_TYPE);
+  RecoveryDevice::onAngle  = kChuteReleaseTriggeredAngle;
+  RecoveryDevice::offAngle = kChuteReleaseArmedAngle;
+  mainChute.init(2);
+  drogueChute.init(1);
 
   if (barometer.begin(BARO_I2C_ADDR)) {  // Omit the parameter for adafruit
 #ifdef STATUS_PIN_LEVEL
-    analogWrite(STATUS_PIN, STATUS_PIN_LEVEL);
+    BoardConfig::StatusPin::analog(STATUS_PIN_LEVEL);
 #else
-    digitalWrite(STATUS_PIN, HIGH);
+    BoardConfig::StatusPin::write(HIGH);
 #endif
-    digitalWrite(MESSAGE_PIN, LOW);
+    BoardConfig::MessagePin::write(LOW);
     log("Baro Started");
     barometerReady = true;
   } else {
     log("Baro Fail");
   }
 
-#if ENABLE_MPU
-  mpuReady = !(imu.begin() < 0);
-  log(mpuReady ? "IMU OK" : "IMU failed");
-#endif
-
-//For MPU6050 
-#if ENABLE_MPU
-//  mpu.initialize();
-//  mpuReady = mpu.testConnection();
-//  log(mpuReady ? "IMU OK" : "IMU failed");
-//  if (mpuReady) {
-//    mpu.setFullScaleAccelRange(MPU6050_ACCEL_FS_8);
-//  }
-#endif
+  if (BoardConfig::kHasImu) {
+    mpuReady = !(imu.begin() < 0);
+    log(mpuReady ? "IMU OK" : "IMU failed");
+  }
 
   reset(&flightData);
   deploymentAltitude = readDeploymentAltitude();
@@ -126,12 +132,14 @@ void setup()
   log("Pad Alt:" + String(refAltitude));
 
   configureEeprom();
+  traceStorage.begin();
 }
 
 
 void loop()
 {
   timer.run();
+  recorder.service();
   if (!barometerReady && !blinker.isBlinking()) {
     blinker.blinkValue(3, BLINK_SPEED_MS, true);
   }
@@ -139,11 +147,14 @@ void loop()
     // Kill Timer
     timer.deleteTimer(flightControlTimer);
     flightControlTimer = -1;
-    digitalWrite(READY_PIN, LOW);
+    BoardConfig::ReadyPin::write(LOW);
     if (flightData.apogee && !blinker.isBlinking()) {
       blinker.blinkValue(flightData.apogee, BLINK_SPEED_MS, true);
     }
     failsafeCheck();
+    if (Serial.available() && Serial.read() == 'd') {
+      recorder.dump(Serial);
+    }
   }
   checkResetPin();
 
@@ -172,7 +183,7 @@ void flightControllInterrupt()
   if (flightState != kOnGround) {
     readSensorData(&data);
     flightControl(&data);
-    digitalWrite(READY_PIN, HIGH);
+    BoardConfig::ReadyPin::write(HIGH);
     //checkResetPin();
   }
 }
@@ -211,20 +222,22 @@ bool checkResetPin()
         setRecoveryDeviceState(OFF, &mainChute);
         mainChute.reset();
         testFlightTimeStep = 0;
+        recorder.arm();
         playReadyTone();
-        flightState = kReadyToFly;
+        tick.altitude = 0;
+        kFlightStates.enter(flightState, kReadyToFly, tick);
         filter.reset(0);
-        #if ENABLE_MPU
         sensorFusion.begin(1000 / SENSOR_READ_DELAY_MS);
-        #endif
         flightControlTimer =
-            timer.setInterval(SENSOR_READ_DELAY_MS, &flightControlInterruptProxy);
+            timer.setInterval(SENSOR_READ_DELAY_MS, &flightControlInterruptProxy,
+                              SimpleTimer::PRIORITY_HIGH);
       }
     }
     else
     {
       log("Stopping");
-      flightState = kOnGround;
+      recorder.finish(0);
+      kFlightStates.enter(flightState, kOnGround, tick);
       flightData.apogee = 0;
       playCancelTone();
     }
@@ -255,15 +268,13 @@ void readSensorData(SensorData *d)
   if (barometerReady) {
     d->altitude = barometer.readAltitude(SEA_LEVEL_PRESSURE) - refAltitude;
   }
-#if ENABLE_MPU
-  if (mpuReady) {
+  if (BoardConfig::kHasImu && mpuReady) {
     imu.readSensor();
     sensorFusion.update(imu.getGyroX_rads(), imu.getGyroY_rads(),
                         imu.getGyroZ_rads(), imu.getAccelX_mss(),
                         imu.getAccelY_mss(), imu.getAccelZ_mss(),
                         imu.getMagX_uT(), imu.getMagY_uT(), imu.getMagZ_uT());
   }
-#endif
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -273,17 +284,104 @@ int samples_below_apogee  = 0;
 int samples_at_min_height = 0;
 int samples_above_min_acc = 0;
 
+//A flight is either, 3 samples at > .1G or 1 sample above the height threshold
+bool FlightHandlers::isLaunched(ControlTick &t)
+{
+  if (t.acceleration > FLIGHT_START_THRESHOLD_ACC) {
+    samples_above_min_acc++;
+  } else {
+    samples_above_min_acc = 0;
+  }
+  return t.altitude >= FLIGHT_START_THRESHOLD_ALT || samples_above_min_acc > 3;
+}
+
+void FlightHandlers::onLaunch(ControlTick &t)
+{
+  samples_below_apogee      = 0;
+  flightData.altTriggerTime = millis() - resetTime;
+  recorder.trigger();
+  BoardConfig::ReadyPin::write(LOW);
+  BoardConfig::MessagePin::write(HIGH);
+}
+
+// 5 samples below our apogee
+bool FlightHandlers::isPastApogee(ControlTick &t)
+{
+  if (t.altitude < flightData.apogee) {
+    samples_below_apogee++;
+  } else {
+    samples_below_apogee = 0;
+  }
+  return samples_below_apogee > 5;
+}
+
+void FlightHandlers::onApogee(ControlTick &t)
+{
+  samples_at_min_height = 0;
+  // Deploy our drogue chute
+  setRecoveryDeviceState(ON, &drogueChute);
+  flightData.drogueEjectionAltitude = t.altitude;
+}
+
+//We've most likely hit the ground
+bool FlightHandlers::isLanded(ControlTick &t)
+{
+  if (t.altitude < FLIGHT_END_THRESHOLD_ALT) {
+    samples_at_min_height++;
+  } else {
+    samples_at_min_height = 0;
+  }
+  return samples_at_min_height > 3;
+}
+
+void FlightHandlers::onLanding(ControlTick &t)
+{
+  int flightNumber = journal.append(flightData);
+  logData(flightNumber, &flightData);
+  recorder.finish(flightNumber);
+
+  // Reset the pyro charges.  Leave chute releases open.  Start the locator
+  // beeper and start blinking...
+  resetRecoveryDeviceIfRequired(&drogueChute);
+  resetRecoveryDeviceIfRequired(&mainChute);
+}
+
+const __FlashStringHelper *flightStateString(FlightState s)
+{
+  switch (s) {
+    case kReadyToFly:
+      return F("Ready");
+    case kAscending:
+      return F("Ascending");
+    case kDescending:
+      return F("Descending");
+    case kOnGround:
+      return F("Landed");
+  }
+  return F("");
+}
+
+// There's no event log on this board so transitions go to the serial log
+void stampTransition(ControlTick &t, FlightState from, FlightState to)
+{
+  log(String(millis() - resetTime) + "ms " + flightStateString(to) + " " +
+      String(t.altitude));
+}
+
 void flightControl(SensorData *d)
 {
   double acceleration = d->acceleration;
-  double altitude     = filter.step(d->altitude);
+  double altitude     = filter.step(d->altitude, kAltitudePeriod);
+
+  recorder.sample(d->altitude, acceleration);
 
   if (PLOT_ALTITUDE) {
     log(String(altitude));
-#if ENABLE_MPU
-    log(String(sensorFusion.getYaw()) + ":" + String(sensorFusion.getPitch()) +
-        ":" + String(sensorFusion.getRoll()));
-#endif
+    if (BoardConfig::kHasImu) {
+      log(String(sensorFusion.getYaw()) + ":" +
+          String(sensorFusion.getPitch()) + ":" +
+          String(sensorFusion.getRoll()));
+    }
   }
 
   // Keep track or our apogee and our max g load
@@ -296,66 +394,11 @@ void flightControl(SensorData *d)
                                    : flightData.maxAcceleration;
 
 
-  if (flightState == kReadyToFly ) 
-  {
-    if(acceleration > FLIGHT_START_THRESHOLD_ACC) {
-      samples_above_min_acc++;
-    }else{
-      samples_above_min_acc = 0;
-    }
-
-    //A flight is either, 3 samples at > .1G or 1 sample above the height threshold
-    //If we're above our flight start threshold, we're flying!
-    if(altitude >= FLIGHT_START_THRESHOLD_ALT || samples_above_min_acc > 3) {
-      // Transition to "InFlight" if we've exceeded the threshold altitude.
-      log("Ascending");
-      samples_below_apogee = 0;
-      flightState               = kAscending;
-      flightData.altTriggerTime = millis() - resetTime;
-      digitalWrite(READY_PIN, LOW);
-      digitalWrite(MESSAGE_PIN, HIGH);
-    }
-  } 
-  else if (flightState == kAscending) 
-  {
-    // Transition to kDescending if we've recorded 5 samples below our apogee
-    if(altitude < flightData.apogee) {
-      samples_below_apogee++;
-    }else{
-      samples_below_apogee = 0;
-    }
-
-    if(samples_below_apogee > 5) {
-      flightState = kDescending;
-      samples_at_min_height = 0;
-      log(F("Descending"));
-       // Deploy our drogue chute
-      setRecoveryDeviceState(ON, &drogueChute);
-      flightData.drogueEjectionAltitude = altitude;
-    }
-  } 
-  else if (flightState == kDescending) 
-  {
-    if(altitude < FLIGHT_END_THRESHOLD_ALT) {
-      samples_at_min_height++;
-    }else{
-      samples_at_min_height = 0;
-    }
-
-    //We've most likely hit the ground
-    if(samples_at_min_height > 3) {
-      flightState = kOnGround;
-      log(F("Landed"));
-      logData(flightCount, &flightData);
-      recordFlight(flightData);
-      flightCount++;
-  
-      // Reset the pyro charges.  Leave chute releases open.  Start the locator
-      // beeper and start blinking...
-      resetRecoveryDeviceIfRequired(&drogueChute);
-      resetRecoveryDeviceIfRequired(&mainChute);
-    }
-  }
+  tick.altitude     = altitude;
+  tick.acceleration = acceleration;
+  static_assert(transitionsSorted(Phases::kFlightTransitions),
+                "Flight transitions must be sorted by the state they leave");
+  kFlightStates.step(flightState, tick);
 
   // Main chute deployment at kDeployment Altitude.
   // We deploy in the onGround state as well just in case an anomalous pressure
@@ -411,47 +454,31 @@ void setRecoveryDeviceState(RecoveryDeviceState deviceState, RecoveryDevice *c)
 ////////////////////////////////////////////////////////////////////////
 // EEPROM & Peristance
 
-void recordFlight(FlightData d)
-{
-  int offset = flightCount * sizeof(FlightData);
-  EEPROM.put(offset, d);
-}
-
 void configureEeprom()
 {
+  journal.begin();
   if (digitalRead(RESET_PIN) == LOW) {
-    for (int i = 0; i < EEPROM.length(); i++) {
-      EEPROM.write(i, 0);
-    }
+    journal.wipe();
     log("EEProm Wiped");
   }
-  flightCount = getFlightCount();
+  logFlights();
 }
 
-int getFlightCount()
+void logFlights()
 {
-  size_t maxProgs = EEPROM.length() / sizeof(FlightData);
   FlightData d;
-  for (int i = 0; i < maxProgs; i++) {
-    EEPROM.get(i * sizeof(FlightData), d);
-    if (!isValid(&d)) {
-      return i;
+  int index;
+  for (int age = journal.getFlightCount() - 1; age >= 0; age--) {
+    if (journal.read(age, &d, &index)) {
+      logData(index, &d);
+      flightData = d;
     }
-    logData(i, &d);
-    flightData = d;
   }
-  return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////
 // Flight Data Utilities
 
-bool isValid(FlightData *d)
-{
-  return d->apogee || d->ejectionAltitude || d->drogueEjectionAltitude ||
-         d->maxAcceleration || d->burnoutAltitude;
-}
-
 void reset(FlightData *d)
 {
   d->apogee                 = 0;
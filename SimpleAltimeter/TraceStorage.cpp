@@ -0,0 +1,151 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#include "TraceStorage.h"
+#include <EEPROM.h>
+#include <SPI.h>
+#include "FlightJournal.h"
+
+EepromTraceStorage::EepromTraceStorage()
+    : baseAddress(FlightJournal::regionSize(JOURNAL_SLOTS))
+{
+}
+
+uint32_t EepromTraceStorage::capacity()
+{
+  return EEPROM.length() - baseAddress;
+}
+
+// Recovering a trace that was never finished reads up to the first erased
+// byte, so the old trace has to go.  update() skips bytes that are already
+// erased, so this only costs ~3.3ms for each byte the last trace used.
+void EepromTraceStorage::prepare()
+{
+  for (int address = baseAddress; address < EEPROM.length(); address++) {
+    EEPROM.update(address, 0xFF);
+  }
+}
+
+size_t EepromTraceStorage::write(uint32_t address, const uint8_t *data,
+                                 size_t len)
+{
+  if (!len || !eeprom_is_ready()) {
+    return 0;
+  }
+  EEPROM.update(baseAddress + address, *data);
+  return 1;
+}
+
+void EepromTraceStorage::read(uint32_t address, uint8_t *data, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    data[i] = EEPROM.read(baseAddress + address + i);
+  }
+}
+
+#define kFlashWriteEnable 0x06
+#define kFlashReadStatus 0x05
+#define kFlashPageProgram 0x02
+#define kFlashRead 0x03
+#define kFlashBlockErase 0xD8
+#define kFlashPageSize 256
+#define kFlashBlockSize 65536UL
+
+void SpiFlashTraceStorage::begin()
+{
+  pinMode(csPin, OUTPUT);
+  digitalWrite(csPin, HIGH);
+  SPI.begin();
+}
+
+bool SpiFlashTraceStorage::isBusy()
+{
+  digitalWrite(csPin, LOW);
+  SPI.transfer(kFlashReadStatus);
+  bool busy = SPI.transfer(0) & 0x01;
+  digitalWrite(csPin, HIGH);
+  return busy;
+}
+
+void SpiFlashTraceStorage::writeEnable()
+{
+  digitalWrite(csPin, LOW);
+  SPI.transfer(kFlashWriteEnable);
+  digitalWrite(csPin, HIGH);
+}
+
+// Leaves CS asserted
+void SpiFlashTraceStorage::command(uint8_t cmd, uint32_t address)
+{
+  digitalWrite(csPin, LOW);
+  SPI.transfer(cmd);
+  SPI.transfer(address >> 16);
+  SPI.transfer(address >> 8);
+  SPI.transfer(address);
+}
+
+void SpiFlashTraceStorage::prepare()
+{
+  for (uint32_t block = 0; block < size; block += kFlashBlockSize) {
+    while (isBusy()) {
+    }
+    writeEnable();
+    command(kFlashBlockErase, block);
+    digitalWrite(csPin, HIGH);
+  }
+  while (isBusy()) {
+  }
+}
+
+size_t SpiFlashTraceStorage::write(uint32_t address, const uint8_t *data,
+                                   size_t len)
+{
+  if (!len || isBusy()) {
+    return 0;
+  }
+
+  size_t pageRemaining = kFlashPageSize - (address % kFlashPageSize);
+  size_t n             = min(len, pageRemaining);
+
+  writeEnable();
+  command(kFlashPageProgram, address);
+  for (size_t i = 0; i < n; i++) {
+    SPI.transfer(data[i]);
+  }
+  digitalWrite(csPin, HIGH);
+  return n;
+}
+
+void SpiFlashTraceStorage::read(uint32_t address, uint8_t *data, size_t len)
+{
+  while (isBusy()) {
+  }
+  command(kFlashRead, address);
+  for (size_t i = 0; i < len; i++) {
+    data[i] = SPI.transfer(0);
+  }
+  digitalWrite(csPin, HIGH);
+}
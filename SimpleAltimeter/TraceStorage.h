@@ -0,0 +1,110 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef TRACESTORAGE_H
+#define TRACESTORAGE_H
+
+#include "Configuration.h"
+
+// Backing store for the flight trace.  write() must never block: it stores
+// as many bytes as it can right now (possibly none) and returns the count.
+class TraceStorage
+{
+ public:
+  virtual void begin() {}
+
+  virtual uint32_t capacity() = 0;
+
+  // Only every decimation()'th sample is recorded so a small store still
+  // holds the whole flight
+  virtual uint8_t decimation() = 0;
+
+  // Erases the whole store to 0xFF, which also invalidates the stored trace.
+  // May block - only call this on the pad.
+  virtual void prepare() = 0;
+
+  virtual size_t write(uint32_t address, const uint8_t *data, size_t len) = 0;
+  virtual void read(uint32_t address, uint8_t *data, size_t len) = 0;
+
+  // Blocking write for use on the ground
+  void writeAll(uint32_t address, const uint8_t *data, size_t len)
+  {
+    while (len) {
+      size_t n = write(address, data, len);
+      address += n;
+      data += n;
+      len -= n;
+    }
+  }
+};
+
+// Uses the on-chip EEPROM from |baseAddress| to the end.  A byte write takes
+// ~3.3ms but runs in the background, so write() stores one byte and returns
+// immediately if the previous write hasn't finished.
+class EepromTraceStorage : public TraceStorage
+{
+ public:
+  // Starts after the flight journal
+  EepromTraceStorage();
+  EepromTraceStorage(int baseAddress) : baseAddress(baseAddress){};
+
+  uint32_t capacity() override;
+  uint8_t decimation() override { return 4; }
+  void prepare() override;
+  size_t write(uint32_t address, const uint8_t *data, size_t len) override;
+  void read(uint32_t address, uint8_t *data, size_t len) override;
+
+ private:
+  int baseAddress;
+};
+
+// W25Qxx (or compatible) SPI NOR flash.  prepare() erases the first
+// |size| bytes in 64K blocks.  Writes are page programs split on page
+// boundaries and are skipped while a previous program is in progress.
+class SpiFlashTraceStorage : public TraceStorage
+{
+ public:
+  SpiFlashTraceStorage() : csPin(FLASH_CS_PIN), size(FLASH_TRACE_SIZE){};
+  SpiFlashTraceStorage(byte csPin, uint32_t size) : csPin(csPin), size(size){};
+
+  void begin() override;
+
+  uint32_t capacity() override { return size; }
+  uint8_t decimation() override { return 1; }
+  void prepare() override;
+  size_t write(uint32_t address, const uint8_t *data, size_t len) override;
+  void read(uint32_t address, uint8_t *data, size_t len) override;
+
+ private:
+  byte csPin;
+  uint32_t size;
+
+  bool isBusy();
+  void command(uint8_t cmd, uint32_t address);
+  void writeEnable();
+};
+
+#endif  // TRACESTORAGE_H
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""Decodes a SimpleAltimeter flight trace dump.
+
+The altimeter dumps its trace when it receives 'd' over serial while on the
+ground.  The dump is a sequence of frames:
+
+    0x7E, type, payload length, payload, crc8(type, length, payload)
+
+'H' carries the trace header, 'D' a little endian 32 bit offset followed by
+trace data and 'E' ends the dump.  The trace is a pair of zig-zag varint
+deltas per sample: altitude in dm and acceleration in centi-g.
+
+If the altimeter was reset or lost power in flight there's no final header.
+The altimeter recovers what it wrote up to that point and sends the header
+with FLAG_OPEN set and no flight number.
+
+Usage:
+    trace_decode.py --port /dev/ttyUSB0 [--baud 19200] [--save dump.bin]
+    trace_decode.py dump.bin [--csv trace.csv] [--plot]
+"""
+
+import argparse
+import struct
+import sys
+
+HEADER_FORMAT = '<HBBHHHBBI'
+HEADER_MAGIC = 0x544F
+HEADER_VERSION = 2
+FLAG_TRUNCATED = 0x01
+FLAG_OPEN = 0x02
+NO_FLIGHT = 0xFFFF
+
+
+def crc8(data, crc=0xA5):
+    for b in data:
+        for _ in range(8):
+            mix = (crc ^ b) & 0x01
+            crc >>= 1
+            if mix:
+                crc ^= 0x8C
+            b >>= 1
+    return crc
+
+
+def read_frames(read):
+    """Yields (type, payload) until the 'E' frame."""
+    while True:
+        b = read(1)
+        if not b:
+            raise EOFError('dump ended without an end frame')
+        if b[0] != 0x7E:
+            continue  # Skip any log output ahead of the dump
+        prefix = read(2)
+        payload = read(prefix[1])
+        crc = read(1)
+        if len(crc) != 1 or crc8(payload, crc8(prefix)) != crc[0]:
+            raise ValueError('bad frame checksum')
+        ftype = chr(prefix[0])
+        if ftype == 'E':
+            return
+        yield ftype, payload
+
+
+def parse_dump(read):
+    header = None
+    data = bytearray()
+    for ftype, payload in read_frames(read):
+        if ftype == 'H':
+            fields = struct.unpack(HEADER_FORMAT, payload)
+            header = dict(zip(('magic', 'version', 'flags', 'period_ms',
+                               'samples', 'flight', 'pre_trigger', 'crc',
+                               'length'), fields))
+            if header['magic'] != HEADER_MAGIC or \
+               header['version'] != HEADER_VERSION:
+                raise ValueError('unsupported trace header')
+        elif ftype == 'D':
+            offset, = struct.unpack_from('<I', payload)
+            if offset != len(data):
+                raise ValueError('missing data at offset %d' % len(data))
+            data += payload[4:]
+    return header, bytes(data)
+
+
+def varints(data):
+    value = shift = 0
+    for b in data:
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            yield (value >> 1) ^ -(value & 1)
+            value = shift = 0
+
+
+def decode(header, data):
+    """Returns [(time_s, altitude_m, acceleration_g)]. t=0 is the trigger."""
+    samples = []
+    deltas = varints(data)
+    altitude = acceleration = 0
+    for i in range(header['samples']):
+        altitude += next(deltas)
+        acceleration += next(deltas)
+        t = (i - header['pre_trigger']) * header['period_ms'] / 1000.0
+        samples.append((t, altitude / 10.0, acceleration / 100.0))
+    return samples
+
+
+def fetch_from_port(port, baud, save):
+    import serial  # pyserial
+    with serial.Serial(port, baud, timeout=5) as s:
+        raw = bytearray()
+
+        def read(n):
+            b = s.read(n)
+            raw.extend(b)
+            return b
+
+        s.reset_input_buffer()
+        s.write(b'd')
+        result = parse_dump(read)
+    if save:
+        with open(save, 'wb') as f:
+            f.write(raw)
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('dump', nargs='?', help='saved dump file')
+    parser.add_argument('--port', help='read the dump from a serial port')
+    parser.add_argument('--baud', type=int, default=19200)
+    parser.add_argument('--save', help='save the raw dump read from --port')
+    parser.add_argument('--csv', help='write CSV here instead of stdout')
+    parser.add_argument('--plot', action='store_true',
+                        help='plot with matplotlib')
+    args = parser.parse_args()
+
+    if args.port:
+        header, data = fetch_from_port(args.port, args.baud, args.save)
+    elif args.dump:
+        with open(args.dump, 'rb') as f:
+            header, data = parse_dump(f.read)
+    else:
+        parser.error('give a dump file or --port')
+
+    if header is None:
+        sys.exit('no flight trace recorded')
+
+    samples = decode(header, data)
+    notes = ''
+    if header['flags'] & FLAG_TRUNCATED:
+        notes += ' (truncated)'
+    if header['flags'] & FLAG_OPEN:
+        notes += ' (recovered, the flight never finished)'
+    flight = '?' if header['flight'] == NO_FLIGHT else header['flight']
+    sys.stderr.write('flight %s: %d samples at %d ms%s\n' %
+                     (flight, len(samples), header['period_ms'], notes))
+
+    out = open(args.csv, 'w') if args.csv else sys.stdout
+    out.write('time_s,altitude_m,acceleration_g\n')
+    for s in samples:
+        out.write('%.3f,%.1f,%.2f\n' % s)
+    if args.csv:
+        out.close()
+
+    if args.plot:
+        import matplotlib.pyplot as plt
+        t, alt, acc = zip(*samples)
+        fig, (ax1, ax2) = plt.subplots(2, 1, sharex=True)
+        ax1.plot(t, alt)
+        ax1.set_ylabel('Altitude (m)')
+        ax2.plot(t, acc)
+        ax2.set_ylabel('Acceleration (g)')
+        ax2.set_xlabel('Time from launch (s)')
+        plt.show()
+
+
+if __name__ == '__main__':
+    main()
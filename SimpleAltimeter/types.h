@@ -27,15 +27,11 @@
 #ifndef TYPES_H
 #define TYPES_H
 
-#include <Arduino.h>
-
-#define NO_PIN 0
-#define IS_SIMPLE_ALT 1
+#include <AltimeterCore.h>
+#include "FlightState.h"
 
 void log(String msg);
 
-typedef enum { kNoEjection, kPyro, kServo } RecoveryDeviceType;
-
 typedef struct {
   float apogee                 = 0;
   float ejectionAltitude       = 0;
@@ -53,13 +49,10 @@ typedef struct {
   double acceleration = 0;
 } SensorData;
 
-typedef enum { kReadyToFly, kAscending, kDescending, kOnGround } FlightState;
-
-typedef enum { kNone, kActive, kPassive } PeizoStyle;
-
-typedef enum { OFF = 0, ON = 1 } OnOffState;
-
-using RecoveryDeviceState   = OnOffState;
-using BlinkerState = OnOffState;
+// The control tick the flight state guards and actions are looking at
+typedef struct {
+  float altitude;
+  float acceleration;
+} ControlTick;
 
 #endif  // TYPES_H
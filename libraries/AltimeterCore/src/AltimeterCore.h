@@ -0,0 +1,56 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef altimetercore_h
+#define altimetercore_h
+
+// Code shared by both altimeters.  Include this ahead of anything else from
+// the library so the IDE puts the library on the include path.
+//
+// Whatever differs between boards is a type chosen in each firmware's
+// Configuration.h and handed to the core as a template parameter (see
+// Board.hpp) rather than an #if in here, so both firmwares build the same
+// code and parts a board doesn't have compile to nothing.
+
+#include <Arduino.h>
+
+typedef enum { kNoEjection, kPyro, kServo } RecoveryDeviceType;
+
+typedef enum { kNone, kActive, kPassive } PeizoStyle;
+
+typedef enum { OFF = 0, ON = 1 } OnOffState;
+
+typedef OnOffState RecoveryDeviceState;
+typedef OnOffState BlinkerState;
+
+#include "Board.hpp"
+#include "Filters.hpp"
+#include "FlightPhases.hpp"
+#include "FlightStateMachine.hpp"
+#include "Numeric.hpp"
+#include "OutputPin.hpp"
+
+#endif
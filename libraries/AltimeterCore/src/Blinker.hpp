@@ -24,9 +24,59 @@
  * SOFTWARE.
  **********************************************************************************/
 
-#include "Blinker.hpp"
+#ifndef blinksequence_h
+#define blinksequence_h
+
+#include "AltimeterCore.h"
+#include "SimpleTimer.h"
+
+// 128 bits will represent 64 on-off events.
+// the number 1000 would require ~34 so this should
+// be sufficient.
+#define kBitMapLen 16
+
+// Blinks out a number on an LED and piezo, one digit at a time.  The timer
+// that paces the bits is a policy so the same code runs off a SimpleTimer on
+// the AVR and a Ticker on the ESP, and the pins are OutputPins (or NoOutput)
+// from the board profile:
+//
+//   Blinker<SimpleTimerSource, MessagePin, BuzzerPin> blinker(timer);
+//   Blinker<TickerTimerSource, MessagePin, BuzzerPin> blinker;
+//
+// The timer source needs once(ms, TimerDelegate *) and cancel().  The
+// constructor's arguments are passed to its constructor.
+template <typename TimerSource, typename LedPin, typename PiezoPin>
+class Blinker : public TimerDelegate
+{
+ public:
+  template <typename... TimerArgs>
+  Blinker(TimerArgs &... timerArgs) : timer(timerArgs...) {}
+
+  ~Blinker() { cancelSequence(); };
+
+  void blinkValue(long value, int speed, bool repeat, bool pause = true);
+  void cancelSequence();
+  bool isBlinking() { return isRunning; }
+
+  void timerFired(int timerNumber) override;
+
+ private:
+  TimerSource timer;
+  byte bitMap[kBitMapLen];
 
-void Blinker::blinkValue(long value, int speed, bool repeat, bool pause)
+  void setHardwareState(BlinkerState hwState);
+
+  byte sequenceLen = 0;
+  byte position    = 0;
+  bool repeat      = 0;
+  int speed        = 0;
+  bool isRunning   = false;
+};
+
+template <typename TimerSource, typename LedPin, typename PiezoPin>
+void Blinker<TimerSource, LedPin, PiezoPin>::blinkValue(long value, int speed,
+                                                        bool repeat,
+                                                        bool pause)
 {
   if (isBlinking()) {
     cancelSequence();
@@ -80,24 +130,17 @@ void Blinker::blinkValue(long value, int speed, bool repeat, bool pause)
   timerFired(0);
 }
 
-void Blinker::cancelSequence()
+template <typename TimerSource, typename LedPin, typename PiezoPin>
+void Blinker<TimerSource, LedPin, PiezoPin>::cancelSequence()
 {
   position = 0;
-
-#ifdef IS_SIMPLE_ALT
-  timer.deleteTimer(timerNumber);
-#else
-  ticker.detach();
-#endif
-
-  timerNumber = -1;
+  timer.cancel();
   setHardwareState(OFF);
   isRunning = false;
 }
 
-void interrupt(Blinker *blinker) { blinker->timerFired(0); }
-
-void Blinker::timerFired(int number)
+template <typename TimerSource, typename LedPin, typename PiezoPin>
+void Blinker<TimerSource, LedPin, PiezoPin>::timerFired(int number)
 {
   byte byteNumber = position / 8;
   byte bitNumber  = position % 8;
@@ -114,22 +157,15 @@ void Blinker::timerFired(int number)
     }
     position = 0;
   }
-#ifdef IS_SIMPLE_ALT
-  timerNumber = timer.setTimeout(speed, this);
-#else
-  ticker.once_ms(speed, interrupt, this);
-#endif
+  timer.once(speed, this);
 }
 
-bool Blinker::isBlinking() { return isRunning; }
-
-void Blinker::setHardwareState(BlinkerState hwState)
+template <typename TimerSource, typename LedPin, typename PiezoPin>
+void Blinker<TimerSource, LedPin, PiezoPin>::setHardwareState(
+    BlinkerState hwState)
 {
-  if (ledPin != NO_PIN) {
-    digitalWrite(ledPin, (hwState == ON) ? HIGH : LOW);
-  }
+  LedPin::write(hwState == ON);
+  PiezoPin::write(hwState == ON);
+}
 
-  if (piezoPin != NO_PIN) {
-    digitalWrite(piezoPin, (hwState == ON) ? HIGH : LOW);
-  }
-}
\ No newline at end of file
+#endif
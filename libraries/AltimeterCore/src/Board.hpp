@@ -0,0 +1,110 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef board_h
+#define board_h
+
+// The parts a board is built from, as types.  Each firmware's
+// Configuration.h picks a set for each of its pin configurations:
+//
+//   typedef Board<Adafruit_BMP280, NoImu, EepromTraceStorage> BoardConfig;
+//
+// and the firmware declares its parts from that:
+//
+//   BoardConfig::Barometer barometer;
+//
+// Code for a part that isn't there is switched off with the constexpr flags
+// below rather than an #if, so it's still compiled (and can't rot) but the
+// optimiser drops it, and the linker drops the unused drivers.
+
+// Stands in for an IMU on boards that don't have one
+class NoImu
+{
+ public:
+  // Takes (and ignores) whatever the real IMU is constructed with
+  template <typename... Args>
+  NoImu(Args &&... args)
+  {
+  }
+
+  int begin() { return -1; }
+  void readSensor() {}
+  float getAccelX_mss() { return 0; }
+  float getAccelY_mss() { return 0; }
+  float getAccelZ_mss() { return 0; }
+  float getGyroX_rads() { return 0; }
+  float getGyroY_rads() { return 0; }
+  float getGyroZ_rads() { return 0; }
+  float getMagX_uT() { return 0; }
+  float getMagY_uT() { return 0; }
+  float getMagZ_uT() { return 0; }
+};
+
+// Stands in for sensor fusion when there's no IMU to fuse
+class NoFusion
+{
+ public:
+  void begin(float sampleFrequency) {}
+  void update(float gx, float gy, float gz, float ax, float ay, float az,
+              float mx, float my, float mz)
+  {
+  }
+  float getRoll() { return 0; }
+  float getPitch() { return 0; }
+  float getYaw() { return 0; }
+};
+
+template <typename A, typename B>
+struct IsSameType {
+  static constexpr bool value = false;
+};
+
+template <typename A>
+struct IsSameType<A, A> {
+  static constexpr bool value = true;
+};
+
+// Picks A if Condition is true, otherwise B
+template <bool Condition, typename A, typename B>
+struct SelectType {
+  typedef A type;
+};
+
+template <typename A, typename B>
+struct SelectType<false, A, B> {
+  typedef B type;
+};
+
+template <typename BarometerType, typename ImuType, typename TraceStoreType>
+struct Board {
+  typedef BarometerType Barometer;
+  typedef ImuType Imu;
+  typedef TraceStoreType TraceStore;
+
+  static constexpr bool kHasImu = !IsSameType<ImuType, NoImu>::value;
+};
+
+#endif
@@ -0,0 +1,331 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef Filters_h
+#define Filters_h
+
+#include <stdint.h>
+
+// Fixed size filters.  Everything here is templated on the value type so the
+// filters can run in float (double is float on the AVR anyway and soft
+// double is twice the cost of soft float on the ESP) and on window length so
+// nothing is allocated at runtime.  The coefficient helpers are constexpr so
+// a filter with a fixed sample rate costs nothing to configure:
+//
+//   static constexpr BiquadCoefficients kLowPass = lowPassBiquad(5, 100);
+//   Biquad<float> filter(kLowPass);
+//
+// These are C++11 constexpr functions, hence the recursion.
+
+#define kFilterPi 3.14159265358979323846
+
+//////////  Compile time maths /////////////
+
+constexpr double filterSeries(double x2, double term, int n, double sum)
+{
+  return n > 25 ? sum
+                : filterSeries(x2, -term * x2 / ((n + 1) * (n + 2)), n + 2,
+                               sum + term);
+}
+
+// Good to ~1e-12 for |x| < pi/2
+constexpr double filterSin(double x) { return filterSeries(x * x, x, 1, 0); }
+constexpr double filterCos(double x) { return filterSeries(x * x, 1, 0, 0); }
+constexpr double filterTan(double x) { return filterSin(x) / filterCos(x); }
+
+constexpr double filterSqrtStep(double x, double guess, int n)
+{
+  return n == 0 ? guess
+                : filterSqrtStep(x, (guess + x / guess) / 2, n - 1);
+}
+
+constexpr double filterSqrt(double x)
+{
+  return x <= 0 ? 0 : filterSqrtStep(x, x > 1 ? x : 1, 40);
+}
+
+//////////  Moving Average /////////////
+
+// Unweighted average of the last N values.  The sum is kept as values come
+// and go so a step is O(1) whatever the window.  For floating point types
+// the running sum picks up rounding error at about sqrt(steps) * epsilon,
+// which is a few parts in 10^5 of the signal after a day at 100Hz.
+template <typename T, int N>
+class MovingAverage
+{
+  static_assert(N > 0, "MovingAverage needs a window");
+
+ public:
+  explicit MovingAverage(T startingValue = 0) { reset(startingValue); }
+
+  T step(T value)
+  {
+    sum += value - values[index];
+    values[index] = value;
+    index         = (index == N - 1) ? 0 : index + 1;
+    currentValue  = sum / N;
+    return currentValue;
+  }
+
+  void reset(T startingValue)
+  {
+    for (int i = 0; i < N; i++) {
+      values[i] = startingValue;
+    }
+    sum          = startingValue * N;
+    index        = 0;
+    currentValue = startingValue;
+  }
+
+  T getCurrentValue() const { return currentValue; }
+
+ private:
+  T values[N];
+  T sum;
+  T currentValue;
+  int index;
+};
+
+//////////  LowPass /////////////
+
+// Smoothing factor for a first order low pass with a -3dB point at |cutoff|
+// when stepped at |sampleRate|
+constexpr double lowPassAlpha(double cutoff, double sampleRate)
+{
+  return 2 * kFilterPi * cutoff / (sampleRate + 2 * kFilterPi * cutoff);
+}
+
+// First order (exponential) low pass.  Alpha is the weight given to each new
+// value.
+template <typename T>
+class LowPass
+{
+ public:
+  explicit LowPass(T alpha, T startingValue = 0) : alpha(alpha)
+  {
+    reset(startingValue);
+  }
+
+  T step(T value)
+  {
+    currentValue += alpha * (value - currentValue);
+    return currentValue;
+  }
+
+  void reset(T startingValue) { currentValue = startingValue; }
+
+  T getCurrentValue() const { return currentValue; }
+
+ private:
+  T alpha;
+  T currentValue;
+};
+
+//////////  Biquad /////////////
+
+// Normalised so a0 is 1
+struct BiquadCoefficients {
+  double b0, b1, b2, a1, a2;
+};
+
+constexpr BiquadCoefficients lowPassBiquadNorm(double k, double k2, double q,
+                                               double norm)
+{
+  return BiquadCoefficients{k2 * norm, 2 * k2 * norm, k2 * norm,
+                            2 * (k2 - 1) * norm, (1 - k / q + k2) * norm};
+}
+
+constexpr BiquadCoefficients lowPassBiquadK(double k, double q)
+{
+  return lowPassBiquadNorm(k, k * k, q, 1 / (1 + k / q + k * k));
+}
+
+// Second order low pass with a -3dB point at |cutoff| when stepped at
+// |sampleRate| (bilinear transform, pre-warped).  The default Q gives a
+// Butterworth response.  |cutoff| must be below sampleRate / 2.
+constexpr BiquadCoefficients lowPassBiquad(double cutoff, double sampleRate,
+                                           double q = 0.70710678118654752)
+{
+  return lowPassBiquadK(filterTan(kFilterPi * cutoff / sampleRate), q);
+}
+
+// Transposed direct form II, which needs two state variables and behaves
+// better in float than direct form I
+template <typename T>
+class Biquad
+{
+ public:
+  explicit Biquad(const BiquadCoefficients &c, T startingValue = 0)
+      : b0(c.b0), b1(c.b1), b2(c.b2), a1(c.a1), a2(c.a2)
+  {
+    reset(startingValue);
+  }
+
+  T step(T value)
+  {
+    currentValue = b0 * value + z1;
+    z1           = b1 * value - a1 * currentValue + z2;
+    z2           = b2 * value - a2 * currentValue;
+    return currentValue;
+  }
+
+  // Settles the filter as if it had seen |startingValue| forever
+  void reset(T startingValue)
+  {
+    currentValue = startingValue;
+    z1           = startingValue * (1 - b0);
+    z2           = startingValue * (b2 - a2);
+  }
+
+  T getCurrentValue() const { return currentValue; }
+
+ private:
+  T b0, b1, b2, a1, a2;
+  T z1, z2;
+  T currentValue;
+};
+
+//////////  Alpha Beta (Gamma) /////////////
+
+struct TrackingGains {
+  double alpha, beta, gamma;
+};
+
+// Critically damped (fading memory) gains.  |theta| is in (0, 1).  Higher
+// is smoother and slower to follow a change.
+constexpr TrackingGains alphaBetaGains(double theta)
+{
+  return TrackingGains{1 - theta * theta, (1 - theta) * (1 - theta), 0};
+}
+
+constexpr TrackingGains alphaBetaGammaGains(double theta)
+{
+  return TrackingGains{1 - theta * theta * theta,
+                       1.5 * (1 - theta) * (1 - theta) * (1 + theta),
+                       0.5 * (1 - theta) * (1 - theta) * (1 - theta)};
+}
+
+constexpr TrackingGains alphaBetaGainsForR(double r)
+{
+  return TrackingGains{1 - r * r, 2 * (1 + r * r) - 4 * r, 0};
+}
+
+// Steady state gains from the noise figures (Kalata's tracking index).
+// |processNoise| is the standard deviation of the unmodelled acceleration
+// and |measurementNoise| that of the measurements, stepped every |period|
+// seconds.
+constexpr TrackingGains alphaBetaGainsForNoise(double processNoise,
+                                               double measurementNoise,
+                                               double period)
+{
+  return alphaBetaGainsForR(
+      (4 + processNoise * period * period / measurementNoise -
+       filterSqrt(8 * processNoise * period * period / measurementNoise +
+                  processNoise * period * period / measurementNoise *
+                      processNoise * period * period / measurementNoise)) /
+      4);
+}
+
+// Tracks a value and its rate of change.  The time step is passed on each
+// step so it can follow a sensor with a jittery sample rate.
+template <typename T>
+class AlphaBetaFilter
+{
+ public:
+  explicit AlphaBetaFilter(const TrackingGains &g, T startingValue = 0)
+      : alpha(g.alpha), beta(g.beta)
+  {
+    reset(startingValue);
+  }
+
+  T step(T measurement, T dt)
+  {
+    if (dt <= 0) {
+      return value;
+    }
+    T predicted = value + rate * dt;
+    T residual  = measurement - predicted;
+    value       = predicted + alpha * residual;
+    rate += beta * residual / dt;
+    return value;
+  }
+
+  void reset(T startingValue, T startingRate = 0)
+  {
+    value = startingValue;
+    rate  = startingRate;
+  }
+
+  T getCurrentValue() const { return value; }
+  T getRate() const { return rate; }
+
+ private:
+  T alpha, beta;
+  T value, rate;
+};
+
+// As above, also tracking the second derivative
+template <typename T>
+class AlphaBetaGammaFilter
+{
+ public:
+  explicit AlphaBetaGammaFilter(const TrackingGains &g, T startingValue = 0)
+      : alpha(g.alpha), beta(g.beta), gamma(g.gamma)
+  {
+    reset(startingValue);
+  }
+
+  T step(T measurement, T dt)
+  {
+    if (dt <= 0) {
+      return value;
+    }
+    T predictedRate = rate + acceleration * dt;
+    T predicted     = value + (rate + predictedRate) * dt / 2;
+    T residual      = measurement - predicted;
+    value           = predicted + alpha * residual;
+    rate            = predictedRate + beta * residual / dt;
+    acceleration += 2 * gamma * residual / (dt * dt);
+    return value;
+  }
+
+  void reset(T startingValue, T startingRate = 0, T startingAcceleration = 0)
+  {
+    value        = startingValue;
+    rate         = startingRate;
+    acceleration = startingAcceleration;
+  }
+
+  T getCurrentValue() const { return value; }
+  T getRate() const { return rate; }
+  T getAcceleration() const { return acceleration; }
+
+ private:
+  T alpha, beta, gamma;
+  T value, rate, acceleration;
+};
+
+#endif  // Filters_h
@@ -0,0 +1,57 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef FlightPhases_h
+#define FlightPhases_h
+
+#include "FlightStateMachine.hpp"
+
+// The flight phases as a transition table (see FlightStateMachine.hpp),
+// shared by both altimeters.  |State| is the firmware's FlightState, which
+// has to name kReadyToFly, kAscending, kDescending and kOnGround.  The
+// guards and actions are static functions of |Handlers|: FlightController in
+// ComplexAltimeter and FlightHandlers in SimpleAltimeter.  tests/host
+// replays this same table over recorded traces with handlers of its own.
+//
+// Only the transitions out of the current state are looked at on each tick.
+// Keep these sorted by the state they leave.
+template <typename State, typename Context, typename Handlers>
+struct FlightPhases {
+  static constexpr FlightTransition<State, Context> kFlightTransitions[] = {
+      {State::kReadyToFly, State::kAscending, Handlers::isLaunched,
+       Handlers::onLaunch},
+      {State::kAscending, State::kDescending, Handlers::isPastApogee,
+       Handlers::onApogee},
+      {State::kDescending, State::kOnGround, Handlers::isLanded,
+       Handlers::onLanding},
+  };
+};
+
+template <typename State, typename Context, typename Handlers>
+constexpr FlightTransition<State, Context>
+    FlightPhases<State, Context, Handlers>::kFlightTransitions[];
+
+#endif
@@ -0,0 +1,122 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef FlightStateMachine_h
+#define FlightStateMachine_h
+
+#include <stddef.h>
+
+// The flight phases as a table of transitions, shared by both altimeters.
+// Each firmware supplies its own State enum, a Context (whatever the guards
+// need to see) and a table sorted by the state the transitions leave:
+//
+//   static constexpr FlightTransition<FlightState, Tick> kTable[] = {
+//       {kReadyToFly, kAscending, isLaunched, onLaunch},
+//       {kAscending, kDescending, isPastApogee, onApogee},
+//   };
+//   static_assert(transitionsSorted(kTable), "...");
+//   constexpr FlightStateMachine<FlightState, Tick> kMachine(kTable, stamp);
+//
+// step() only runs the guards of the transitions leaving the current state,
+// in table order, and takes the first that passes.  At most one transition
+// is taken per step.  Every transition, including the ones forced with
+// enter(), is passed to the stamp function before its action runs so the
+// event is logged ahead of anything the action does.
+
+template <typename State, typename Context>
+struct FlightTransition {
+  State from;
+  State to;
+  bool (*guard)(Context &);   // nullptr always passes
+  void (*action)(Context &);  // May be nullptr
+};
+
+template <typename State, typename Context, size_t N>
+constexpr bool transitionsSorted(const FlightTransition<State, Context> (&t)[N],
+                                 size_t i = 1)
+{
+  return i >= N ? true
+                : t[i - 1].from <= t[i].from && transitionsSorted(t, i + 1);
+}
+
+template <typename State, typename Context>
+class FlightStateMachine
+{
+ public:
+  typedef FlightTransition<State, Context> Transition;
+  typedef void (*StampFunction)(Context &, State from, State to);
+
+  template <size_t N>
+  constexpr FlightStateMachine(const Transition (&table)[N],
+                               StampFunction stamp)
+      : table(table), count(N), stamp(stamp)
+  {
+  }
+
+  // Takes the first transition out of |state| whose guard passes.  Returns
+  // true if |state| changed.
+  bool step(State &state, Context &context) const
+  {
+    for (size_t i = 0; i < count; i++) {
+      const Transition &t = table[i];
+      if (t.from < state) {
+        continue;
+      }
+      if (t.from > state) {
+        break;
+      }
+      if (!t.guard || t.guard(context)) {
+        enter(state, t.to, context);
+        if (t.action) {
+          t.action(context);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Unconditional transition, for arming and disarming.  Stamped like any
+  // other unless |state| is already |to|.
+  void enter(State &state, State to, Context &context) const
+  {
+    if (state == to) {
+      return;
+    }
+    State from = state;
+    state      = to;
+    if (stamp) {
+      stamp(context, from, to);
+    }
+  }
+
+ private:
+  const Transition *table;
+  size_t count;
+  StampFunction stamp;
+};
+
+#endif
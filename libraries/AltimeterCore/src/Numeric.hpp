@@ -0,0 +1,192 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef numeric_h
+#define numeric_h
+
+#include <math.h>
+#include <stdint.h>
+
+// The numeric type the sensor to decision pipeline runs in, chosen per build
+// by NUMERIC_POLICY below.  Neither the ESP8266 nor the AVR has
+// an FPU so every double operation on the 10ms tick is a soft double call.
+//
+//   kNumericDouble  The reference.  Identical to the old behaviour.
+//   kNumericFloat   Soft float.  Roughly half the cost of double.
+//   kNumericFixed   Q15.16 fixed point.  Integer adds and 32x32->64
+//                   multiplies.  +-32767 with a resolution of 15um.
+//
+// real_t only covers the pipeline: the filters, the launch detector, the baro
+// lockout and the flight state machine.  The sensor libraries, the display
+// and the logs keep their own types and convert at the edges with toFloat().
+
+#define kNumericDouble 0
+#define kNumericFloat 1
+#define kNumericFixed 2
+
+// Signed fixed point with F fractional bits in 32 bits.  Intermediate
+// products and quotients are 64 bits so they don't overflow, but results
+// outside the range wrap.
+template <int F>
+class Fixed
+{
+ public:
+  constexpr Fixed() : raw(0) {}
+
+  // Constant conversions fold at compile time
+  constexpr Fixed(double v)
+      : raw((int32_t)(v * (1L << F) + (v >= 0 ? 0.5 : -0.5)))
+  {
+  }
+
+  static constexpr Fixed fromRaw(int32_t r) { return Fixed(r, true); }
+
+  explicit operator float() const { return raw / (float)(1L << F); }
+  explicit operator double() const { return raw / (double)(1L << F); }
+
+  int32_t getRaw() const { return raw; }
+
+  Fixed operator-() const { return fromRaw(-raw); }
+  Fixed &operator+=(Fixed b)
+  {
+    raw += b.raw;
+    return *this;
+  }
+  Fixed &operator-=(Fixed b)
+  {
+    raw -= b.raw;
+    return *this;
+  }
+  Fixed &operator*=(Fixed b) { return *this = *this * b; }
+  Fixed &operator/=(Fixed b) { return *this = *this / b; }
+
+  friend Fixed operator+(Fixed a, Fixed b) { return fromRaw(a.raw + b.raw); }
+  friend Fixed operator-(Fixed a, Fixed b) { return fromRaw(a.raw - b.raw); }
+  friend Fixed operator*(Fixed a, Fixed b)
+  {
+    return fromRaw((int32_t)(((int64_t)a.raw * b.raw) >> F));
+  }
+  friend Fixed operator/(Fixed a, Fixed b)
+  {
+    return fromRaw((int32_t)(((int64_t)a.raw << F) / b.raw));
+  }
+
+  friend bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+  friend bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+  friend bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+  friend bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+  friend bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+  friend bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+ private:
+  constexpr Fixed(int32_t r, bool) : raw(r) {}
+
+  int32_t raw;
+};
+
+// Conversions in from the sensors that don't go through double
+template <typename T>
+struct RealConvert {
+  static T fromFloat(float v) { return v; }
+  static T fromMillis(long ms) { return (T)ms / 1000; }
+  static T fromMicros(long us) { return (T)us / 1000000; }
+  static T overMillis(T rate, long ms) { return rate * (T)ms / 1000; }
+};
+
+template <int F>
+struct RealConvert<Fixed<F> > {
+  static Fixed<F> fromFloat(float v)
+  {
+    return Fixed<F>::fromRaw(
+        (int32_t)(v * (1L << F) + (v >= 0 ? 0.5f : -0.5f)));
+  }
+  static Fixed<F> fromMillis(long ms)
+  {
+    return Fixed<F>::fromRaw((int32_t)(((int64_t)ms << F) / 1000));
+  }
+  static Fixed<F> fromMicros(long us)
+  {
+    return Fixed<F>::fromRaw((int32_t)(((int64_t)us << F) / 1000000));
+  }
+  // 10ms is 655/65536s, 0.05% short, which adds up when integrating
+  static Fixed<F> overMillis(Fixed<F> rate, long ms)
+  {
+    return Fixed<F>::fromRaw((int32_t)((int64_t)rate.getRaw() * ms / 1000));
+  }
+};
+
+// Select the policy for the build here, or with -DNUMERIC_POLICY.  It can't
+// live in Configuration.h because FlightData is included ahead of it.
+#ifndef NUMERIC_POLICY
+#define NUMERIC_POLICY kNumericFloat
+#endif
+
+#if NUMERIC_POLICY == kNumericDouble
+typedef double real_t;
+#elif NUMERIC_POLICY == kNumericFloat
+typedef float real_t;
+#elif NUMERIC_POLICY == kNumericFixed
+typedef Fixed<16> real_t;
+#else
+#error Unknown NUMERIC_POLICY
+#endif
+
+inline real_t toReal(float v) { return RealConvert<real_t>::fromFloat(v); }
+
+// Elapsed times in seconds
+inline real_t secondsFromMillis(long ms)
+{
+  return RealConvert<real_t>::fromMillis(ms);
+}
+inline real_t secondsFromMicros(long us)
+{
+  return RealConvert<real_t>::fromMicros(us);
+}
+
+// The change over |ms| at |rate| per second.  Use this rather than
+// multiplying by secondsFromMillis() when integrating.
+inline real_t overMillis(real_t rate, long ms)
+{
+  return RealConvert<real_t>::overMillis(rate, ms);
+}
+
+inline float toFloat(double v) { return v; }
+inline float toFloat(float v) { return v; }
+template <int F>
+inline float toFloat(Fixed<F> v)
+{
+  return (float)v;
+}
+
+inline double realAbs(double v) { return fabs(v); }
+inline float realAbs(float v) { return fabsf(v); }
+template <int F>
+inline Fixed<F> realAbs(Fixed<F> v)
+{
+  return v < Fixed<F>() ? -v : v;
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef outputpin_h
+#define outputpin_h
+
+#include <Arduino.h>
+
+// Digital outputs with the pin fixed at compile time.  A board profile names
+// each of its indicator pins as one of these:
+//
+//   typedef OutputPin<D6> MessagePin;
+//   typedef NoOutput ReadyPin;
+//
+// and the code writes to them with MessagePin::write(HIGH).  Writes to a
+// NoOutput compile to nothing, so there are no NO_PIN checks at runtime.
+
+// An output the board doesn't have
+class NoOutput
+{
+ public:
+  static constexpr bool kPresent = false;
+
+  static void begin() {}
+  static void write(bool high) {}
+  static void analog(int level) {}
+};
+
+// A digital output on |Pin|.  On the ESP8266 and the ATmega328P (the nano)
+// write() sets the port register directly.  Don't write() a pin that is
+// also driven with analog() without a digitalWrite() in between; the PWM
+// is left running.
+template <uint8_t Pin>
+class OutputPin
+{
+ public:
+  static constexpr bool kPresent = true;
+
+  static void begin() { pinMode(Pin, OUTPUT); }
+
+  static void write(bool high)
+  {
+#if defined(ESP8266)
+    static_assert(Pin <= 16, "No such GPIO");
+    if (Pin < 16) {
+      if (high) {
+        GPOS = (1 << Pin);
+      } else {
+        GPOC = (1 << Pin);
+      }
+    } else {
+      if (high) {
+        GP16O |= 1;
+      } else {
+        GP16O &= ~1;
+      }
+    }
+#elif defined(__AVR_ATmega328P__)
+    static_assert(Pin < 20, "No such pin");
+    // Constant port and bit, so these are single sbi/cbi instructions
+    if (high) {
+      port() |= _BV(kBit);
+    } else {
+      port() &= ~_BV(kBit);
+    }
+#else
+    digitalWrite(Pin, high ? HIGH : LOW);
+#endif
+  }
+
+  static void analog(int level) { analogWrite(Pin, level); }
+
+ private:
+#if defined(__AVR_ATmega328P__)
+  // Pins 0-7 are port D, 8-13 port B and A0-A5 (14-19) port C
+  static constexpr uint8_t kBit =
+      Pin < 8 ? Pin : (Pin < 14 ? Pin - 8 : Pin - 14);
+
+  static volatile uint8_t &port()
+  {
+    return Pin < 8 ? PORTD : (Pin < 14 ? PORTB : PORTC);
+  }
+#endif
+};
+
+#endif
@@ -1,4 +1,3 @@
-
 /*********************************************************************************
  * Open Altimeter
  *
@@ -25,73 +24,47 @@
  * SOFTWARE.
  **********************************************************************************/
 
-
 #include "RecoveryDevice.h"
-#ifdef IS_SIMPLE_ALT
-#include "Configuration.h"
-#else
-#include "../Configuration.h"
-#endif
-#include "types.h"
 
-void RecoveryDevice::init(byte id, byte pin, RecoveryDeviceType type)
+int RecoveryDevice::onAngle  = RecoveryDevice::kDefaultOnAngle;
+int RecoveryDevice::offAngle = RecoveryDevice::kDefaultOffAngle;
+
+void RecoveryDevice::init(byte id)
 {
-  //log("Init RD " + String(id) + " p:" + String(pin));
-  this->gpioPin = pin;
-  this->id       = id;
-  this->type     = type;
-  switch (type) {
-    case kPyro:
-      pinMode(pin, OUTPUT);
-      break;
-    case kServo:
-      servo.attach(pin);
-      break;
-    case kNoEjection:
-      break;
-  }
+  this->id = id;
+  begin();
   reset();
 };
 
 void RecoveryDevice::enable()
 {
-  deployed       = true;
-  deploymentTime = millis();
-  deviceState     = ON;
-  switch (type) {
-    case kPyro:
-      digitalWrite(gpioPin, HIGH);
-      break;
-    case kServo:
-      servo.write(kChuteReleaseTriggeredAngle);
-      break;
-    case kNoEjection:
-      break;
-  }
-  Serial.println("RD En" + String(id) );
+  noteEnabled(millis());
+  write(true);
 };
 
+void RecoveryDevice::noteEnabled(unsigned long ms)
+{
+  deployed       = true;
+  deploymentTime = ms;
+  deviceState    = ON;
+}
+
+void RecoveryDevice::noteTimedCut()
+{
+  deviceState = OFF;
+  timedReset  = true;
+}
+
 void RecoveryDevice::disable()
 {
-  deployed   = false;
+  deployed    = false;
   deviceState = OFF;
-  switch (type) {
-    case kPyro:
-      digitalWrite(gpioPin, LOW);
-      break;
-    case kServo:
-      servo.write(kChuteReleaseArmedAngle);
-      break;
-    case kNoEjection:
-      break;
-  }
-  Serial.println("RD Dis" + String(id) );
+  write(false);
 };
 
 void RecoveryDevice::reset()
 {
-  deployed       = false;
+  disable();
   deploymentTime = 0;
   timedReset     = false;
-  disable();
 };
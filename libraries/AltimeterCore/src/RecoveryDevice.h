@@ -0,0 +1,146 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+#ifndef RECOVERYDEVICE_H
+#define RECOVERYDEVICE_H
+
+#include <Servo.h>
+#include "AltimeterCore.h"
+
+// A pyro channel (on/off) or a servo chute release.  The board profile picks
+// the output for each channel:
+//
+//   typedef RecoveryChannel<OutputPin<D3>> Channel1;   // Pyro
+//   typedef RecoveryChannel<ServoOutput<D4>> Channel2; // Servo release
+//   typedef RecoveryChannel<NoOutput> Channel3;        // Not fitted
+//
+// Saving the servo angles is up to the firmware; both boards start from the
+// defaults here.
+class RecoveryDevice
+{
+ public:
+  virtual ~RecoveryDevice(){};
+
+  static const int kDefaultOnAngle  = 45;
+  static const int kDefaultOffAngle = 90;
+
+  static const uint8_t kNoSwitchPin = 0xFF;
+
+  // Servo angles for a deployed and an armed release
+  static int onAngle;
+  static int offAngle;
+
+  bool deployed      = false;  // True if the the chute has been deplyed
+  int deploymentTime = 0;      // Time at which the chute was deployed
+  bool timedReset    = false;  // True if the relay was reset on a timeout
+  RecoveryDeviceState deviceState = OFF;
+  const RecoveryDeviceType type;
+
+  // The pin a pyro channel switches, or kNoSwitchPin.  Lets a timer
+  // interrupt fire the channel without calling into the device.
+  const uint8_t switchPin;
+
+ public:
+  void init(byte id);
+  void enable();
+  void disable();
+  void reset();
+
+  // Book-keeping for an output that was switched by someone else (at |ms|
+  // millis()).  A timed cut leaves the chute marked as deployed.
+  void noteEnabled(unsigned long ms);
+  void noteTimedCut();
+
+  byte id = 0;
+
+ protected:
+  RecoveryDevice(RecoveryDeviceType type, uint8_t switchPin)
+      : type(type), switchPin(switchPin){};
+
+  virtual void begin() = 0;
+  virtual void write(bool fire) = 0;
+};
+
+// Drives a servo to RecoveryDevice::onAngle when fired
+template <uint8_t Pin>
+class ServoOutput
+{
+ public:
+  void begin() { servo.attach(Pin); }
+
+  void write(bool fire)
+  {
+    servo.write(fire ? RecoveryDevice::onAngle : RecoveryDevice::offAngle);
+  }
+
+ private:
+  Servo servo;
+};
+
+// The RecoveryDeviceType for each kind of output.  Anything else is a pyro
+// channel on a digital output.
+template <typename Output>
+struct RecoveryOutputType {
+  static constexpr RecoveryDeviceType value = kPyro;
+};
+
+template <>
+struct RecoveryOutputType<NoOutput> {
+  static constexpr RecoveryDeviceType value = kNoEjection;
+};
+
+template <uint8_t Pin>
+struct RecoveryOutputType<ServoOutput<Pin>> {
+  static constexpr RecoveryDeviceType value = kServo;
+};
+
+template <typename Output>
+struct RecoverySwitchPin {
+  static constexpr uint8_t value = RecoveryDevice::kNoSwitchPin;
+};
+
+template <uint8_t Pin>
+struct RecoverySwitchPin<OutputPin<Pin>> {
+  static constexpr uint8_t value = Pin;
+};
+
+template <typename Output>
+class RecoveryChannel : public RecoveryDevice
+{
+ public:
+  RecoveryChannel()
+      : RecoveryDevice(RecoveryOutputType<Output>::value,
+                       RecoverySwitchPin<Output>::value){};
+
+ protected:
+  void begin() override { output.begin(); }
+  void write(bool fire) override { output.write(fire); }
+
+ private:
+  Output output;
+};
+
+#endif  // RECOVERYDEVICE_H
@@ -0,0 +1,311 @@
+/*
+ * SimpleTimer.cpp
+ *
+ * SimpleTimer - A timer library for Arduino.
+ * Author: mromani@ottotecnica.com
+ * Copyright (c) 2010 OTTOTECNICA Italy
+ *
+ * This library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser
+ * General Public License as published by the Free Software
+ * Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser
+ * General Public License along with this library; if not,
+ * write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#include "SimpleTimer.h"
+
+SimpleTimer::SimpleTimer(timer_clock clock) : clock(clock)
+{
+  for (byte level = 0; level < PRIORITY_LEVELS; level++) {
+    heapSize[level] = 0;
+  }
+  numTimers = 0;
+}
+
+void SimpleTimer::run()
+{
+  // Bound the work done per call so a callback that overruns its own period
+  // can't keep us in here forever.
+  for (int i = 0; i < MAX_TIMERS; i++) {
+    unsigned long now = clock();
+    int numTimer      = nextDueTimer(now);
+    if (numTimer < 0) {
+      return;
+    }
+    fire(numTimer, now);
+  }
+}
+
+int SimpleTimer::nextDueTimer(unsigned long now)
+{
+  for (byte level = 0; level < PRIORITY_LEVELS; level++) {
+    if (heapSize[level]) {
+      byte numTimer = heap[level][0];
+      if ((long)(now - timers[numTimer].due) >= 0) {
+        return numTimer;
+      }
+    }
+  }
+  return -1;
+}
+
+void SimpleTimer::fire(int numTimer, unsigned long now)
+{
+  Timer &t              = timers[numTimer];
+  TimerDelegate *target = t.callback;
+  unsigned long late    = now - t.due;
+
+  if (!t.enabled) {
+    // Disabled timers keep their schedule but don't run
+    t.due += t.period * (late / t.period + 1);
+    heapUpdate(numTimer);
+    return;
+  }
+
+  t.lateness    = late;
+  t.maxLateness = max(t.maxLateness, t.lateness);
+
+  bool lastRun = false;
+  if (t.maxNumRuns != RUN_FOREVER) {
+    t.numRuns++;
+    lastRun = t.numRuns >= t.maxNumRuns;
+  }
+
+  // Reschedule (or free the slot) before the callback so the callback is free
+  // to delete, restart or create timers - including reusing this slot.
+  if (lastRun) {
+    deleteTimer(numTimer);
+  } else {
+    unsigned long missed = late / t.period;
+    t.missedRuns += missed;
+    t.due += t.period * (missed + 1);
+    heapUpdate(numTimer);
+  }
+
+  target->timerFired(numTimer);
+}
+
+// find the first available slot
+// return -1 if none found
+int SimpleTimer::findFirstFreeSlot()
+{
+  // all slots are used
+  if (numTimers >= MAX_TIMERS) {
+    return -1;
+  }
+
+  // return the first slot with no callback (i.e. free)
+  for (int i = 0; i < MAX_TIMERS; i++) {
+    if (timers[i].callback == nullptr) {
+      return i;
+    }
+  }
+
+  // no free slots found
+  return -1;
+}
+
+int SimpleTimer::setTimer(unsigned long d, TimerDelegate *f, int n,
+                          byte priority)
+{
+  if (f == nullptr || d == 0 || priority >= PRIORITY_LEVELS) {
+    return -1;
+  }
+
+  int freeTimer = findFirstFreeSlot();
+  if (freeTimer < 0) {
+    return -1;
+  }
+
+  Timer &t      = timers[freeTimer];
+  t.callback    = f;
+  t.period      = d;
+  t.due         = clock() + d;
+  t.maxNumRuns  = n;
+  t.numRuns     = 0;
+  t.enabled     = true;
+  t.priority    = priority;
+  t.lateness    = 0;
+  t.maxLateness = 0;
+  t.missedRuns  = 0;
+  heapInsert(freeTimer);
+
+  numTimers++;
+
+  return freeTimer;
+}
+
+int SimpleTimer::setInterval(unsigned long d, TimerDelegate *f, byte priority)
+{
+  return setTimer(d, f, RUN_FOREVER, priority);
+}
+
+int SimpleTimer::setTimeout(unsigned long d, TimerDelegate *f, byte priority)
+{
+  return setTimer(d, f, RUN_ONCE, priority);
+}
+
+void SimpleTimer::deleteTimer(int timerId)
+{
+  // nothing to delete if the slot is already empty
+  if (!isValid(timerId)) {
+    return;
+  }
+
+  heapRemove(timerId);
+  timers[timerId].callback = nullptr;
+  timers[timerId].enabled  = false;
+
+  // update number of timers
+  numTimers--;
+}
+
+// function contributed by code@rowansimms.com
+void SimpleTimer::restartTimer(int numTimer)
+{
+  if (!isValid(numTimer)) {
+    return;
+  }
+
+  timers[numTimer].due = clock() + timers[numTimer].period;
+  heapUpdate(numTimer);
+}
+
+boolean SimpleTimer::isEnabled(int numTimer)
+{
+  if (!isValid(numTimer)) {
+    return false;
+  }
+
+  return timers[numTimer].enabled;
+}
+
+void SimpleTimer::enable(int numTimer)
+{
+  if (!isValid(numTimer)) {
+    return;
+  }
+
+  timers[numTimer].enabled = true;
+}
+
+void SimpleTimer::disable(int numTimer)
+{
+  if (!isValid(numTimer)) {
+    return;
+  }
+
+  timers[numTimer].enabled = false;
+}
+
+void SimpleTimer::toggle(int numTimer)
+{
+  if (!isValid(numTimer)) {
+    return;
+  }
+
+  timers[numTimer].enabled = !timers[numTimer].enabled;
+}
+
+int SimpleTimer::getNumTimers() { return numTimers; }
+
+unsigned long SimpleTimer::getLateness(int numTimer)
+{
+  return isValid(numTimer) ? timers[numTimer].lateness : 0;
+}
+
+unsigned long SimpleTimer::getMaxLateness(int numTimer)
+{
+  return isValid(numTimer) ? timers[numTimer].maxLateness : 0;
+}
+
+unsigned long SimpleTimer::getMissedRuns(int numTimer)
+{
+  return isValid(numTimer) ? timers[numTimer].missedRuns : 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Heap maintenance
+
+void SimpleTimer::heapSwap(byte level, byte i, byte j)
+{
+  byte a         = heap[level][i];
+  byte b         = heap[level][j];
+  heap[level][i] = b;
+  heap[level][j] = a;
+  timers[b].heapPos = i;
+  timers[a].heapPos = j;
+}
+
+void SimpleTimer::siftUp(byte level, byte pos)
+{
+  while (pos > 0) {
+    byte parent = (pos - 1) / 2;
+    if (!isEarlier(heap[level][pos], heap[level][parent])) {
+      return;
+    }
+    heapSwap(level, pos, parent);
+    pos = parent;
+  }
+}
+
+void SimpleTimer::siftDown(byte level, byte pos)
+{
+  byte size = heapSize[level];
+  while (true) {
+    byte smallest = pos;
+    byte left     = 2 * pos + 1;
+    byte right    = left + 1;
+    if (left < size && isEarlier(heap[level][left], heap[level][smallest])) {
+      smallest = left;
+    }
+    if (right < size && isEarlier(heap[level][right], heap[level][smallest])) {
+      smallest = right;
+    }
+    if (smallest == pos) {
+      return;
+    }
+    heapSwap(level, pos, smallest);
+    pos = smallest;
+  }
+}
+
+void SimpleTimer::heapInsert(byte numTimer)
+{
+  byte level              = timers[numTimer].priority;
+  byte pos                = heapSize[level]++;
+  heap[level][pos]        = numTimer;
+  timers[numTimer].heapPos = pos;
+  siftUp(level, pos);
+}
+
+void SimpleTimer::heapRemove(byte numTimer)
+{
+  byte level = timers[numTimer].priority;
+  byte pos   = timers[numTimer].heapPos;
+  byte last  = --heapSize[level];
+  if (pos != last) {
+    heapSwap(level, pos, last);
+    heapUpdate(heap[level][pos]);
+  }
+}
+
+void SimpleTimer::heapUpdate(byte numTimer)
+{
+  byte level = timers[numTimer].priority;
+  byte pos   = timers[numTimer].heapPos;
+  siftUp(level, pos);
+  siftDown(level, timers[numTimer].heapPos);
+}
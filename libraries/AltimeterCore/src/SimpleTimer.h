@@ -0,0 +1,186 @@
+/*
+ * SimpleTimer.h
+ *
+ * SimpleTimer - A timer library for Arduino.
+ * Author: mromani@ottotecnica.com
+ * Copyright (c) 2010 OTTOTECNICA Italy
+ *
+ * This library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser
+ * General Public License as published by the Free Software
+ * Foundation; either version 2.1 of the License, or (at
+ * your option) any later version.
+ *
+ * This library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser
+ * General Public License along with this library; if not,
+ * write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#ifndef SIMPLETIMER_H
+#define SIMPLETIMER_H
+
+#ifndef __AVR__
+#include <functional>
+#endif  // __AVR__
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+class TimerDelegate
+{
+ public:
+  virtual void timerFired(int timerNumber) {}
+};
+
+using timer_callback = void (*)();
+using timer_clock    = unsigned long (*)();
+
+class TimerProxy : public TimerDelegate
+{
+ public:
+  TimerProxy(timer_callback callback) : callback(callback){};
+
+  void timerFired(int timerNumber) { callback(); }
+
+ private:
+  timer_callback callback = nullptr;
+};
+
+// Timers are kept in one min-heap per priority level ordered by their due
+// time so run() only ever looks at the head of each heap.  Due high priority
+// timers always fire before any normal priority timer, and between normal
+// priority callbacks.  Periodic timers are rescheduled from their due time
+// (not from when they actually ran) so they don't drift.  If a timer falls
+// more than a whole period behind, the missed runs are skipped and counted
+// rather than fired back-to-back.
+class SimpleTimer
+{
+ public:
+  // maximum number of timers
+  const static int MAX_TIMERS = 10;
+
+  // setTimer() constants
+  const static int RUN_FOREVER = 0;
+  const static int RUN_ONCE    = 1;
+
+  // priority levels
+  const static byte PRIORITY_HIGH   = 0;
+  const static byte PRIORITY_NORMAL = 1;
+  const static byte PRIORITY_LEVELS = 2;
+
+  // constructor.  The clock defaults to millis() but may be replaced
+  // with any monotonic millisecond clock.
+  SimpleTimer(timer_clock clock = millis);
+
+  // this function must be called inside loop()
+  void run();
+
+  // call function f every d milliseconds
+  int setInterval(unsigned long d, TimerDelegate *f,
+                  byte priority = PRIORITY_NORMAL);
+
+  // call function f once after d milliseconds
+  int setTimeout(unsigned long d, TimerDelegate *f,
+                 byte priority = PRIORITY_NORMAL);
+
+  // call function f every d milliseconds for n times
+  int setTimer(unsigned long d, TimerDelegate *f, int n,
+               byte priority = PRIORITY_NORMAL);
+
+  // destroy the specified timer
+  void deleteTimer(int numTimer);
+
+  // restart the specified timer
+  void restartTimer(int numTimer);
+
+  // returns true if the specified timer is enabled
+  boolean isEnabled(int numTimer);
+
+  // enables the specified timer
+  void enable(int numTimer);
+
+  // disables the specified timer
+  void disable(int numTimer);
+
+  // enables the specified timer if it's currently disabled,
+  // and vice-versa
+  void toggle(int numTimer);
+
+  // returns the number of used timers
+  int getNumTimers();
+
+  // returns the number of available timers
+  int getNumAvailableTimers() { return MAX_TIMERS - numTimers; };
+
+  // how late (in ms) the timer's last callback fired and the worst case
+  // since it was created
+  unsigned long getLateness(int numTimer);
+  unsigned long getMaxLateness(int numTimer);
+
+  // number of periods skipped because the timer fell behind
+  unsigned long getMissedRuns(int numTimer);
+
+ private:
+  struct Timer {
+    TimerDelegate *callback   = nullptr;  // nullptr == free slot
+    unsigned long due         = 0;        // clock() value of the next run
+    unsigned long period      = 0;
+    int maxNumRuns            = 0;
+    int numRuns               = 0;
+    boolean enabled           = false;
+    byte priority             = PRIORITY_NORMAL;
+    byte heapPos              = 0;
+    unsigned long lateness    = 0;
+    unsigned long maxLateness = 0;
+    unsigned long missedRuns  = 0;
+  };
+
+  timer_clock clock;
+
+  Timer timers[MAX_TIMERS];
+
+  // Timer numbers, one heap per priority level, earliest due first
+  byte heap[PRIORITY_LEVELS][MAX_TIMERS];
+  byte heapSize[PRIORITY_LEVELS];
+
+  // actual number of timers in use
+  int numTimers;
+
+  // find the first available slot
+  int findFirstFreeSlot();
+
+  // returns the due timer with the highest priority or -1
+  int nextDueTimer(unsigned long now);
+  void fire(int numTimer, unsigned long now);
+
+  bool isValid(int numTimer)
+  {
+    return numTimer >= 0 && numTimer < MAX_TIMERS &&
+           timers[numTimer].callback != nullptr;
+  }
+
+  bool isEarlier(byte a, byte b)
+  {
+    return (long)(timers[a].due - timers[b].due) < 0;
+  }
+
+  void heapInsert(byte numTimer);
+  void heapRemove(byte numTimer);
+  void heapUpdate(byte numTimer);
+  void heapSwap(byte level, byte i, byte j);
+  void siftUp(byte level, byte pos);
+  void siftDown(byte level, byte pos);
+};
+
+#endif
@@ -24,37 +24,28 @@
  * SOFTWARE.
  **********************************************************************************/
 
+#ifndef tickertimersource_h
+#define tickertimersource_h
 
-#ifndef RECOVERYDEVICE_H
-#define RECOVERYDEVICE_H
+#include <Ticker.h>
+#include "SimpleTimer.h"
 
-#include <Servo.h>
-#include "types.h"
-
-class RecoveryDevice
+// One shot timers for Blinker from the ESP8266 Ticker.  Fires from the
+// Ticker's timer task, not the main loop.  ESP8266 only.
+class TickerTimerSource
 {
  public:
-  RecoveryDevice() { this->reset(); };
-
-  ~RecoveryDevice(){};
+  void once(unsigned long ms, TimerDelegate *delegate)
+  {
+    ticker.once_ms(ms, fire, delegate);
+  }
 
-  bool deployed      = false;  // True if the the chute has been deplyed
-  int deploymentTime = 0;      // Time at which the chute was deployed
-  bool timedReset =
-      false;  // True if we've reset the chute relay due to a timeout
-  RecoveryDeviceState deviceState = OFF;  // State of the parachute relay pin.  Recorded
-                                // separately.  To avoid fire.
-  RecoveryDeviceType type = kNoEjection;
-  Servo servo;
+  void cancel() { ticker.detach(); }
 
-  byte gpioPin = 0;
-  byte id      = 0;
+ private:
+  Ticker ticker;
 
- public:
-  void init(byte id, byte pin, RecoveryDeviceType type);
-  void enable();
-  void disable();
-  void reset();
+  static void fire(TimerDelegate *delegate) { delegate->timerFired(0); }
 };
 
-#endif  // RECOVERYDEVICE_H
+#endif
@@ -24,69 +24,32 @@
  * SOFTWARE.
  **********************************************************************************/
 
-#ifndef blinksequence_h
-#define blinksequence_h
+#ifndef timersource_h
+#define timersource_h
 
-#ifdef IS_SIMPLE_ALT
 #include "SimpleTimer.h"
-#include "types.h"
-#else
-#include <Ticker.h>
-#include "../types.h"
-class TimerDelegate
-{
-};
-#endif
-
-// 128 bits will represent 64 on-off events.
-// the number 1000 would require ~34 so this should
-// be sufficient.
-#define kBitMapLen 16
 
-class Blinker : public TimerDelegate
+// One shot timers for Blinker, paced by the sketch's SimpleTimer.  Fires from
+// SimpleTimer::run() in the main loop.
+class SimpleTimerSource
 {
  public:
-#ifdef IS_SIMPLE_ALT
-  Blinker(SimpleTimer &timer, byte ledPin, byte piezoPin)
-      : timer(timer), ledPin(ledPin), piezoPin(piezoPin)
+  SimpleTimerSource(SimpleTimer &timer) : timer(timer) {}
+
+  void once(unsigned long ms, TimerDelegate *delegate)
   {
+    timerNumber = timer.setTimeout(ms, delegate);
   }
-#else
-  Blinker(int ledPin, int piezoPin) : ledPin(ledPin), piezoPin(piezoPin) {}
-#endif
-
-  ~Blinker() { cancelSequence(); };
-
-  void blinkValue(long value, int speed, bool repeat, bool pause = true);
-  void cancelSequence();
-  bool isBlinking();
 
-#ifdef IS_SIMPLE_ALT
-  void timerFired(int timerNumber) override;
-#else
-  void timerFired(int timerNumber);
-#endif
+  void cancel()
+  {
+    timer.deleteTimer(timerNumber);
+    timerNumber = -1;
+  }
 
  private:
-  byte timerNumber = 0;
-  byte bitMap[kBitMapLen];
-
-  void setHardwareState(BlinkerState hwState);
-
-  int ledPin   = NO_PIN;
-  int piezoPin = NO_PIN;
-
-  byte sequenceLen = 0;
-  byte position    = 0;
-  bool repeat      = 0;
-  int speed        = 0;
-
-#ifdef IS_SIMPLE_ALT
   SimpleTimer &timer;
-#else
-  Ticker ticker;
-#endif
-  bool isRunning;
+  int timerNumber = -1;
 };
 
 #endif
@@ -61,6 +61,12 @@ public:
 		if (!anglesComputed) computeAngles();
 		return yaw;
 	}
+	void getQuaternion(float *q) {
+		q[0] = q0;
+		q[1] = q1;
+		q[2] = q2;
+		q[3] = q3;
+	}
 };
 
 #endif
@@ -0,0 +1,123 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Just enough of Arduino.h to build the hardware independent parts of the
+// altimeters on a desktop.  millis() and micros() read a virtual clock the
+// tests drive by hand.  The pins go nowhere except where noted.
+
+#ifndef host_arduino_h
+#define host_arduino_h
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::max;
+using std::min;
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline void digitalWrite(uint8_t pin, uint8_t value) {}
+inline int digitalRead(uint8_t pin) { return LOW; }
+inline void analogWrite(uint8_t pin, int value) {}
+
+extern unsigned long hostMillis;
+extern unsigned long hostMicros;
+
+inline unsigned long millis() { return hostMillis; }
+inline unsigned long micros() { return hostMicros; }
+
+// Advances both clocks by |ms|
+inline void hostAdvance(unsigned long ms)
+{
+  hostMillis += ms;
+  hostMicros += ms * 1000;
+}
+
+// Advances both clocks by |us|
+inline void hostAdvanceMicros(unsigned long us)
+{
+  hostMicros += us;
+  hostMillis = hostMicros / 1000;
+}
+
+// The ESP8266 registers and timer0 the DeploymentScheduler uses.  GPIO
+// 0-15 land in hostGpio and GPIO16 in hostGpio16.  timer0_write() sets
+// hostTimer0Compare and the test runs hostTimer0Isr when it decides the
+// compare has matched.  The cycle counter runs at 80MHz off micros().
+
+#define ICACHE_RAM_ATTR
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+extern uint32_t hostGpio;
+extern uint32_t hostGpio16;
+
+struct HostGpioRegister {
+  bool set;
+  void operator=(uint32_t mask)
+  {
+    hostGpio = set ? hostGpio | mask : hostGpio & ~mask;
+  }
+};
+
+extern HostGpioRegister GPOS;
+extern HostGpioRegister GPOC;
+#define GP16O hostGpio16
+
+struct HostEsp {
+  uint8_t getCpuFreqMHz() { return 80; }
+  uint32_t getCycleCount() { return (uint32_t)(hostMicros * 80); }
+};
+
+extern HostEsp ESP;
+
+typedef void (*timercallback)(void);
+
+extern timercallback hostTimer0Isr;
+extern uint32_t hostTimer0Compare;
+extern bool hostTimer0Armed;
+
+inline void timer0_isr_init() {}
+inline void timer0_attachInterrupt(timercallback isr) { hostTimer0Isr = isr; }
+inline void timer0_write(uint32_t count)
+{
+  hostTimer0Compare = count;
+  hostTimer0Armed   = true;
+}
+
+#endif
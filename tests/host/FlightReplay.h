@@ -0,0 +1,79 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Control tick traces for replaying the flight state tables.  Each line of a
+// trace in traces/ is "ms,altitude,velocity,acceleration"; lines starting
+// with # are comments.
+
+#ifndef flight_replay_h
+#define flight_replay_h
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+typedef struct {
+  long ms;
+  float altitude;      // m
+  float velocity;      // m/s
+  float acceleration;  // m/s/s, as the IMU reads it
+} TraceTick;
+
+// Returns an empty trace if |name| can't be read
+inline std::vector<TraceTick> loadTrace(const char *name)
+{
+  std::vector<TraceTick> trace;
+  std::string path = std::string("traces/") + name;
+  FILE *f          = fopen(path.c_str(), "r");
+  if (!f) {
+    printf("Can't open %s\n", path.c_str());
+    return trace;
+  }
+  char line[128];
+  while (fgets(line, sizeof(line), f)) {
+    TraceTick t;
+    if (line[0] != '#' && sscanf(line, "%ld,%f,%f,%f", &t.ms, &t.altitude,
+                                 &t.velocity, &t.acceleration) == 4) {
+      trace.push_back(t);
+    }
+  }
+  fclose(f);
+  return trace;
+}
+
+// The tick of the highest altitude
+inline TraceTick tracePeak(const std::vector<TraceTick> &trace)
+{
+  TraceTick peak = trace.front();
+  for (const TraceTick &t : trace) {
+    if (t.altitude > peak.altitude) {
+      peak = t;
+    }
+  }
+  return peak;
+}
+
+#endif
@@ -0,0 +1,180 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// A vertical flight and the sensors that watch it, for replaying the flight
+// pipeline on the host.  Everything is in SI units and seconds, and
+// acceleration excludes gravity unless it says otherwise.
+
+#ifndef flight_sim_h
+#define flight_sim_h
+
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+#define kSimGravity 9.81
+#define kSimSpeedOfSound 340.0
+
+// The flights come from a generator of our own rather than <random>, whose
+// distributions differ between standard libraries
+class FlightNoise
+{
+ public:
+  explicit FlightNoise(uint32_t seed) : state(seed * 2654435761u + 1) {}
+
+  double uniform(double lo, double hi)
+  {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return lo + (hi - lo) * (state / 4294967296.0);
+  }
+
+  double gaussian(double sd)
+  {
+    double u = uniform(1e-12, 1);
+    double v = uniform(0, 1);
+    return sd * sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+  }
+
+ private:
+  uint32_t state;
+};
+
+// The rocket.  The motor lights at |ignition| and the drag coefficient
+// changes as the chutes come out.
+struct SimRocket {
+  double thrust   = 0;    // m/s/s while the motor burns
+  double burnTime = 0;    // s
+  double ignition = 1.0;  // s
+  double drag     = 0.0001;  // Of the body, per m of v^2
+
+  double time         = 0;
+  double altitude     = 0;
+  double velocity     = 0;
+  double acceleration = 0;
+
+  // Drag coefficient that gives |rate| m/s under the chute
+  static double dragForRate(double rate)
+  {
+    return kSimGravity / (rate * rate);
+  }
+
+  void step(double dt)
+  {
+    bool burning = time >= ignition && time < ignition + burnTime;
+    if (time < ignition) {
+      acceleration = 0;
+    } else {
+      acceleration = (burning ? thrust : 0) - kSimGravity -
+                     drag * velocity * fabs(velocity);
+    }
+    velocity += acceleration * dt;
+    altitude += velocity * dt;
+    if (altitude < 0) {
+      altitude = velocity = acceleration = 0;
+    }
+    time += dt;
+  }
+
+  double mach() const { return fabs(velocity) / kSimSpeedOfSound; }
+};
+
+// A pressure glitch: |size| m on the altitude from |start| for |length| s
+struct SimGlitch {
+  double start, length, size;
+};
+
+// Samples the altitude at |period| through a one pole lag with noise, like
+// the BMP280's IIR filter.  |filter| is the weight of each new sample.  From
+// Mach 0.8 to 1.2 the altitude reads up to |machDip| m low.
+class SimBarometer
+{
+ public:
+  double period  = 0.014;
+  double noise   = 0.11;
+  double filter  = 0.5;
+  double machDip = 0;
+  std::vector<SimGlitch> glitches;
+
+  // Returns true with a new |altitude| if a sample is due
+  bool sample(const SimRocket &r, FlightNoise &n, double *altitude)
+  {
+    if (r.time < next) {
+      return false;
+    }
+    if (!sampled) {
+      lagged  = r.altitude;
+      sampled = true;
+    }
+    next = r.time + period;
+    lagged += (r.altitude - lagged) * filter;
+    double reading = lagged + n.gaussian(noise);
+    double w       = 1 - fabs(r.mach() - 1) / 0.2;
+    if (w > 0) {
+      reading -= machDip * w;  // Strongest at Mach 1
+    }
+    for (const SimGlitch &g : glitches) {
+      if (r.time >= g.start && r.time < g.start + g.length) {
+        reading += g.size;
+      }
+    }
+    *altitude = reading;
+    return true;
+  }
+
+  // True while any glitch is on the readings
+  bool glitching(double time) const
+  {
+    for (const SimGlitch &g : glitches) {
+      if (time >= g.start && time < g.start + g.length) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  double next   = 0;
+  double lagged = 0;
+  bool sampled  = false;
+};
+
+// The vertical acceleration the IMU reports, gravity removed, with a scale
+// error and a bias
+struct SimImu {
+  double scale = 0;
+  double bias  = 0;
+  double noise = 0.3;
+
+  double read(const SimRocket &r, FlightNoise &n) const
+  {
+    double specificForce = r.acceleration + kSimGravity;
+    return specificForce * (1 + scale) - kSimGravity + bias + n.gaussian(noise);
+  }
+};
+
+#endif
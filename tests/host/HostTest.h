@@ -0,0 +1,76 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Minimal checks for the host tests.  A failed check prints where and keeps
+// going, and hostTestResult() turns the count into the exit status.
+
+#ifndef host_test_h
+#define host_test_h
+
+#include <stdio.h>
+
+static int hostTestChecks   = 0;
+static int hostTestFailures = 0;
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    hostTestChecks++;                                                \
+    if (!(cond)) {                                                   \
+      hostTestFailures++;                                            \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    }                                                                \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                 \
+  do {                                                                 \
+    hostTestChecks++;                                                  \
+    double va = (a), vb = (b);                                         \
+    if (va != vb) {                                                    \
+      hostTestFailures++;                                              \
+      printf("%s:%d: %s == %s failed (%g vs %g)\n", __FILE__, __LINE__, \
+             #a, #b, va, vb);                                          \
+    }                                                                  \
+  } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                           \
+  do {                                                                  \
+    hostTestChecks++;                                                   \
+    double va = (a), vb = (b);                                          \
+    if (fabs(va - vb) > (tol)) {                                        \
+      hostTestFailures++;                                               \
+      printf("%s:%d: %s ~= %s failed (%g vs %g, tolerance %g)\n",       \
+             __FILE__, __LINE__, #a, #b, va, vb, (double)(tol));        \
+    }                                                                   \
+  } while (0)
+
+inline int hostTestResult(const char *name)
+{
+  printf("%s: %d checks, %d failed\n", name, hostTestChecks,
+         hostTestFailures);
+  return hostTestFailures ? 1 : 0;
+}
+
+#endif
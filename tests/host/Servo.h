@@ -24,71 +24,49 @@
  * SOFTWARE.
  **********************************************************************************/
 
-#ifndef blinksequence_h
-#define blinksequence_h
+// A Servo that records every write with the micros() it happened at, so the
+// tests can see what went out to the servos and when.
 
-#include "types.h"
+#ifndef host_servo_h
+#define host_servo_h
 
-#ifdef IS_SIMPLE_ALT
-#include "SimpleTimer.h"
-#include "types.h"
-#else
-#include <Ticker.h>
-#include "../types.h"
-class TimerDelegate
-{
-};
-#endif
+#include <vector>
+#include "Arduino.h"
+
+typedef struct {
+  uint8_t pin;
+  int angle;
+  unsigned long micros;
+} HostServoWrite;
 
-// 128 bits will represent 64 on-off events.
-// the number 1000 would require ~34 so this should
-// be sufficient.
-#define kBitMapLen 16
+// Every write to every Servo, oldest first
+inline std::vector<HostServoWrite> &hostServoWrites()
+{
+  static std::vector<HostServoWrite> writes;
+  return writes;
+}
 
-class Blinker : public TimerDelegate
+class Servo
 {
  public:
-#ifdef IS_SIMPLE_ALT
-  Blinker(SimpleTimer &timer, byte ledPin, byte piezoPin)
-      : timer(timer), ledPin(ledPin), piezoPin(piezoPin)
+  uint8_t attach(int pin)
   {
+    this->pin = pin;
+    return 0;
   }
-#else
-  Blinker(int ledPin, int piezoPin) : ledPin(ledPin), piezoPin(piezoPin) {}
-#endif
-
-  ~Blinker() { cancelSequence(); };
-
-  void blinkValue(long value, int speed, bool repeat);
-  void cancelSequence();
-  bool isBlinking();
+  void detach() { pin = -1; }
+  bool attached() { return pin >= 0; }
 
-#ifdef IS_SIMPLE_ALT
-  void timerFired(int timerNumber) override;
-#else
-  void timerFired(int timerNumber);
-#endif
+  void write(int value)
+  {
+    angle = value;
+    hostServoWrites().push_back({(uint8_t)pin, value, micros()});
+  }
+  int read() { return angle; }
 
  private:
-  byte timerNumber = 0;
-  byte bitMap[kBitMapLen];
-
-  void setHardwareState(BlinkerState hwState);
-
-  int ledPin   = NO_PIN;
-  int piezoPin = NO_PIN;
-
-  byte sequenceLen = 0;
-  byte position    = 0;
-  bool repeat      = 0;
-  int speed        = 0;
-
-#ifdef IS_SIMPLE_ALT
-  SimpleTimer &timer;
-#else
-  Ticker ticker;
-#endif
-  bool isRunning;
+  int pin   = -1;
+  int angle = 90;
 };
 
 #endif
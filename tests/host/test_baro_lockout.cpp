@@ -0,0 +1,226 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Replays simulated flights through BaroLockout and the descent check, as
+// FlightController::flightControl() runs them, with pressure spikes injected
+// into the barometer.  A false deploy is a descent detected while the
+// rocket is still climbing.  A relock is a lockout straight after a release
+// with no glitch on the barometer in between, which is what happens if the
+// release is forced while the barometer can't be trusted or leaves the
+// velocity where the IMU had drifted to.
+//
+// The barometer runs at 72Hz with noise and lag.  The accelerometer has up
+// to 1% scale error and 0.2 m/s/s of bias.  The cases are:
+//   subsonic, clean      no spikes
+//   subsonic, glitches   20-200m jumps lasting 30-300ms
+//   transonic, spikes    a Mach dip of 30-100m as well as the jumps
+//   supersonic, spikes   the same, going through Mach 1 and back
+
+#include "Arduino.h"
+#include "FlightSim.h"
+#include "HostTest.h"
+#include <AltimeterCore.h>
+#include "Sensor/BaroLockout.hpp"
+
+#define kFlights 500
+#define kTickMs 10
+#define kMaxFlightMs 90000
+#define kRelockMs 100
+
+// As FlightController.cpp builds it from Configuration.h
+static const BaroLockoutConfig kBaroLockoutConfig = {200, 150,   15,  10,
+                                                     500, 10000, 5,   0.1,
+                                                     0.5};
+static const real_t kDescentThreshold = 15;
+
+typedef struct {
+  const char *name;
+  double minThrust, maxThrust;  // m/s/s
+  double minBurn, maxBurn;      // s
+  double minDip, maxDip;        // m
+  int glitches;
+} LockoutCase;
+
+typedef struct {
+  double maxApogeeDelay;  // s
+  double maxReleaseLag;   // s, 95th percentile
+  double maxReleaseStep;  // m, median
+} LockoutBounds;
+
+static const LockoutCase kCases[] = {
+    {"subsonic, clean", 60, 90, 1.5, 2.0, 0, 0, 0},
+    {"subsonic, glitches", 60, 90, 1.5, 2.0, 0, 0, 4},
+    {"transonic, spikes", 150, 180, 2.0, 2.4, 30, 100, 4},
+    {"supersonic, spikes", 220, 280, 2.2, 2.8, 30, 100, 4},
+};
+
+// The descent check trails the apogee by the 15m it needs to see, which
+// takes ~1.75s.  The release steps are what the IMU drifts through the
+// lockout.
+static const LockoutBounds kBounds[] = {
+    {2.0, 0, 1},
+    {2.0, 0.5, 1},
+    {2.0, 0.5, 50},
+    {2.0, 0.5, 150},
+};
+
+typedef struct {
+  bool falseDeploy;
+  double apogeeDelay;    // s from the true apogee to the descent
+  int lockouts;
+  int relocks;           // Clean lockouts within kRelockMs of a release
+  double releaseLag;     // s from dropping below releaseVelocity to release
+  double releaseError;   // m, the largest step at a release
+  double peakMach;
+} LockoutResult;
+
+static LockoutResult fly(const LockoutCase &c, int flight)
+{
+  FlightNoise noise(flight * 7919 + (int)c.minThrust);
+  SimRocket rocket;
+  rocket.thrust   = noise.uniform(c.minThrust, c.maxThrust);
+  rocket.burnTime = noise.uniform(c.minBurn, c.maxBurn);
+  SimBarometer baro;
+  baro.machDip = noise.uniform(c.minDip, c.maxDip);
+  for (int i = 0; i < c.glitches; i++) {
+    double size = noise.uniform(20, 200) * (noise.uniform(0, 1) < 0.5 ? -1 : 1);
+    baro.glitches.push_back(
+        {noise.uniform(1.5, 20), noise.uniform(0.03, 0.3), size});
+  }
+  SimImu imu;
+  imu.scale = noise.uniform(-0.01, 0.01);
+  imu.bias  = noise.uniform(-0.2, 0.2);
+
+  BaroLockout lockout(kBaroLockoutConfig);
+  LockoutResult r = {false, 0, 0, 0, 0, 0, 0};
+  real_t apogee        = 0;
+  double trueApogee    = -1;
+  double releasedAt    = -1;
+  bool cleanRelease    = false;
+  double lockoutStart  = 0;
+  double slowSince     = -1;
+  double baroAltitude  = 0;
+
+  for (long ms = 0; ms < kMaxFlightMs; ms += kTickMs) {
+    rocket.step(kTickMs / 1000.0);
+    r.peakMach = max(r.peakMach, rocket.mach());
+    if (trueApogee < 0 && rocket.time > rocket.ignition + rocket.burnTime &&
+        rocket.velocity <= 0) {
+      trueApogee = rocket.time;
+    }
+
+    bool newBaro      = baro.sample(rocket, noise, &baroAltitude);
+    bool wasLockedOut = lockout.isLockedOut();
+    cleanRelease      = cleanRelease && !baro.glitching(rocket.time);
+    lockout.update(ms, toReal(imu.read(rocket, noise)), toReal(baroAltitude),
+                   newBaro);
+    if (lockout.isLockedOut() && !wasLockedOut) {
+      r.lockouts++;
+      if (releasedAt >= 0 && rocket.time - releasedAt <= kRelockMs / 1000.0 &&
+          cleanRelease) {
+        r.relocks++;
+      }
+      lockoutStart = rocket.time;
+      slowSince    = -1;
+    } else if (wasLockedOut && !lockout.isLockedOut()) {
+      real_t step = lockout.takeRebase();
+      apogee += step;
+      r.releaseError = max(r.releaseError, (double)fabs(toFloat(step)));
+      releasedAt   = rocket.time;
+      cleanRelease = !baro.glitching(rocket.time);
+      if (slowSince >= 0) {
+        r.releaseLag = max(r.releaseLag, rocket.time - slowSince);
+      }
+    }
+    // The lag runs from when the lockout could first have been released,
+    // and starts again if the rocket speeds back up
+    bool slow = fabs(rocket.velocity) < toFloat(kBaroLockoutConfig.releaseVelocity);
+    if (!lockout.isLockedOut() || !slow) {
+      slowSince = -1;
+    } else if (slowSince < 0 && rocket.time - lockoutStart >=
+                                    kBaroLockoutConfig.minLockoutMs / 1000.0) {
+      slowSince = rocket.time;
+    }
+
+    if (rocket.time < rocket.ignition) {
+      continue;
+    }
+    real_t altitude = lockout.altitude();
+    apogee          = altitude > apogee ? altitude : apogee;
+    if (altitude < apogee - kDescentThreshold) {
+      r.falseDeploy = rocket.velocity > 0;
+      r.apogeeDelay = trueApogee < 0 ? 0 : rocket.time - trueApogee;
+      break;
+    }
+  }
+  return r;
+}
+
+static double percentile(std::vector<double> v, int p)
+{
+  if (v.empty()) {
+    return 0;
+  }
+  std::sort(v.begin(), v.end());
+  return v[(v.size() - 1) * p / 100];
+}
+
+int main()
+{
+  for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); i++) {
+    const LockoutCase &c     = kCases[i];
+    const LockoutBounds &b   = kBounds[i];
+    int falseDeploys = 0, relocks = 0, lockouts = 0;
+    double maxMach = 0, minMach = 10, maxDelay = 0;
+    std::vector<double> lags, steps;
+    for (int flight = 0; flight < kFlights; flight++) {
+      LockoutResult r = fly(c, flight);
+      falseDeploys += r.falseDeploy;
+      relocks += r.relocks;
+      lockouts += r.lockouts;
+      maxMach  = max(maxMach, r.peakMach);
+      minMach  = min(minMach, r.peakMach);
+      maxDelay = max(maxDelay, r.apogeeDelay);
+      if (r.lockouts) {
+        lags.push_back(r.releaseLag);
+        steps.push_back(r.releaseError);
+      }
+    }
+    double lag  = percentile(lags, 95);
+    double step = percentile(steps, 50);
+    printf("%-20s Mach %.2f-%.2f  false deploys %d  lockouts %d  relocks %d"
+           "  descent +%.2fs  release lag %.2fs  step %.1fm\n",
+           c.name, minMach, maxMach, falseDeploys, lockouts, relocks,
+           maxDelay, lag, step);
+
+    CHECK_EQ(falseDeploys, 0);
+    CHECK_EQ(relocks, 0);
+    CHECK(maxDelay <= b.maxApogeeDelay);
+    CHECK(lag <= b.maxReleaseLag);
+    CHECK(step <= b.maxReleaseStep);
+  }
+  return hostTestResult("test_baro_lockout");
+}
@@ -0,0 +1,193 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Replays traces through ComplexAltimeter's flight state table.  Every
+// transition is taken, in order, stamped before its action runs, and only
+// the guards of the current state are asked.  The guards follow
+// FlightController's.
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "FlightReplay.h"
+#include <AltimeterCore.h>
+#include "FlightState.hpp"
+#include "LaunchDetector.hpp"
+
+// As FlightController.cpp builds them from Configuration.h
+static const LaunchConfig kLaunchConfig = {12, 10, 10, 20.0, 8.0, 10, 13.0};
+static const real_t kDescentThreshold  = 15;
+static const real_t kFlightEndAltitude = 30;
+
+static const char *const kStateNames[] = {"Ready", "In Flight", "Ascending",
+                                          "Descending", "On Ground"};
+
+struct Replay {
+  FlightState state = kReadyToFly;
+  TraceTick tick;
+  real_t apogee = 0;
+  LaunchDetector detector;
+  LaunchTrigger trigger = kLaunchNone;
+
+  std::string journal;  // Stamps and actions in the order they happened
+  int stamps        = 0;
+  long entered[5]   = {-1, -1, -1, -1, -1};  // By state, in trace ms
+  int guardCalls[3] = {0, 0, 0};
+
+  Replay() : detector(kLaunchConfig) {}
+};
+
+struct Handlers {
+  static bool isLaunched(Replay &r)
+  {
+    CHECK_EQ(r.state, kReadyToFly);
+    r.guardCalls[0]++;
+    return r.detector.update(r.tick.ms, toReal(r.tick.acceleration),
+                             toReal(r.tick.velocity),
+                             toReal(r.tick.altitude));
+  }
+
+  static void onLaunch(Replay &r)
+  {
+    r.journal += "launch;";
+    r.trigger = r.detector.getTrigger();
+  }
+
+  static bool isPastApogee(Replay &r)
+  {
+    CHECK_EQ(r.state, kAscending);
+    r.guardCalls[1]++;
+    return toReal(r.tick.altitude) < r.apogee - kDescentThreshold;
+  }
+
+  static void onApogee(Replay &r) { r.journal += "apogee;"; }
+
+  static bool isLanded(Replay &r)
+  {
+    CHECK_EQ(r.state, kDescending);
+    r.guardCalls[2]++;
+    return toReal(r.tick.altitude) < kFlightEndAltitude;
+  }
+
+  static void onLanding(Replay &r) { r.journal += "landing;"; }
+};
+
+typedef FlightPhases<FlightState, Replay, Handlers> Phases;
+static_assert(transitionsSorted(Phases::kFlightTransitions),
+              "Flight transitions must be sorted by the state they leave");
+
+static void stamp(Replay &r, FlightState from, FlightState to)
+{
+  r.journal += std::string(kStateNames[from]) + ">" + kStateNames[to] + ";";
+  r.stamps++;
+  r.entered[to] = r.tick.ms;
+}
+
+static constexpr FlightStateMachine<FlightState, Replay> kMachine(
+    Phases::kFlightTransitions, stamp);
+
+// Steps the table once per tick, tracking the apogee first as
+// FlightController::flightControl() does
+static void replay(Replay &r, const std::vector<TraceTick> &trace)
+{
+  for (const TraceTick &t : trace) {
+    r.tick   = t;
+    r.apogee = max(r.apogee, toReal(t.altitude));
+    int stamps = r.stamps;
+    bool moved = kMachine.step(r.state, r);
+    CHECK_EQ(r.stamps - stamps, moved ? 1 : 0);
+  }
+}
+
+static const char *const kFlightJournal =
+    "Ready>Ascending;launch;"
+    "Ascending>Descending;apogee;"
+    "Descending>On Ground;landing;";
+
+static void testArming()
+{
+  Replay r;
+  r.state = kOnGround;
+  kMachine.enter(r.state, kReadyToFly, r);
+  CHECK_EQ(r.state, kReadyToFly);
+  CHECK(r.journal == "On Ground>Ready;");
+  // Arming again isn't a transition
+  kMachine.enter(r.state, kReadyToFly, r);
+  CHECK_EQ(r.stamps, 1);
+}
+
+static void testFlight(const char *name, LaunchTrigger trigger)
+{
+  std::vector<TraceTick> trace = loadTrace(name);
+  CHECK(!trace.empty());
+  if (trace.empty()) {
+    return;
+  }
+  Replay r;
+  replay(r, trace);
+
+  if (r.journal != kFlightJournal) {
+    printf("%s: %s\n", name, r.journal.c_str());
+  }
+  CHECK(r.journal == kFlightJournal);
+  CHECK_EQ(r.state, kOnGround);
+  CHECK_EQ(r.trigger, trigger);
+
+  // Launch is confirmed within a second of the motor lighting at 3s
+  CHECK(r.entered[kAscending] >= 3000 && r.entered[kAscending] < 4000);
+  // Descent is after the peak, landing is once we're below 30m
+  TraceTick peak = tracePeak(trace);
+  CHECK(r.entered[kDescending] > peak.ms);
+  CHECK(r.entered[kOnGround] > r.entered[kDescending]);
+  for (const TraceTick &t : trace) {
+    if (t.ms == r.entered[kOnGround]) {
+      CHECK(t.altitude < kFlightEndAltitude);
+    }
+  }
+  CHECK(r.guardCalls[0] > 0 && r.guardCalls[1] > 0 && r.guardCalls[2] > 0);
+}
+
+static void testPadKnock()
+{
+  std::vector<TraceTick> trace = loadTrace("pad_knock.csv");
+  CHECK(!trace.empty());
+  Replay r;
+  replay(r, trace);
+  CHECK_EQ(r.state, kReadyToFly);
+  CHECK_EQ(r.stamps, 0);
+  CHECK_EQ(r.guardCalls[0], trace.size());
+  CHECK_EQ(r.guardCalls[1] + r.guardCalls[2], 0);
+}
+
+int main()
+{
+  testArming();
+  testFlight("flight.csv", kLaunchAcc);
+  // The velocity votes are in on the tick the altitude passes 10m, and the
+  // velocity goes first
+  testFlight("flight_no_imu.csv", kLaunchVelocity);
+  testPadKnock();
+  return hostTestResult("test_complex_phases");
+}
@@ -0,0 +1,193 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Replays descents through BaroLockout and DeploymentPlanner the way
+// FlightController::flightControl() runs them, and measures how far the
+// chute is from the target altitude when it's actually out.  The barometer
+// is on the descent profile: 43Hz through the BMP280's x4 IIR filter, which
+// trails the truth by ~80ms.
+//
+// The cases are a drogue descent with pyro and with servo releases, a slow
+// descent below minDescentRate, where it falls back to firing at the target,
+// and a ballistic one where the lead is capped at maxLead.
+
+#include "Arduino.h"
+#include "FlightSim.h"
+#include "HostTest.h"
+#include <AltimeterCore.h>
+#include "DeploymentPlanner.hpp"
+#include "Sensor/BaroLockout.hpp"
+
+#define kFlights 200
+#define kTickMs 10
+#define kBaroLagMs 80  // Altimeter::lag() on the descent profile
+
+// As FlightController.cpp builds them from Configuration.h
+static const BaroLockoutConfig kBaroLockoutConfig = {200, 150,   15,  10,
+                                                     500, 10000, 5,   0.1,
+                                                     0.5};
+static const DeploymentPlanConfig kPlanConfig = {150, 400, 3, 30, 100};
+
+typedef struct {
+  const char *name;
+  RecoveryDeviceType type;
+  double minRate, maxRate;  // m/s
+} PlanCase;
+
+typedef struct {
+  double error;       // m, where the chute was out less the target
+  double naiveError;  // m, firing when the estimate reaches the target
+  double firedAbove;  // m, the estimate above the target when it fired
+} PlanResult;
+
+typedef struct {
+  double worstError, worstNaiveError;  // m, furthest either way
+  double minFiredAbove, maxFiredAbove;
+} PlanStats;
+
+static PlanResult descend(const PlanCase &c, int flight)
+{
+  FlightNoise noise(flight * 7919 + (int)(c.minRate * 10) + c.type);
+  double rate   = noise.uniform(c.minRate, c.maxRate);
+  double target = noise.uniform(100, 300);
+
+  SimRocket rocket;
+  rocket.drag     = SimRocket::dragForRate(rate);
+  rocket.ignition = 0;
+  rocket.altitude = target + 40 * rate;  // From apogee, at rest
+  SimBarometer baro;
+  baro.period = 0.023;
+  baro.filter = 0.25;
+  SimImu imu;
+  imu.scale = noise.uniform(-0.01, 0.01);
+  imu.bias  = noise.uniform(-0.2, 0.2);
+
+  DeploymentPlanner planner(kPlanConfig);
+  BaroLockout lockout(kBaroLockoutConfig);
+  lockout.reset(toReal(rocket.altitude));
+  long actuation = planner.actuationMs(c.type);
+
+  PlanResult r        = {0, 0, 0};
+  double baroAltitude = 0;
+  long fireAt = -1, naiveAt = -1;
+  for (long ms = 0; rocket.altitude > 0; ms += kTickMs) {
+    rocket.step(kTickMs / 1000.0);
+    bool newBaro = baro.sample(rocket, noise, &baroAltitude);
+    lockout.update(ms, toReal(imu.read(rocket, noise)), toReal(baroAltitude),
+                   newBaro);
+    real_t altitude = lockout.altitude();
+
+    if (ms == fireAt + actuation) {
+      r.error = rocket.altitude - target;
+    }
+    if (ms == naiveAt + actuation) {
+      r.naiveError = rocket.altitude - target;
+    }
+    if (fireAt >= 0 && naiveAt >= 0 && ms > fireAt + actuation &&
+        ms > naiveAt + actuation) {
+      break;
+    }
+
+    if (naiveAt < 0 && altitude < target) {
+      naiveAt = ms;
+    }
+    if (fireAt < 0) {
+      long wait = planner.plan(c.type, target, altitude, lockout.velocity(),
+                               kBaroLagMs);
+      if (wait != kPlanNotYet) {
+        // The scheduler fires on the ms.  Here it fires at the next tick,
+        // which is close enough at these rates.
+        fireAt = ms + (wait + kTickMs - 1) / kTickMs * kTickMs;
+      }
+    }
+    if (ms == fireAt) {
+      r.firedAbove = toFloat(altitude) - target;
+    }
+  }
+  return r;
+}
+
+static PlanStats runCase(const PlanCase &c)
+{
+  PlanStats s = {0, 0, 1e9, -1e9};
+  for (int flight = 0; flight < kFlights; flight++) {
+    PlanResult r = descend(c, flight);
+    if (fabs(r.error) > fabs(s.worstError)) {
+      s.worstError = r.error;
+    }
+    if (fabs(r.naiveError) > fabs(s.worstNaiveError)) {
+      s.worstNaiveError = r.naiveError;
+    }
+    s.minFiredAbove = min(s.minFiredAbove, r.firedAbove);
+    s.maxFiredAbove = max(s.maxFiredAbove, r.firedAbove);
+  }
+  printf("%-18s chute out %+6.2fm worst (%+6.2fm firing at the target)  "
+         "fired %+.1f to %+.1fm from it\n",
+         c.name, s.worstError, s.worstNaiveError, s.minFiredAbove,
+         s.maxFiredAbove);
+  return s;
+}
+
+int main()
+{
+  // Under a drogue the chute is out within a couple of metres of the
+  // target, where firing at it would be 9m low for a pyro and 17m for a
+  // servo
+  static const PlanCase kPyroDrogue  = {"drogue, pyro", kPyro, 15, 35};
+  static const PlanCase kServoDrogue = {"drogue, servo", kServo, 15, 35};
+  PlanStats s = runCase(kPyroDrogue);
+  CHECK(fabs(s.worstError) <= 2);
+  CHECK(s.worstNaiveError < -5);
+  s = runCase(kServoDrogue);
+  CHECK(fabs(s.worstError) <= 2);
+  CHECK(s.worstNaiveError < -10);
+
+  // Below minDescentRate it fires as the estimate crosses the target, and
+  // at that rate the lag and actuation hardly matter
+  static const PlanCase kSlow = {"slow, servo", kServo, 0.5, 1.5};
+  s = runCase(kSlow);
+  CHECK(s.minFiredAbove > -0.5 && s.maxFiredAbove < 0.5);
+  CHECK(fabs(s.worstError) <= 1.5);
+
+  // Falling ballistic the lead would be 40-70m.  It's held to maxLead, so
+  // it fires as the estimate passes maxLead above the target and the chute
+  // is out low, but not as low as firing at the target.
+  static const PlanCase kBallistic = {"ballistic, servo", kServo, 80, 150};
+  s = runCase(kBallistic);
+  CHECK(s.minFiredAbove >= toFloat(kPlanConfig.maxLead) - 3);
+  CHECK(s.maxFiredAbove <= toFloat(kPlanConfig.maxLead) + 3);
+  CHECK(s.worstError < 0 && s.worstError > s.worstNaiveError);
+
+  // And straight off the config
+  DeploymentPlanner planner(kPlanConfig);
+  CHECK_EQ(planner.plan(kServo, 100, 200, -150, 80), kPlanNotYet);
+  CHECK_NEAR(planner.plan(kServo, 100, 140, -150, 80), 67, 1);
+  CHECK_EQ(planner.plan(kPyro, 100, 110, -20, 80), kPlanNotYet);
+  CHECK_NEAR(planner.plan(kPyro, 100, 106, -20, 80), 70, 1);
+  CHECK_EQ(planner.plan(kPyro, 100, 101, -2, 80), kPlanNotYet);
+  CHECK_EQ(planner.plan(kPyro, 100, 99, -2, 80), 0);
+  return hostTestResult("test_deployment_planner");
+}
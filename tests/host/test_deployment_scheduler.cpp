@@ -0,0 +1,334 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// DeploymentScheduler against a virtual clock and timer0.  The compare
+// interrupt runs kIsrLatencyUs after it matches.  The pins switch on time
+// however late the main loop is, the events carry when they actually
+// switched, and cancel() reports what the timer has already done.
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include <RecoveryDevice.h>
+#include "DeploymentScheduler.hpp"
+#include "EventLog.hpp"
+
+#define kIsrLatencyUs 2
+#define kTickMs 10
+#define kCutAfterMs 1000
+#define kPyroPin 5
+#define kBackupPin 16
+
+typedef RecoveryChannel<OutputPin<kPyroPin>> PyroChannel;
+typedef RecoveryChannel<OutputPin<kBackupPin>> BackupChannel;
+typedef RecoveryChannel<ServoOutput<4>> ServoChannel;
+
+typedef struct {
+  uint8_t pin;
+  bool high;
+  unsigned long micros;
+} PinEdge;
+
+static std::vector<PinEdge> edges;
+
+static bool pinState(uint8_t pin)
+{
+  return pin == 16 ? hostGpio16 & 1 : hostGpio & (1 << pin);
+}
+
+// Runs the clock on by |us|, taking the timer0 interrupt when it's due
+static void runFor(unsigned long us)
+{
+  unsigned long end = hostMicros + us;
+  for (;;) {
+    if (hostTimer0Armed) {
+      int32_t cycles = (int32_t)(hostTimer0Compare - ESP.getCycleCount());
+      unsigned long isrAt =
+          hostMicros + (cycles > 0 ? (cycles + 79) / 80 : 0) + kIsrLatencyUs;
+      if (isrAt <= end) {
+        hostAdvanceMicros(isrAt - hostMicros);
+        bool before[] = {pinState(kPyroPin), pinState(kBackupPin)};
+        hostTimer0Armed = false;
+        hostTimer0Isr();
+        if (pinState(kPyroPin) != before[0]) {
+          edges.push_back({kPyroPin, !before[0], hostMicros});
+        }
+        if (pinState(kBackupPin) != before[1]) {
+          edges.push_back({kBackupPin, !before[1], hostMicros});
+        }
+        continue;
+      }
+    }
+    hostAdvanceMicros(end - hostMicros);
+    return;
+  }
+}
+
+// The main loop: service() every tick, except for |stallMs| from |stallAt|
+static void runLoop(DeploymentScheduler &s, unsigned long ms,
+                    unsigned long stallAt = 0, unsigned long stallMs = 0)
+{
+  unsigned long end = hostMillis + ms;
+  while (hostMillis < end) {
+    runFor(kTickMs * 1000);
+    if (hostMillis < stallAt || hostMillis >= stallAt + stallMs) {
+      s.service(100);
+    }
+  }
+}
+
+static std::vector<FlightEvent> takeEvents()
+{
+  std::vector<FlightEvent> events;
+  FlightEvent e;
+  while (EventLog::shared().pop(&e)) {
+    events.push_back(e);
+  }
+  return events;
+}
+
+static void start(DeploymentScheduler &s)
+{
+  hostMicros = 1000000;
+  hostMillis = 1000;
+  hostGpio = hostGpio16 = 0;
+  hostTimer0Armed       = false;
+  edges.clear();
+  hostServoWrites().clear();
+  takeEvents();
+  s.begin();
+}
+
+// The edges are due + the interrupt latency, and the cut is timed from when
+// the pin actually went high
+static void testPyroEdges()
+{
+  DeploymentScheduler s(kCutAfterMs);
+  PyroChannel pyro;
+  start(s);
+  pyro.init(1);
+
+  unsigned long due = hostMicros + 300000;
+  CHECK(s.fire(&pyro, 300));
+  CHECK(s.isScheduled(&pyro));
+  CHECK(!s.fire(&pyro, 100));
+  runLoop(s, 2000);
+
+  CHECK_EQ(edges.size(), 2);
+  if (edges.size() != 2) {
+    return;
+  }
+  CHECK(edges[0].high && edges[0].micros >= due + kIsrLatencyUs &&
+        edges[0].micros <= due + kIsrLatencyUs + 1);
+  CHECK(!edges[1].high);
+  CHECK(edges[1].micros - edges[0].micros >= kCutAfterMs * 1000UL &&
+        edges[1].micros - edges[0].micros <=
+            kCutAfterMs * 1000UL + kIsrLatencyUs + 1);
+  CHECK(!s.isScheduled(&pyro));
+  CHECK(pyro.deployed);
+  CHECK(pyro.timedReset);
+  CHECK_EQ(pyro.deviceState, OFF);
+
+  std::vector<FlightEvent> events = takeEvents();
+  CHECK_EQ(events.size(), 2);
+  if (events.size() != 2) {
+    return;
+  }
+  CHECK(events[0].type == kEventDeploy && events[0].arg == 1);
+  CHECK_EQ(events[0].micros, (uint32_t)edges[0].micros);
+  CHECK(events[1].type == kEventDeployOff && events[1].arg == 1);
+  CHECK_EQ(events[1].micros, (uint32_t)edges[1].micros);
+}
+
+// A 150ms stall in the main loop over both edges moves neither.  The
+// book-keeping catches up afterwards with the times they happened.
+static void testStalledLoop()
+{
+  DeploymentScheduler s(100);
+  PyroChannel pyro;
+  start(s);
+  pyro.init(1);
+
+  unsigned long due = hostMicros + 50000;
+  CHECK(s.fire(&pyro, 50));
+  runLoop(s, 500, hostMillis + 20, 150);
+
+  CHECK_EQ(edges.size(), 2);
+  if (edges.size() != 2) {
+    return;
+  }
+  CHECK(edges[0].micros >= due + kIsrLatencyUs &&
+        edges[0].micros <= due + kIsrLatencyUs + 1);
+  CHECK(edges[1].micros - edges[0].micros <= 100000 + kIsrLatencyUs + 1);
+  CHECK_NEAR(pyro.deploymentTime, edges[0].micros / 1000.0, 1);
+
+  std::vector<FlightEvent> events = takeEvents();
+  CHECK_EQ(events.size(), 2);
+  if (events.size() != 2) {
+    return;
+  }
+  CHECK_EQ(events[0].micros, (uint32_t)edges[0].micros);
+  CHECK_EQ(events[1].micros, (uint32_t)edges[1].micros);
+}
+
+// Past kMaxWaitUs the compare is re-armed on the way, and two channels due
+// at different times each get their own edge.  GPIO16 has its own register.
+static void testLongDelays()
+{
+  DeploymentScheduler s(kCutAfterMs);
+  PyroChannel pyro;
+  BackupChannel backup;
+  start(s);
+  pyro.init(1);
+  backup.init(2);
+
+  unsigned long due = hostMicros + 25000000;
+  CHECK(s.fire(&pyro, 25000));
+  CHECK(s.fire(&backup, 25500));
+  runLoop(s, 28000);
+
+  CHECK_EQ(edges.size(), 4);
+  if (edges.size() != 4) {
+    return;
+  }
+  CHECK(edges[0].pin == kPyroPin && edges[0].high &&
+        edges[0].micros >= due + kIsrLatencyUs &&
+        edges[0].micros <= due + kIsrLatencyUs + 1);
+  CHECK(edges[1].pin == kBackupPin && edges[1].high &&
+        edges[1].micros >= due + 500000 + kIsrLatencyUs &&
+        edges[1].micros <= due + 500000 + kIsrLatencyUs + 1);
+  CHECK(edges[2].pin == kPyroPin && !edges[2].high);
+  CHECK(edges[3].pin == kBackupPin && !edges[3].high);
+  CHECK(pyro.deployed && backup.deployed);
+  CHECK_EQ(takeEvents().size(), 4);
+}
+
+// A servo is only marked due by the interrupt and moved on the next
+// service(), a stall later if the loop is stalled
+static void testServo()
+{
+  DeploymentScheduler s(kCutAfterMs);
+  ServoChannel servo;
+  start(s);
+  servo.init(3);
+  hostServoWrites().clear();
+
+  unsigned long due = hostMicros + 100000;
+  CHECK(s.fire(&servo, 100));
+  runLoop(s, 400, hostMillis + 90, 150);
+
+  CHECK(edges.empty());
+  CHECK_EQ(hostServoWrites().size(), 1);
+  if (hostServoWrites().size() != 1) {
+    return;
+  }
+  CHECK_EQ(hostServoWrites()[0].angle, RecoveryDevice::onAngle);
+  CHECK(hostServoWrites()[0].micros >= due + 140000 &&
+        hostServoWrites()[0].micros <= due + 140000 + kTickMs * 1000);
+  CHECK(servo.deployed);
+  CHECK_EQ(servo.deviceState, ON);
+
+  std::vector<FlightEvent> events = takeEvents();
+  CHECK_EQ(events.size(), 1);
+  if (events.size() != 1) {
+    return;
+  }
+  CHECK_EQ(events[0].micros, (uint32_t)hostServoWrites()[0].micros);
+}
+
+// cancel() drops what hasn't fired, cuts what's on, and reports both fires
+// and cuts the timer ran but service() hadn't seen
+static void testCancel()
+{
+  DeploymentScheduler s(kCutAfterMs);
+  PyroChannel pyro;
+  BackupChannel backup;
+  ServoChannel servo;
+  start(s);
+  pyro.init(1);
+  backup.init(2);
+  servo.init(3);
+
+  // Fired and still on
+  CHECK(s.fire(&pyro, 10));
+  runFor(20000);
+  CHECK(pinState(kPyroPin));
+  s.cancel(100);
+  CHECK(!pinState(kPyroPin));
+  CHECK(pyro.deployed);
+  CHECK_EQ(pyro.deviceState, OFF);
+  std::vector<FlightEvent> events = takeEvents();
+  CHECK_EQ(events.size(), 2);
+  if (events.size() != 2) {
+    return;
+  }
+  CHECK(events[0].type == kEventDeploy && events[1].type == kEventDeployOff);
+  CHECK_EQ(events[1].micros, (uint32_t)hostMicros);
+
+  // Fired and cut, and the servo marked due, before the loop saw either
+  CHECK(s.fire(&backup, 10));
+  CHECK(s.fire(&servo, 10));
+  runFor((kCutAfterMs + 100) * 1000UL);
+  s.cancel(100);
+  CHECK(backup.deployed);
+  CHECK(servo.deployed);
+  CHECK_EQ(takeEvents().size(), 3);
+
+  // Not due yet
+  pyro.reset();
+  edges.clear();
+  CHECK(s.fire(&pyro, 1000));
+  runFor(500000);
+  s.cancel(100);
+  runFor(1000000);
+  CHECK(edges.empty());
+  CHECK(!pyro.deployed);
+  CHECK(!s.isScheduled(&pyro));
+  CHECK(takeEvents().empty());
+}
+
+// There's one slot per channel
+static void testSlots()
+{
+  DeploymentScheduler s(kCutAfterMs);
+  PyroChannel channels[kMaxDeployments + 1];
+  start(s);
+  for (int i = 0; i <= kMaxDeployments; i++) {
+    channels[i].init(i + 1);
+    CHECK_EQ(s.fire(&channels[i], 1000), i < kMaxDeployments);
+  }
+  s.cancel(0);
+}
+
+int main()
+{
+  testPyroEdges();
+  testStalledLoop();
+  testLongDelays();
+  testServo();
+  testCancel();
+  testSlots();
+  return hostTestResult("test_deployment_scheduler");
+}
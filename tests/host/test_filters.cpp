@@ -0,0 +1,193 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Checks the filters in AltimeterCore's Filters.hpp:
+//  - the constexpr maths against <cmath>
+//  - the biquad coefficients by their response: unity at DC, -3dB at the
+//    cutoff and nothing at Nyquist
+//  - Biquad's DC gain, and that reset() leaves it settled
+//  - the Kalata gains against the tracking index they come from
+//  - MovingAverage's running sum against averaging the window every step
+
+#include "Arduino.h"
+#include "FlightSim.h"
+#include "HostTest.h"
+#include <AltimeterCore.h>
+
+#include <complex>
+
+// Evaluated at compile time, or this doesn't build
+static constexpr BiquadCoefficients kLowPass = lowPassBiquad(5, 100);
+static constexpr TrackingGains kNoiseGains =
+    alphaBetaGainsForNoise(2, 0.1, 0.014);
+
+static void testMaths()
+{
+  for (double x = -1.55; x <= 1.55; x += 0.01) {
+    CHECK_NEAR(filterSin(x), sin(x), 1e-12);
+    CHECK_NEAR(filterCos(x), cos(x), 1e-12);
+  }
+  // tan grows near pi/2 and the error with it
+  for (double x = -1.4; x <= 1.4; x += 0.01) {
+    CHECK_NEAR(filterTan(x) / tan(x), 1, 1e-11);
+  }
+  for (double x = 1e-6; x <= 1e6; x *= 1.7) {
+    CHECK_NEAR(filterSqrt(x) / sqrt(x), 1, 1e-12);
+  }
+  CHECK_EQ(filterSqrt(0), 0);
+  CHECK_EQ(filterSqrt(-1), 0);
+}
+
+// |H| at |f| for a filter stepped at |sampleRate|
+static double gainAt(const BiquadCoefficients &c, double f, double sampleRate)
+{
+  std::complex<double> z1 = std::polar(1.0, -2 * M_PI * f / sampleRate);
+  std::complex<double> z2 = z1 * z1;
+  return std::abs((c.b0 + c.b1 * z1 + c.b2 * z2) /
+                  (1.0 + c.a1 * z1 + c.a2 * z2));
+}
+
+static void testBiquadCoefficients()
+{
+  static const double kCutoffs[][2] = {
+      {5, 100}, {1, 100}, {20, 100}, {45, 100}, {10, 1000}, {0.5, 72}};
+  for (const double *f : kCutoffs) {
+    BiquadCoefficients c = lowPassBiquad(f[0], f[1]);
+    CHECK_NEAR(gainAt(c, 0, f[1]), 1, 1e-12);
+    CHECK_NEAR(gainAt(c, f[0], f[1]), M_SQRT1_2, 1e-9);
+    CHECK_NEAR(gainAt(c, f[1] / 2, f[1]), 0, 1e-9);
+    // Butterworth: no peak in the pass band
+    for (double g = 0; g < f[0]; g += f[0] / 20) {
+      CHECK(gainAt(c, g, f[1]) <= 1 + 1e-12);
+    }
+  }
+}
+
+template <typename T>
+static void testBiquad(double tolerance)
+{
+  // A unit step comes out at 1
+  Biquad<T> filter(kLowPass);
+  for (int i = 0; i < 500; i++) {
+    filter.step(1);
+  }
+  CHECK_NEAR(filter.getCurrentValue(), 1, tolerance);
+
+  // A reset is as if it had been at the value forever, so there's no
+  // transient
+  double worst = 0;
+  filter.reset(T(101.325));
+  for (int i = 0; i < 100; i++) {
+    worst = max(worst, fabs(filter.step(T(101.325)) - 101.325));
+  }
+  CHECK(worst <= 101.325 * tolerance);
+
+  // And it's linear
+  filter.reset(0);
+  Biquad<T> scaled(kLowPass);
+  FlightNoise noise(1);
+  for (int i = 0; i < 200; i++) {
+    T x = T(noise.gaussian(1));
+    CHECK_NEAR(scaled.step(3 * x), 3 * filter.step(x), 3 * tolerance);
+  }
+}
+
+static void testAlphaBetaGainsForNoise()
+{
+  static const double kNoise[][3] = {
+      {2, 0.1, 0.014}, {50, 0.1, 0.014}, {0.1, 1, 0.1}, {10, 0.05, 0.01}};
+  for (const double *n : kNoise) {
+    TrackingGains g = alphaBetaGainsForNoise(n[0], n[1], n[2]);
+    // The tracking index the gains were solved for
+    double lambda = n[0] * n[2] * n[2] / n[1];
+    CHECK(g.alpha > 0 && g.alpha < 1);
+    CHECK(g.beta > 0 && g.beta < 2);
+    CHECK_EQ(g.gamma, 0);
+    CHECK_NEAR(g.beta * g.beta / (1 - g.alpha), lambda * lambda,
+               1e-9 * lambda * lambda);
+    CHECK_NEAR(g.beta, 2 * (2 - g.alpha) - 4 * sqrt(1 - g.alpha), 1e-12);
+  }
+  CHECK(kNoiseGains.alpha > 0 && kNoiseGains.alpha < 1);
+
+  // A filter with them follows a ramp with no lag once it's settled
+  AlphaBetaFilter<double> filter(kNoiseGains);
+  for (int i = 1; i <= 1000; i++) {
+    filter.step(i * 0.014 * 20, 0.014);
+  }
+  CHECK_NEAR(filter.getCurrentValue(), 1000 * 0.014 * 20, 1e-6);
+  CHECK_NEAR(filter.getRate(), 20, 1e-6);
+}
+
+// Averaging the whole window every step, which is what MovingAverage saves
+template <int N>
+struct NaiveAverage {
+  double values[N] = {};
+  int index        = 0;
+
+  double step(double value)
+  {
+    values[index] = value;
+    index         = (index + 1) % N;
+    double sum    = 0;
+    for (double v : values) {
+      sum += v;
+    }
+    return sum / N;
+  }
+};
+
+template <typename T>
+static void testMovingAverage(long steps, double tolerance)
+{
+  MovingAverage<T, 16> average;
+  NaiveAverage<16> naive;
+  FlightNoise noise(2);
+  double worst = 0;
+  for (long i = 0; i < steps; i++) {
+    double x = 100 + noise.gaussian(5);
+    double a = average.step(T(x));
+    worst    = max(worst, fabs(a - naive.step(x)));
+  }
+  CHECK(worst <= tolerance);
+
+  average.reset(T(7));
+  CHECK_EQ(average.getCurrentValue(), 7);
+  CHECK_EQ(average.step(T(7)), 7);
+}
+
+int main()
+{
+  testMaths();
+  testBiquadCoefficients();
+  testBiquad<double>(1e-12);
+  testBiquad<float>(1e-5);
+  testAlphaBetaGainsForNoise();
+  // A day at 100Hz of 100 +-5.  The float sum drifts by a few parts in
+  // 10^5 of the signal.
+  testMovingAverage<double>(8640000, 1e-8);
+  testMovingAverage<float>(8640000, 100 * 1e-4);
+  return hostTestResult("test_filters");
+}
@@ -0,0 +1,111 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// parseByteRange edge cases.  Anything the parser doesn't understand must
+// fall back to sending the whole file, and a range that can't be met must be
+// a 416 rather than a bad read off the end.
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HttpRange.hpp"
+
+struct RangeCase {
+  const char *header;
+  size_t size;
+  RangeResult result;
+  size_t first;
+  size_t last;
+};
+
+static const RangeCase kCases[] = {
+    // Plain ranges
+    {"bytes=0-99", 1000, kRangeSatisfiable, 0, 99},
+    {"bytes=500-", 1000, kRangeSatisfiable, 500, 999},
+    {"bytes=999-999", 1000, kRangeSatisfiable, 999, 999},
+    {"bytes=-100", 1000, kRangeSatisfiable, 900, 999},
+
+    // Last past the end is clamped
+    {"bytes=900-5000", 1000, kRangeSatisfiable, 900, 999},
+
+    // Suffix longer than the file is the whole file
+    {"bytes=-5000", 1000, kRangeSatisfiable, 0, 999},
+    {"bytes=-1000", 1000, kRangeSatisfiable, 0, 999},
+
+    // Start at or past the end
+    {"bytes=1000-", 1000, kRangeUnsatisfiable, 0, 0},
+    {"bytes=1000-2000", 1000, kRangeUnsatisfiable, 0, 0},
+
+    // Empty file, and an empty suffix
+    {"bytes=0-", 0, kRangeUnsatisfiable, 0, 0},
+    {"bytes=-10", 0, kRangeUnsatisfiable, 0, 0},
+    {"bytes=-0", 1000, kRangeUnsatisfiable, 0, 0},
+
+    // Reversed is invalid, so ignored
+    {"bytes=500-100", 1000, kRangeNone, 0, 0},
+
+    // Multiple ranges aren't supported, which the spec allows
+    {"bytes=0-1,5-6", 1000, kRangeNone, 0, 0},
+    {"bytes=0-1, 5-6", 1000, kRangeNone, 0, 0},
+
+    // Numbers too big for size_t
+    {"bytes=0-99999999999999999999999999999", 1000, kRangeNone, 0, 0},
+    {"bytes=99999999999999999999999999999-", 1000, kRangeNone, 0, 0},
+    {"bytes=-99999999999999999999999999999", 1000, kRangeNone, 0, 0},
+
+    // Malformed
+    {"bytes=-", 1000, kRangeNone, 0, 0},
+    {"bytes=", 1000, kRangeNone, 0, 0},
+    {"bytes=abc-", 1000, kRangeNone, 0, 0},
+    {"bytes=10", 1000, kRangeNone, 0, 0},
+    {"bytes=10-20x", 1000, kRangeNone, 0, 0},
+    {"bytes = 0-10", 1000, kRangeNone, 0, 0},
+    {"items=0-10", 1000, kRangeNone, 0, 0},
+    {"", 1000, kRangeNone, 0, 0},
+};
+
+int main()
+{
+  for (const RangeCase &c : kCases) {
+    size_t first = 0, last = 0;
+    RangeResult r = parseByteRange(c.header, c.size, &first, &last);
+    if (r != c.result) {
+      printf("\"%s\" of %zu: got %d, wanted %d\n", c.header, c.size, r,
+             c.result);
+    }
+    CHECK_EQ(r, c.result);
+    if (c.result == kRangeSatisfiable) {
+      CHECK_EQ(first, c.first);
+      CHECK_EQ(last, c.last);
+      CHECK(last < c.size);
+    }
+  }
+
+  // No Range header at all
+  size_t first, last;
+  CHECK_EQ(parseByteRange(nullptr, 1000, &first, &last), kRangeNone);
+
+  return hostTestResult("test_http_range");
+}
@@ -0,0 +1,310 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Replays handling on the pad and launches through LaunchDetector the way
+// FlightController::flightControl() feeds it: the magnitude of the IMU's
+// acceleration, gravity included, every 10ms, and the altitude and rate from
+// the altitude filter.  The barometer is on the pad idle profile, ~9.5Hz
+// through the BMP280's x4 IIR filter.
+//
+// Each pad case is kTraces 60s traces of handling and nothing else, and
+// none of them should launch.  Rail loading is the exception.  Back to back
+// shoves that hold over 2g for 100ms or more look like a weak motor on
+// acceleration alone.  Its bound is what the votes manage today, so it
+// catches a regression rather than promising anything.
+//
+// The launches are motors from 3g to 15g, and 5g with the IMU dead so only
+// the baro velocity can call it.  The latency is from ignition to the
+// launch.  With the IMU, the first motion, where the recording is
+// back-filled from, has to be at or just after ignition.
+
+#include "Arduino.h"
+#include "FlightSim.h"
+#include "HostTest.h"
+#include <AltimeterCore.h>
+#include "LaunchDetector.hpp"
+
+#include <algorithm>
+
+#define kTraces 200
+#define kTraceMs 60000
+#define kTickMs 10
+#define kIgnitionMs 2000
+
+// As FlightController.cpp and Altimeter build them from Configuration.h
+static const LaunchConfig kLaunchConfig   = {12, 10, 10, 20.0, 8.0, 10, 13.0};
+static const TrackingGains kAltitudeGains = alphaBetaGains(0.5);
+
+// What's happening to the unit on one tick
+typedef struct {
+  double felt;      // m/s/s, the magnitude the IMU reads
+  double altitude;  // m
+} Handling;
+
+// The handling on the tick at |ms|, from one of the generators below
+typedef Handling (*HandlingFn)(long ms, FlightNoise &noise, void *state);
+
+typedef struct {
+  const char *name;
+  HandlingFn handle;
+  int maxLaunches;  // Of kTraces
+} PadCase;
+
+// The altitude filter and the barometer, as Altimeter runs them on the pad
+class PadBarometer
+{
+ public:
+  PadBarometer() : filter(kAltitudeGains)
+  {
+    baro.period = 0.1057;
+    baro.filter = 0.25;
+    baro.noise  = 0.05;
+  }
+
+  void update(const SimRocket &r, FlightNoise &noise)
+  {
+    double altitude;
+    if (!baro.sample(r, noise, &altitude)) {
+      return;
+    }
+    if (sampled) {
+      filter.step(toReal(altitude), toReal(r.time - lastTime));
+    } else {
+      filter.reset(toReal(altitude));
+      sampled = true;
+    }
+    lastTime = r.time;
+  }
+
+  real_t altitude() { return filter.getCurrentValue(); }
+  real_t rate() { return filter.getRate(); }
+
+ private:
+  SimBarometer baro;
+  AlphaBetaFilter<real_t> filter;
+  double lastTime = 0;
+  bool sampled    = false;
+};
+
+// A burst of handling at |level| that runs to |end|.  The next starts at
+// |next|.
+typedef struct {
+  long next, end;
+  double level;
+} Burst;
+
+static double resting(FlightNoise &noise)
+{
+  return kSimGravity + noise.gaussian(0.3);
+}
+
+// 1-3 samples of 1.5g to 6g: the unit knocked, or the rocket bumped
+static Handling knock(long ms, FlightNoise &noise, void *state)
+{
+  Burst &b = *(Burst *)state;
+  if (ms >= b.next) {
+    b.end   = ms + (long)noise.uniform(1, 4) * kTickMs;
+    b.level = noise.uniform(1.5, 6) * kSimGravity;
+    b.next  = ms + (long)noise.uniform(1000, 5000);
+  }
+  return {ms < b.end ? b.level : resting(noise), 0};
+}
+
+// 150-400ms of free fall and 2-5 samples of 3g to 10g landing: dropped on
+// a bench
+static Handling drop(long ms, FlightNoise &noise, void *state)
+{
+  Burst &b = *(Burst *)state;
+  if (ms >= b.next) {
+    b.end   = ms + (long)noise.uniform(150, 400);
+    b.level = noise.uniform(3, 10) * kSimGravity;
+    b.next  = b.end + (long)noise.uniform(2, 6) * kTickMs;
+  }
+  if (ms < b.end) {
+    return {fabs(noise.gaussian(0.3)), 0};
+  }
+  if (ms < b.next) {
+    return {b.level, 0};
+  }
+  b.next = ms + (long)noise.uniform(4000, 12000);
+  return {resting(noise), 0};
+}
+
+// Walked out to the pad: a 2Hz gait of +-0.3g with a 1.5g-2.5g footfall on
+// each step, bobbing 5cm and climbing a gentle slope
+static Handling carry(long ms, FlightNoise &noise, void *state)
+{
+  Burst &b = *(Burst *)state;
+  double t = ms / 1000.0;
+  if (ms >= b.next) {
+    b.next  = ms + (long)noise.uniform(450, 550);
+    b.level = noise.uniform(1.5, 2.5) * kSimGravity;
+    return {b.level, 0.05 * sin(4 * M_PI * t) + 0.05 * t};
+  }
+  double felt = kSimGravity * (1 + 0.3 * sin(4 * M_PI * t));
+  return {felt + noise.gaussian(0.3), 0.05 * sin(4 * M_PI * t) + 0.05 * t};
+}
+
+// The rocket slid onto the rail: a few seconds of shoves of 3-8 samples at
+// 1.2g to 2.5g, back to back or up to 300ms apart, every 10-20s
+static Handling loadRail(long ms, FlightNoise &noise, void *state)
+{
+  Burst *b = (Burst *)state;  // The loading, then the shove in it
+  if (ms >= b[0].next) {
+    b[0].end  = ms + (long)noise.uniform(2000, 5000);
+    b[0].next = ms + (long)noise.uniform(10000, 20000);
+  }
+  if (ms < b[0].end && ms >= b[1].next) {
+    b[1].end   = ms + (long)noise.uniform(3, 9) * kTickMs;
+    b[1].level = noise.uniform(1.2, 2.5) * kSimGravity;
+    b[1].next  = b[1].end + (long)noise.uniform(0, 30) * kTickMs;
+  }
+  return {ms < b[1].end ? b[1].level : resting(noise), 0};
+}
+
+// Gusts over the pad: the baro swinging up to 1.5m either way over 1-6s
+static Handling wind(long ms, FlightNoise &noise, void *state)
+{
+  Burst &b = *(Burst *)state;
+  if (ms >= b.next) {
+    b.end   = b.next;
+    b.next  = ms + (long)noise.uniform(1000, 6000);
+    b.level = noise.uniform(-1.5, 1.5);
+  }
+  double phase = (double)(ms - b.end) / (b.next - b.end);
+  return {resting(noise), b.level * sin(M_PI * phase)};
+}
+
+static int padLaunches(const PadCase &c, int seed)
+{
+  int launches = 0;
+  for (int trace = 0; trace < kTraces; trace++) {
+    FlightNoise noise(seed * 1000 + trace);
+    LaunchDetector detector(kLaunchConfig);
+    PadBarometer baro;
+    SimRocket rocket;
+    Burst state[2] = {};
+    for (long ms = 0; ms < kTraceMs; ms += kTickMs) {
+      Handling h      = c.handle(ms, noise, state);
+      rocket.time     = ms / 1000.0;
+      rocket.altitude = h.altitude;
+      baro.update(rocket, noise);
+      if (detector.update(ms, toReal(h.felt), baro.rate(), baro.altitude())) {
+        launches++;
+        break;
+      }
+    }
+  }
+  printf("%-14s %3d of %d traces launched\n", c.name, launches, kTraces);
+  return launches;
+}
+
+typedef struct {
+  long medianLatency, worstLatency;     // ms from ignition
+  long firstMotionMin, firstMotionMax;  // ms from ignition
+  int missed;
+} LaunchStats;
+
+// Motors of |g| felt, from kIgnitionMs on the pad.  With |imuDead| the IMU
+// reads 0.
+static LaunchStats launch(double g, bool imuDead)
+{
+  std::vector<long> latencies;
+  LaunchStats s = {0, 0, 1000000, -1000000, 0};
+  for (int flight = 0; flight < kTraces; flight++) {
+    FlightNoise noise(flight * 31 + (int)g);
+    LaunchDetector detector(kLaunchConfig);
+    PadBarometer baro;
+    SimRocket rocket;
+    SimImu imu;
+    rocket.thrust   = g * kSimGravity;
+    rocket.burnTime = 2;
+    rocket.ignition = (kIgnitionMs + noise.uniform(0, kTickMs)) / 1000.0;
+    imu.bias        = noise.uniform(-0.2, 0.2);
+
+    long launchTime = -1;
+    for (long ms = 0; ms < kIgnitionMs + 3000 && launchTime < 0;
+         ms += kTickMs) {
+      rocket.step(kTickMs / 1000.0);
+      baro.update(rocket, noise);
+      double felt = imuDead ? 0 : imu.read(rocket, noise) + kSimGravity;
+      if (detector.update(ms, toReal(felt), baro.rate(), baro.altitude())) {
+        launchTime = ms;
+      }
+    }
+    if (launchTime < 0) {
+      s.missed++;
+      continue;
+    }
+    long ignition = (long)(rocket.ignition * 1000);
+    latencies.push_back(launchTime - ignition);
+    long firstMotion = detector.getFirstMotionTime() - ignition;
+    s.firstMotionMin = min(s.firstMotionMin, firstMotion);
+    s.firstMotionMax = max(s.firstMotionMax, firstMotion);
+  }
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    s.medianLatency = latencies[latencies.size() / 2];
+    s.worstLatency  = latencies.back();
+  }
+  printf("%4.0fg%-9s launched %4ldms median, %4ldms worst, first motion "
+         "%+ld to %+ldms, %d missed\n",
+         g, imuDead ? ", no IMU" : "", s.medianLatency, s.worstLatency,
+         s.firstMotionMin, s.firstMotionMax, s.missed);
+  return s;
+}
+
+int main()
+{
+  static const PadCase kPadCases[] = {
+      {"knocks", knock, 0},       {"drops", drop, 0},
+      {"carrying", carry, 0},     {"rail loading", loadRail, 100},
+      {"wind", wind, 0},
+  };
+  int seed = 0;
+  for (const PadCase &c : kPadCases) {
+    CHECK(padLaunches(c, seed++) <= c.maxLaunches);
+  }
+
+  // Ten votes at 100Hz is 100ms, and even 3g clears 2g on every sample
+  static const double kMotors[] = {3, 5, 10, 15};
+  for (double g : kMotors) {
+    LaunchStats s = launch(g, false);
+    CHECK_EQ(s.missed, 0);
+    CHECK(s.medianLatency <= 100);
+    CHECK(s.worstLatency <= 110);
+    CHECK(s.firstMotionMin >= 0 && s.firstMotionMax <= 2 * kTickMs);
+  }
+
+  // The baro velocity has to see 8m/s on ten samples behind the pad idle
+  // lag.  Its first motion is where the rate passed 4m/s.
+  LaunchStats s = launch(5, true);
+  CHECK_EQ(s.missed, 0);
+  CHECK(s.medianLatency <= 900);
+  CHECK(s.worstLatency <= 1000);
+  CHECK(s.firstMotionMin >= 0 && s.firstMotionMax < s.medianLatency);
+  return hostTestResult("test_launch_detector");
+}
@@ -0,0 +1,191 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Replays the same simulated flights through the real_t pipeline (the baro
+// rate filter, BaroLockout, LaunchDetector and the descent check) in each
+// NUMERIC_POLICY.  The Makefile builds this once per policy.  The double
+// build writes the reference results.  The float and fixed builds check
+// theirs against it:
+//  - launch and descent are detected on the same tick
+//  - the apogee is within 2mm (float) or 1mm (fixed)
+//  - the worst altitude error in flight is within 0.11m of the double's
+// A descent may be a tick out where the double build only crossed the
+// threshold by less than the apogee tolerance.  That's a tie the other types
+// can't be expected to call the same way.
+//
+// usage: test_numeric <results> [<reference>]
+
+#include "Arduino.h"
+#include "FlightSim.h"
+#include "HostTest.h"
+#include <AltimeterCore.h>
+#include "LaunchDetector.hpp"
+#include "Sensor/BaroLockout.hpp"
+
+#define kFlights 400
+#define kMaxTicks 8000
+#define kTickMs 10
+#define kBaroMs 14
+#define kGravity 9.81
+
+#if NUMERIC_POLICY == kNumericDouble
+#define kTestName "test_numeric (double)"
+#define kApogeeTolerance 0
+#elif NUMERIC_POLICY == kNumericFloat
+#define kTestName "test_numeric (float)"
+#define kApogeeTolerance 0.002
+#else
+#define kTestName "test_numeric (fixed)"
+#define kApogeeTolerance 0.001
+#endif
+#define kMaxErrorTolerance 0.11
+
+// As FlightController.cpp builds them from Configuration.h
+static const LaunchConfig kLaunchConfig = {12, 10, 10, 20.0, 8.0, 10, 13.0};
+static const BaroLockoutConfig kBaroLockoutConfig = {200, 150,   15,  10,
+                                                     500, 10000, 5,   0.1,
+                                                     0.5};
+static const real_t kDescentThreshold = 15;
+static const TrackingGains kRateGains = alphaBetaGains(0.5);
+
+typedef struct {
+  long launchTime;
+  long descentTime;
+  double apogee;
+  double maxError;       // Of the estimated altitude in flight
+  double descentMargin;  // Closest to the threshold either side of descent
+} FlightResult;
+
+// A boost of 4g to 22g for 1.2s to 2.5s, from a second on the pad, with
+// drag, a lagging and noisy barometer and a biased accelerometer
+static FlightResult fly(int flight)
+{
+  FlightNoise noise(flight);
+  double netG = noise.uniform(4, 22);
+  double burn = noise.uniform(1.2, 2.5);
+  double bias = noise.uniform(-0.2, 0.2);
+
+  BaroLockout lockout(kBaroLockoutConfig);
+  LaunchDetector detector(kLaunchConfig);
+  AlphaBetaFilter<real_t> rate(kRateGains);
+
+  FlightResult r = {-1, -1, 0, 0, 0};
+  double height = 0, velocity = 0, lagged = 0, baroAltitude = 0;
+  real_t apogee  = 0;
+  bool flying    = false;
+  long nextBaro  = 0;
+  double lastGap = 0;
+
+  for (long i = 0; i < kMaxTicks && r.descentTime < 0; i++) {
+    long ms  = i * kTickMs;
+    double t = ms / 1000.0;
+
+    double a = 0;
+    if (t >= 1.0) {
+      a = t < 1.0 + burn ? netG * kGravity : -kGravity;
+    }
+    a -= 0.00012 * velocity * fabs(velocity);
+    velocity += a * kTickMs / 1000.0;
+    height += velocity * kTickMs / 1000.0;
+
+    bool newBaro = ms >= nextBaro;
+    if (newBaro) {
+      nextBaro = ms + kBaroMs;
+      lagged += (height - lagged) * 0.5;
+      baroAltitude = lagged + noise.gaussian(0.11);
+      rate.step(toReal(baroAltitude), secondsFromMillis(kBaroMs));
+    }
+    double felt = (t < 1.0 ? kGravity : a + kGravity) + noise.gaussian(0.3) +
+                  bias;
+
+    lockout.update(ms, toReal(felt - kGravity), toReal(baroAltitude),
+                   newBaro);
+    real_t altitude = lockout.altitude();
+    if (!flying && detector.update(ms, toReal(felt), rate.getRate(),
+                                   altitude)) {
+      flying       = true;
+      r.launchTime = detector.getLaunchTime();
+    }
+    if (flying) {
+      apogee     = altitude > apogee ? altitude : apogee;
+      double gap = toFloat(altitude - (apogee - kDescentThreshold));
+      if (gap < 0) {
+        r.descentTime   = ms;
+        r.descentMargin = min(lastGap, -gap);
+      }
+      lastGap = gap;
+      r.maxError = max(r.maxError, fabs(toFloat(altitude) - height));
+    }
+  }
+  r.apogee = toFloat(apogee);
+  return r;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2) {
+    printf("usage: %s <results> [<reference>]\n", argv[0]);
+    return 2;
+  }
+  FILE *out = fopen(argv[1], "w");
+  FILE *ref = argc > 2 ? fopen(argv[2], "r") : nullptr;
+  CHECK(out);
+  CHECK(argc < 3 || ref);
+  if (!out || (argc > 2 && !ref)) {
+    return hostTestResult(kTestName);
+  }
+
+  for (int flight = 0; flight < kFlights; flight++) {
+    FlightResult r = fly(flight);
+    fprintf(out, "%ld %ld %.6f %.6f %.6f\n", r.launchTime, r.descentTime,
+            r.apogee, r.maxError, r.descentMargin);
+    CHECK(r.launchTime > 0);
+    CHECK(r.descentTime > r.launchTime);
+
+    FlightResult d;
+    if (ref && fscanf(ref, "%ld %ld %lf %lf %lf", &d.launchTime,
+                      &d.descentTime, &d.apogee, &d.maxError,
+                      &d.descentMargin) == 5) {
+      CHECK_EQ(r.launchTime, d.launchTime);
+      if (d.descentMargin < kApogeeTolerance) {
+        CHECK(labs(r.descentTime - d.descentTime) <= kTickMs);
+      } else {
+        CHECK_EQ(r.descentTime, d.descentTime);
+      }
+      CHECK_NEAR(r.apogee, d.apogee, kApogeeTolerance);
+      CHECK_NEAR(r.maxError, d.maxError, kMaxErrorTolerance);
+    } else if (ref) {
+      CHECK(!"reference is short");
+      break;
+    }
+  }
+
+  fclose(out);
+  if (ref) {
+    fclose(ref);
+  }
+  return hostTestResult(kTestName);
+}
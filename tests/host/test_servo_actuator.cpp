@@ -0,0 +1,173 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Runs ServoActuator against the Servo stub, which records every write with
+// the micros() it went out at.  The config is the gimbal's: 20ms frames
+// written in the last 4ms, 300deg/s and a 1deg deadband.  The main loop
+// calls service() every millisecond unless a case stalls it.
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "Servo.h"
+#include "ServoActuator.hpp"
+
+#define kPin 5
+#define kAttachUs 1000000UL
+#define kLoopUs 1000
+
+static const ServoActuatorConfig kConfig = {20000, 4000, 300, 1};
+
+static void start(ServoActuator &servo, int angle)
+{
+  hostMicros = kAttachUs;
+  hostMillis = kAttachUs / 1000;
+  servo.attach(kPin, angle);
+  hostServoWrites().clear();
+}
+
+// Runs the loop until |until| micros after attach()
+static void runUntil(ServoActuator &servo, unsigned long until)
+{
+  while (micros() < kAttachUs + until) {
+    hostAdvanceMicros(kLoopUs);
+    servo.service();
+  }
+}
+
+// Where |w| lands in its frame, in micros
+static long frameOffset(const HostServoWrite &w)
+{
+  return (long)((w.micros - kAttachUs) % kConfig.frameUs);
+}
+
+// Tracking a 30deg 1Hz sine, at most one write goes out per frame and it's
+// in the lead window
+static void testOneWritePerFrame()
+{
+  ServoActuator servo(kConfig);
+  start(servo, 0);
+  while (micros() < kAttachUs + 1000000) {
+    float t = (micros() - kAttachUs) / 1000000.0f;
+    servo.command(30 * sinf(2 * M_PI * t));
+    hostAdvanceMicros(kLoopUs);
+    servo.service();
+  }
+
+  const std::vector<HostServoWrite> &w = hostServoWrites();
+  // 50 frames.  A few near the peaks move less than the deadband.
+  CHECK(w.size() >= 40 && w.size() <= 50);
+  long lastFrame = -1;
+  for (const HostServoWrite &write : w) {
+    long frame = (write.micros - kAttachUs) / kConfig.frameUs;
+    CHECK(frame != lastFrame);
+    CHECK(frameOffset(write) >= kConfig.frameUs - kConfig.leadUs);
+    CHECK_EQ(write.pin, kPin);
+    lastFrame = frame;
+  }
+  CHECK_EQ(servo.getWriteCount(), w.size() + 1);
+}
+
+// A 90deg step goes out 6deg a frame and settles in 15 frames
+static void testSlew()
+{
+  ServoActuator servo(kConfig);
+  start(servo, 0);
+  servo.command(90);
+  runUntil(servo, 400000);
+
+  const std::vector<HostServoWrite> &w = hostServoWrites();
+  CHECK(w.size() >= 15 && w.size() <= 16);
+  int last = 0;
+  for (const HostServoWrite &write : w) {
+    CHECK(write.angle > last && write.angle - last <= 6);
+    last = write.angle;
+  }
+  CHECK_EQ(servo.getAngle(), 90);
+  CHECK(!w.empty() && w.back().micros - kAttachUs <= 320000);
+
+  // set() goes straight out
+  servo.set(10);
+  CHECK_EQ(w.back().angle, 10);
+  CHECK_EQ(w.back().micros, micros());
+}
+
+// Moves under 1deg from the last write are dropped
+static void testDeadband()
+{
+  ServoActuator servo(kConfig);
+  start(servo, 0);
+  servo.command(0.6f);
+  runUntil(servo, 200000);
+  CHECK_EQ(hostServoWrites().size(), 0);
+  CHECK_EQ(servo.getAngle(), 0);
+
+  servo.command(1.6f);
+  runUntil(servo, 400000);
+  CHECK_EQ(hostServoWrites().size(), 1);
+  CHECK_EQ(servo.getAngle(), 2);
+
+  // Back within the deadband of the 2 written
+  servo.command(1.2f);
+  runUntil(servo, 600000);
+  CHECK_EQ(hostServoWrites().size(), 1);
+}
+
+// A loop that stalls through the lead window writes as soon as it's back,
+// and the next frame still gets its write in the window
+static void testMissedWindow()
+{
+  ServoActuator servo(kConfig);
+  start(servo, 0);
+  runUntil(servo, 15000);
+  servo.command(10);
+  hostAdvanceMicros(7000);  // Past the window and into frame 1
+  servo.service();
+
+  const std::vector<HostServoWrite> &w = hostServoWrites();
+  CHECK_EQ(w.size(), 1);
+  if (w.size() != 1) {
+    return;
+  }
+  CHECK_EQ(w[0].micros, kAttachUs + 22000);
+  CHECK_EQ(w[0].angle, 6);
+
+  runUntil(servo, 40000);
+  CHECK_EQ(w.size(), 2);
+  if (w.size() != 2) {
+    return;
+  }
+  CHECK_EQ(w[1].angle, 10);
+  CHECK_EQ(frameOffset(w[1]), kConfig.frameUs - kConfig.leadUs);
+}
+
+int main()
+{
+  testOneWritePerFrame();
+  testSlew();
+  testDeadband();
+  testMissedWindow();
+  return hostTestResult("test_servo_actuator");
+}
@@ -0,0 +1,212 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// Replays traces through SimpleAltimeter's flight state table.  Every
+// transition is taken, in order, stamped before its action runs, and only
+// the guards of the current state are asked.  The guards follow the
+// sketch's.  The sketch never puts the IMU in the control tick, so the
+// acceleration is always 0 here.
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "FlightReplay.h"
+#include <AltimeterCore.h>
+#include "FlightState.h"
+
+// As Configuration.h
+static const float kFlightStartAltitude = 30;
+static const float kFlightEndAltitude   = 30;
+static const float kFlightStartAcc      = 0.1;
+
+static const char *const kStateNames[] = {"Ready", "Ascending", "Descending",
+                                          "Landed"};
+
+struct Tick {
+  float altitude;
+  float acceleration;
+};
+
+struct Replay {
+  FlightState state = kReadyToFly;
+  Tick tick;
+  long ms      = 0;
+  float apogee = 0;
+
+  int samplesBelowApogee = 0;
+  int samplesAtMinHeight = 0;
+  int samplesAboveMinAcc = 0;
+
+  std::string journal;  // Stamps and actions in the order they happened
+  int stamps        = 0;
+  long entered[4]   = {-1, -1, -1, -1};  // By state, in trace ms
+  int guardCalls[3] = {0, 0, 0};
+};
+
+struct Handlers {
+  static bool isLaunched(Replay &r)
+  {
+    CHECK_EQ(r.state, kReadyToFly);
+    r.guardCalls[0]++;
+    if (r.tick.acceleration > kFlightStartAcc) {
+      r.samplesAboveMinAcc++;
+    } else {
+      r.samplesAboveMinAcc = 0;
+    }
+    return r.tick.altitude >= kFlightStartAltitude ||
+           r.samplesAboveMinAcc > 3;
+  }
+
+  static void onLaunch(Replay &r)
+  {
+    r.samplesBelowApogee = 0;
+    r.journal += "launch;";
+  }
+
+  static bool isPastApogee(Replay &r)
+  {
+    CHECK_EQ(r.state, kAscending);
+    r.guardCalls[1]++;
+    if (r.tick.altitude < r.apogee) {
+      r.samplesBelowApogee++;
+    } else {
+      r.samplesBelowApogee = 0;
+    }
+    return r.samplesBelowApogee > 5;
+  }
+
+  static void onApogee(Replay &r)
+  {
+    r.samplesAtMinHeight = 0;
+    r.journal += "apogee;";
+  }
+
+  static bool isLanded(Replay &r)
+  {
+    CHECK_EQ(r.state, kDescending);
+    r.guardCalls[2]++;
+    if (r.tick.altitude < kFlightEndAltitude) {
+      r.samplesAtMinHeight++;
+    } else {
+      r.samplesAtMinHeight = 0;
+    }
+    return r.samplesAtMinHeight > 3;
+  }
+
+  static void onLanding(Replay &r) { r.journal += "landing;"; }
+};
+
+typedef FlightPhases<FlightState, Replay, Handlers> Phases;
+static_assert(transitionsSorted(Phases::kFlightTransitions),
+              "Flight transitions must be sorted by the state they leave");
+
+static void stamp(Replay &r, FlightState from, FlightState to)
+{
+  r.journal += std::string(kStateNames[from]) + ">" + kStateNames[to] + ";";
+  r.stamps++;
+  r.entered[to] = r.ms;
+}
+
+static constexpr FlightStateMachine<FlightState, Replay> kMachine(
+    Phases::kFlightTransitions, stamp);
+
+// Steps the table once per tick, tracking the apogee first as
+// flightControl() does
+static void replay(Replay &r, const std::vector<TraceTick> &trace)
+{
+  for (const TraceTick &t : trace) {
+    r.ms     = t.ms;
+    r.tick   = {t.altitude, 0};
+    r.apogee = max(r.apogee, t.altitude);
+    int stamps = r.stamps;
+    bool moved = kMachine.step(r.state, r);
+    CHECK_EQ(r.stamps - stamps, moved ? 1 : 0);
+  }
+}
+
+static void testArming()
+{
+  Replay r;
+  r.state = kOnGround;
+  kMachine.enter(r.state, kReadyToFly, r);
+  CHECK_EQ(r.state, kReadyToFly);
+  CHECK(r.journal == "Landed>Ready;");
+  // Arming again isn't a transition
+  kMachine.enter(r.state, kReadyToFly, r);
+  CHECK_EQ(r.stamps, 1);
+}
+
+static void testFlight()
+{
+  std::vector<TraceTick> trace = loadTrace("flight_no_imu.csv");
+  CHECK(!trace.empty());
+  if (trace.empty()) {
+    return;
+  }
+  Replay r;
+  replay(r, trace);
+
+  const char *expected =
+      "Ready>Ascending;launch;"
+      "Ascending>Descending;apogee;"
+      "Descending>Landed;landing;";
+  if (r.journal != expected) {
+    printf("flight_no_imu.csv: %s\n", r.journal.c_str());
+  }
+  CHECK(r.journal == expected);
+  CHECK_EQ(r.state, kOnGround);
+
+  // Launch is on the altitude alone, once we're past 30m
+  for (const TraceTick &t : trace) {
+    if (t.ms == r.entered[kAscending]) {
+      CHECK(t.altitude >= kFlightStartAltitude);
+    }
+  }
+  // Descent is after the peak, landing is once we're below 30m
+  TraceTick peak = tracePeak(trace);
+  CHECK(r.entered[kDescending] > peak.ms);
+  CHECK(r.entered[kOnGround] > r.entered[kDescending]);
+  CHECK(r.guardCalls[0] > 0 && r.guardCalls[1] > 0 && r.guardCalls[2] > 0);
+}
+
+static void testPadKnock()
+{
+  std::vector<TraceTick> trace = loadTrace("pad_knock.csv");
+  CHECK(!trace.empty());
+  Replay r;
+  replay(r, trace);
+  CHECK_EQ(r.state, kReadyToFly);
+  CHECK_EQ(r.stamps, 0);
+  CHECK_EQ(r.guardCalls[0], trace.size());
+  CHECK_EQ(r.guardCalls[1] + r.guardCalls[2], 0);
+}
+
+int main()
+{
+  testArming();
+  testFlight();
+  testPadKnock();
+  return hostTestResult("test_simple_phases");
+}
@@ -0,0 +1,152 @@
+/*********************************************************************************
+ * Open Altimeter
+ *
+ * Mid power rocket avionics software for altitude recording and dual deployment
+ *
+ * Copyright 2018, Jonathan Nobels
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **********************************************************************************/
+
+// SimpleTimer against a virtual clock: periodic timers don't drift over long
+// runs with a jittery loop, missed periods are skipped and counted, high
+// priority timers go first and the clock can wrap.
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include <SimpleTimer.h>
+
+static unsigned long virtualClock = 0;
+static unsigned long readClock() { return virtualClock; }
+
+struct Recorder : public TimerDelegate {
+  unsigned long count = 0;
+  unsigned long last  = 0;
+  char order          = 0;
+  char **log          = nullptr;
+
+  void timerFired(int timerNumber)
+  {
+    count++;
+    last = virtualClock;
+    if (log) {
+      *(*log)++ = order;
+    }
+  }
+};
+
+// Steps the clock by 1-7ms, like a loop() that's busy with other work
+static void runFor(SimpleTimer &timer, unsigned long ms)
+{
+  unsigned long end = virtualClock + ms;
+  while ((long)(end - virtualClock) > 0) {
+    virtualClock += 1 + rand() % 7;
+    timer.run();
+  }
+}
+
+static void testNoDrift()
+{
+  virtualClock = 0;
+  SimpleTimer timer(readClock);
+  Recorder r;
+  int t = timer.setInterval(10, &r);
+
+  // 24 hours.  Run n is due at 10n, so it must fire at 10n plus no more than
+  // one loop step.  Anything rescheduled from when it actually ran would be
+  // hours behind by now.
+  runFor(timer, 24UL * 3600 * 1000);
+  unsigned long expected = virtualClock / 10;
+  CHECK(r.count >= expected - 1 && r.count <= expected);
+  CHECK(r.last >= r.count * 10 && r.last - r.count * 10 < 7);
+  CHECK(timer.getMaxLateness(t) < 7);
+  CHECK_EQ(timer.getMissedRuns(t), 0);
+}
+
+static void testStall()
+{
+  virtualClock = 1000;
+  SimpleTimer timer(readClock);
+  Recorder r;
+  int t = timer.setInterval(10, &r);
+
+  // A stall longer than an AVR unsigned int of milliseconds.  On the host an
+  // unsigned int wouldn't wrap, so check the type too.
+  static_assert(sizeof(timer.getMissedRuns(t)) == sizeof(unsigned long) &&
+                    sizeof(timer.getMaxLateness(t)) == sizeof(unsigned long),
+                "Timer statistics must hold a full millis() range");
+  virtualClock += 100000 + 10;
+  timer.run();
+  CHECK_EQ(r.count, 1);
+  CHECK_EQ(timer.getLateness(t), 100000);
+  CHECK_EQ(timer.getMaxLateness(t), 100000);
+  CHECK_EQ(timer.getMissedRuns(t), 10000);
+
+  // And back on the original schedule without firing the missed runs
+  virtualClock += 9;
+  timer.run();
+  CHECK_EQ(r.count, 1);
+  virtualClock += 1;
+  timer.run();
+  CHECK_EQ(r.count, 2);
+  CHECK_EQ(timer.getLateness(t), 0);
+}
+
+static void testPriority()
+{
+  virtualClock = 0;
+  SimpleTimer timer(readClock);
+  char log[8] = {0};
+  char *next   = log;
+  Recorder normal, high;
+  normal.order = 'n';
+  high.order   = 'h';
+  normal.log = high.log = &next;
+
+  // Set up in the wrong order, both due at once
+  timer.setTimeout(5, &normal);
+  timer.setTimeout(5, &high, SimpleTimer::PRIORITY_HIGH);
+  virtualClock = 20;
+  timer.run();
+  timer.run();
+  CHECK(log[0] == 'h' && log[1] == 'n');
+  CHECK_EQ(timer.getNumTimers(), 0);
+}
+
+static void testClockWrap()
+{
+  virtualClock = (unsigned long)-25;
+  SimpleTimer timer(readClock);
+  Recorder r;
+  int t = timer.setInterval(10, &r);
+  runFor(timer, 200);
+  unsigned long elapsed = virtualClock + 25;
+  CHECK(r.count >= elapsed / 10 - 1 && r.count <= elapsed / 10);
+  CHECK(timer.getMaxLateness(t) < 7);
+}
+
+int main()
+{
+  srand(31);
+  testNoDrift();
+  testStall();
+  testPriority();
+  testClockWrap();
+  return hostTestResult("test_simple_timer");
+}